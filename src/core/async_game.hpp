@@ -0,0 +1,280 @@
+#pragma once
+
+#include "game.hpp"
+
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace ttt::game {
+
+// Lazily started coroutine producing a value of type T. Awaiting a task
+// starts it and resumes the awaiting coroutine when the task finishes, so
+// nested awaits never grow the stack.
+template <class T> class Task {
+public:
+  struct promise_type;
+  using handle_t = std::coroutine_handle<promise_type>;
+
+  struct promise_type {
+    std::optional<T> value;
+    std::exception_ptr error;
+    std::coroutine_handle<> continuation;
+
+    Task get_return_object() { return Task(handle_t::from_promise(*this)); }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+      bool await_ready() noexcept { return false; }
+      std::coroutine_handle<> await_suspend(handle_t h) noexcept {
+        auto next = h.promise().continuation;
+        return next ? next : std::noop_coroutine();
+      }
+      void await_resume() noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void return_value(T v) { value = std::move(v); }
+    void unhandled_exception() { error = std::current_exception(); }
+  };
+
+  Task() = default;
+  Task(const Task &) = delete;
+  Task(Task &&other) : m_handle(std::exchange(other.m_handle, {})) {}
+  ~Task() {
+    if (m_handle)
+      m_handle.destroy();
+  }
+
+  Task &operator=(const Task &) = delete;
+  Task &operator=(Task &&other) {
+    if (this == &other)
+      return *this;
+    if (m_handle)
+      m_handle.destroy();
+    m_handle = std::exchange(other.m_handle, {});
+    return *this;
+  }
+
+  bool await_ready() const { return !m_handle || m_handle.done(); }
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) {
+    m_handle.promise().continuation = awaiting;
+    return m_handle;
+  }
+  T await_resume() { return get(); }
+
+  bool done() const { return !m_handle || m_handle.done(); }
+  std::coroutine_handle<> get_handle() const { return m_handle; }
+
+  T get() {
+    if (m_handle.promise().error)
+      std::rethrow_exception(m_handle.promise().error);
+    return std::move(*m_handle.promise().value);
+  }
+
+private:
+  explicit Task(handle_t h) : m_handle(h) {}
+
+  handle_t m_handle;
+};
+
+// Single-threaded run queue. Games and players suspend on it instead of
+// blocking the thread, so any number of games interleave on one thread.
+class Scheduler {
+  std::deque<std::coroutine_handle<>> m_ready;
+  std::vector<Task<MoveResult>> m_tasks;
+
+public:
+  struct YieldAwaiter {
+    Scheduler &scheduler;
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) { scheduler.post(h); }
+    void await_resume() const noexcept {}
+  };
+
+  // Enqueues a suspended coroutine to be resumed by `run`.
+  void post(std::coroutine_handle<> h) { m_ready.push_back(h); }
+
+  // Lets other ready coroutines run before continuing.
+  YieldAwaiter yield() { return YieldAwaiter{*this}; }
+
+  // Takes ownership of the task and schedules its first step.
+  void spawn(Task<MoveResult> &&task) {
+    m_tasks.push_back(std::move(task));
+    post(m_tasks.back().get_handle());
+  }
+
+  // Resumes ready coroutines until none is left. Coroutines waiting for an
+  // external `AsyncResult` stay suspended; call `run` again once they are set.
+  void run() {
+    while (!m_ready.empty()) {
+      auto h = m_ready.front();
+      m_ready.pop_front();
+      h.resume();
+    }
+  }
+
+  bool has_ready() const { return !m_ready.empty(); }
+
+  bool all_done() const {
+    for (auto &task : m_tasks)
+      if (!task.done())
+        return false;
+    return true;
+  }
+
+  std::vector<Task<MoveResult>> &get_tasks() { return m_tasks; }
+  void clear() { m_tasks.clear(); }
+};
+
+// One-shot value filled from outside the coroutine, e.g. by a network poller
+// or a batched evaluator. The awaiting coroutine is posted to the scheduler
+// when the value arrives.
+template <class T> class AsyncResult {
+  Scheduler &m_scheduler;
+  std::optional<T> m_value;
+  std::coroutine_handle<> m_waiter;
+
+public:
+  AsyncResult(Scheduler &scheduler) : m_scheduler(scheduler) {}
+  AsyncResult(const AsyncResult &) = delete;
+  AsyncResult &operator=(const AsyncResult &) = delete;
+
+  void set(T value) {
+    m_value = std::move(value);
+    if (m_waiter)
+      m_scheduler.post(std::exchange(m_waiter, {}));
+  }
+
+  bool is_set() const { return m_value.has_value(); }
+
+  bool await_ready() const { return m_value.has_value(); }
+  void await_suspend(std::coroutine_handle<> h) { m_waiter = h; }
+  T await_resume() { return std::move(*m_value); }
+};
+
+// Player whose move may suspend while other games progress.
+struct IAsyncPlayer : public IObserver {
+  virtual void set_sign(Sign sign) = 0;
+  virtual Task<Point> make_move(const State &) = 0;
+  virtual const char *get_name() const = 0;
+
+  virtual void on_game_start(const State::Opts &opts, Sign sign) {}
+  virtual void on_game_end(const State &state, MoveResult result) {}
+};
+
+// Runs a blocking player inside the coroutine driver. The move is computed
+// synchronously, so wrap only players that answer quickly.
+class BlockingPlayerAdapter : public IAsyncPlayer {
+  IPlayer &m_base;
+
+public:
+  BlockingPlayerAdapter(IPlayer &base) : m_base(base) {}
+
+  void set_sign(Sign sign) override { m_base.set_sign(sign); }
+  Task<Point> make_move(const State &state) override {
+    co_return m_base.make_move(state);
+  }
+  const char *get_name() const override { return m_base.get_name(); }
+  void on_game_start(const State::Opts &opts, Sign sign) override {
+    m_base.on_game_start(opts, sign);
+  }
+  void on_game_end(const State &state, MoveResult result) override {
+    m_base.on_game_end(state, result);
+  }
+  void handle_event(const State &state, const Event &event) override {
+    m_base.handle_event(state, event);
+  }
+};
+
+// Coroutine counterpart of `Game`: same rules, events and `MoveResult`
+// semantics, but waiting for a move suspends instead of blocking.
+class AsyncGame {
+  ComposedObserver m_observer;
+  IAsyncPlayer *m_x_player = nullptr;
+  IAsyncPlayer *m_o_player = nullptr;
+  State m_state;
+
+public:
+  AsyncGame(const State::Opts &opts) : m_state(opts) {}
+
+  const State &get_state() const { return m_state; }
+
+  void add_player(Sign sign, IAsyncPlayer *player) {
+    IAsyncPlayer *&pp = sign == Sign::X ? m_x_player : m_o_player;
+    if (pp == player)
+      return;
+    m_observer.remove_observer(pp);
+    m_observer.add_observer(player);
+    pp = player;
+  }
+  void add_observer(IObserver *obs) { m_observer.add_observer(obs); }
+  void remove_observer(IObserver *obs) { m_observer.remove_observer(obs); }
+
+  Task<MoveResult> process() {
+    if (m_state.get_status() == Status::ENDED) {
+      co_return MoveResult::ENDED;
+    }
+    if (m_state.get_status() == Status::CREATED) {
+      if (!m_x_player || !m_o_player) {
+        co_return MoveResult::ERROR;
+      }
+      m_x_player->on_game_start(m_state.get_opts(), Sign::X);
+      m_o_player->on_game_start(m_state.get_opts(), Sign::O);
+      m_x_player->set_sign(Sign::X);
+      m_o_player->set_sign(Sign::O);
+      m_observer.handle_event(m_state, Event::make_player_joined_event(
+                                           Sign::X, m_x_player->get_name()));
+      m_observer.handle_event(m_state, Event::make_player_joined_event(
+                                           Sign::O, m_o_player->get_name()));
+      m_observer.handle_event(m_state, Event::make_game_started_event());
+    }
+    const Sign sign = m_state.get_current_player();
+    IAsyncPlayer *p = sign == Sign::X ? m_x_player : m_o_player;
+    if (p == nullptr) {
+      co_return MoveResult::ERROR;
+    }
+    const Point pt = co_await p->make_move(m_state);
+    const MoveResult result = m_state.process_move(sign, pt.x, pt.y);
+    m_observer.handle_event(m_state, Event::make_move_event(pt.x, pt.y, sign));
+    switch (result) {
+    case MoveResult::WIN:
+      m_observer.handle_event(m_state,
+                              Event::make_win_event(m_state.get_winner()));
+      break;
+    case MoveResult::DRAW:
+      m_observer.handle_event(m_state, Event::make_draw_event());
+      break;
+    case MoveResult::DQ_OUT_OF_ORDER:
+    case MoveResult::DQ_PLACE_OCCUPIED:
+    case MoveResult::DQ_OUT_OF_FIELD:
+      m_observer.handle_event(m_state, Event::make_dq_event(sign, result));
+      break;
+    default:
+      co_return result;
+    }
+    m_x_player->on_game_end(m_state, result);
+    m_o_player->on_game_end(m_state, result);
+    co_return result;
+  }
+
+  // Plays the game to the end and returns the result of the last move. With
+  // a scheduler the game yields between moves, so games with blocking
+  // players interleave too.
+  Task<MoveResult> play(Scheduler *scheduler = nullptr) {
+    MoveResult result;
+    do {
+      result = co_await process();
+      if (scheduler && result == MoveResult::OK)
+        co_await scheduler->yield();
+    } while (result == MoveResult::OK);
+    co_return result;
+  }
+
+  void reset() { m_state.reset(); }
+};
+
+}; // namespace ttt::game
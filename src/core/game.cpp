@@ -48,6 +48,8 @@ MoveResult Game::process() {
     if (!m_x_player || !m_o_player) {
       return MoveResult::ERROR;
     }
+    m_x_player->on_game_start(m_state.get_opts(), Sign::X);
+    m_o_player->on_game_start(m_state.get_opts(), Sign::O);
     m_x_player->set_sign(Sign::X);
     m_o_player->set_sign(Sign::O);
     m_observer.handle_event(m_state, Event::make_player_joined_event(
@@ -78,8 +80,12 @@ MoveResult Game::process() {
     m_observer.handle_event(m_state, Event::make_dq_event(sign, result));
     break;
   default:
-    break;
+    return result;
   }
+  if (m_x_player)
+    m_x_player->on_game_end(m_state, result);
+  if (m_o_player)
+    m_o_player->on_game_end(m_state, result);
   return result;
 }
 
@@ -21,6 +21,12 @@ struct IPlayer : public IObserver {
   virtual void set_sign(Sign sign) = 0;
   virtual Point make_move(const State &) = 0;
   virtual const char *get_name() const = 0;
+
+  // Called once per game before `set_sign` and outside of the move clock, so
+  // players can allocate and warm up their tables for the board.
+  virtual void on_game_start(const State::Opts &opts, Sign sign) {}
+  // Called once after the last move of a game (win, draw or disqualification).
+  virtual void on_game_end(const State &state, MoveResult result) {}
 };
 
 class ComposedObserver : public IObserver {
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "event.hpp"
+#include "game.hpp"
+#include "state.hpp"
+
+#include <tuple>
+#include <type_traits>
+
+namespace ttt::game {
+
+// Game loop for player and observer types known at compile time. Follows the
+// same rules, event order and `MoveResult` semantics as `Game`, but calls
+// players and observers through qualified names, so no call is virtual and
+// the compiler is free to inline them. Players and observers are not owned.
+template <class PlayerX, class PlayerO, class... Observers> class StaticGame {
+  static_assert(!std::is_abstract_v<PlayerX> && !std::is_abstract_v<PlayerO>,
+                "StaticGame needs concrete player types");
+
+  PlayerX &m_x_player;
+  PlayerO &m_o_player;
+  std::tuple<Observers &...> m_observers;
+  State m_state;
+
+public:
+  StaticGame(const State::Opts &opts, PlayerX &x_player, PlayerO &o_player,
+             Observers &...observers)
+      : m_x_player(x_player), m_o_player(o_player), m_observers(observers...),
+        m_state(opts) {}
+
+  const State &get_state() const { return m_state; }
+
+  MoveResult process() {
+    if (m_state.get_status() == Status::ENDED) {
+      return MoveResult::ENDED;
+    }
+    if (m_state.get_status() == Status::CREATED) {
+      m_x_player.PlayerX::on_game_start(m_state.get_opts(), Sign::X);
+      m_o_player.PlayerO::on_game_start(m_state.get_opts(), Sign::O);
+      m_x_player.PlayerX::set_sign(Sign::X);
+      m_o_player.PlayerO::set_sign(Sign::O);
+      notify(Event::make_player_joined_event(
+          Sign::X, m_x_player.PlayerX::get_name()));
+      notify(Event::make_player_joined_event(
+          Sign::O, m_o_player.PlayerO::get_name()));
+      notify(Event::make_game_started_event());
+    }
+    const Sign sign = m_state.get_current_player();
+    const Point pt = sign == Sign::X ? m_x_player.PlayerX::make_move(m_state)
+                                     : m_o_player.PlayerO::make_move(m_state);
+    const MoveResult result = m_state.process_move(sign, pt.x, pt.y);
+    notify(Event::make_move_event(pt.x, pt.y, sign));
+    switch (result) {
+    case MoveResult::WIN:
+      notify(Event::make_win_event(m_state.get_winner()));
+      break;
+    case MoveResult::DRAW:
+      notify(Event::make_draw_event());
+      break;
+    case MoveResult::DQ_OUT_OF_ORDER:
+    case MoveResult::DQ_PLACE_OCCUPIED:
+    case MoveResult::DQ_OUT_OF_FIELD:
+      notify(Event::make_dq_event(sign, result));
+      break;
+    default:
+      return result;
+    }
+    m_x_player.PlayerX::on_game_end(m_state, result);
+    m_o_player.PlayerO::on_game_end(m_state, result);
+    return result;
+  }
+
+  void reset() { m_state.reset(); }
+
+private:
+  void notify(const Event &event) {
+    m_x_player.PlayerX::handle_event(m_state, event);
+    if (static_cast<void *>(&m_o_player) != static_cast<void *>(&m_x_player))
+      m_o_player.PlayerO::handle_event(m_state, event);
+    std::apply([&](auto &...obs) { (notify_observer(obs, event), ...); },
+               m_observers);
+  }
+
+  template <class Observer>
+  void notify_observer(Observer &obs, const Event &event) {
+    obs.Observer::handle_event(m_state, event);
+  }
+};
+
+template <class PlayerX, class PlayerO, class... Observers>
+StaticGame(const State::Opts &, PlayerX &, PlayerO &, Observers &...)
+    -> StaticGame<PlayerX, PlayerO, Observers...>;
+
+}; // namespace ttt::game
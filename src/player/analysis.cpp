@@ -0,0 +1,193 @@
+#include "analysis.hpp"
+
+#include <algorithm>
+
+namespace ttt::my_player {
+
+AnalysisPool::AnalysisPool(const AnalysisOpts &opts)
+    : m_opts(opts), m_engine(opts.search) {
+  const int n_workers =
+      m_opts.n_workers > 0
+          ? m_opts.n_workers
+          : int(std::max(1u, std::thread::hardware_concurrency()));
+  for (int i = 0; i < n_workers; ++i)
+    m_workers.emplace_back(&AnalysisPool::run_worker, this);
+}
+
+AnalysisPool::~AnalysisPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_work_ready.notify_all();
+  for (auto &worker : m_workers)
+    worker.join();
+}
+
+std::vector<AnalysisResult>
+AnalysisPool::analyze(const std::vector<State> &batch) {
+  std::lock_guard<std::mutex> batch_lock(m_batch_mutex);
+  const auto start = Clock::now();
+  std::vector<AnalysisResult> results(batch.size());
+  // positions searched in this batch by hash, and repeats of them
+  std::unordered_map<uint64_t, size_t> searched;
+  std::vector<std::pair<size_t, size_t>> repeats;
+  std::vector<Job> jobs;
+  long long cache_hits = 0;
+  for (size_t i = 0; i < batch.size(); ++i) {
+    const uint64_t key = Board(batch[i]).get_hash();
+    if (find_cached(key, results[i])) {
+      results[i].cached = true;
+      ++cache_hits;
+      add_latency(std::chrono::duration<double, std::milli>(Clock::now() -
+                                                            start)
+                      .count());
+    } else if (auto it = searched.find(key); it != searched.end()) {
+      repeats.emplace_back(i, it->second);
+    } else {
+      searched[key] = i;
+      jobs.push_back({&batch[i], &results[i], key, start});
+    }
+  }
+
+  if (!jobs.empty()) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobs.insert(m_jobs.end(), jobs.begin(), jobs.end());
+    m_pending += int(jobs.size());
+    m_work_ready.notify_all();
+    m_work_done.wait(lock, [this] { return m_pending == 0; });
+  }
+  for (auto [i, first] : repeats) {
+    results[i] = results[first];
+    results[i].cached = true;
+    ++cache_hits;
+    add_latency(
+        std::chrono::duration<double, std::milli>(Clock::now() - start)
+            .count());
+  }
+
+  std::lock_guard<std::mutex> lock(m_stats_mutex);
+  m_stats.positions += batch.size();
+  ++m_stats.batches;
+  m_stats.cache_hits += cache_hits;
+  m_stats.busy_ms +=
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  return results;
+}
+
+AnalysisResult AnalysisPool::analyze(const State &state) {
+  return analyze(std::vector<State>{state})[0];
+}
+
+void AnalysisPool::run_worker() {
+  // the table of the context stays from position to position
+  SearchContext ctx;
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_work_ready.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+      if (m_stop)
+        return;
+      job = m_jobs.front();
+      m_jobs.pop_front();
+    }
+    *job.result = search(ctx, *job.state);
+    add_cached(job.key, *job.result);
+    add_latency(
+        std::chrono::duration<double, std::milli>(Clock::now() - job.start)
+            .count());
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (--m_pending == 0)
+      m_work_done.notify_all();
+  }
+}
+
+AnalysisResult AnalysisPool::search(SearchContext &ctx, const State &state) {
+  AnalysisResult result;
+  const State::Opts &opts = state.get_opts();
+  const int max_moves =
+      opts.max_moves > 0 ? opts.max_moves : opts.rows * opts.cols;
+  if (state.get_status() == game::Status::ENDED ||
+      state.get_move_no() >= max_moves) {
+    result.ended = true;
+    return result;
+  }
+  if (m_opts.multi_pv > 1) {
+    result.lines = m_engine.get_top_lines(ctx, state, m_opts.multi_pv);
+    for (auto &line : result.lines)
+      if (int(line.pv.size()) > m_opts.max_pv)
+        line.pv.resize(m_opts.max_pv);
+  } else {
+    m_engine.make_move(ctx, state);
+  }
+  const SearchInfo &info = ctx.last_info;
+  result.best = info.best;
+  result.score = info.score;
+  result.depth = info.depth;
+  result.nodes = info.nodes;
+  result.time_ms = info.time_ms;
+  result.pv = result.lines.empty()
+                  ? get_table_pv(ctx.tt, state, result.best, m_opts.max_pv)
+                  : result.lines[0].pv;
+  return result;
+}
+
+bool AnalysisPool::find_cached(uint64_t key, AnalysisResult &result) {
+  std::lock_guard<std::mutex> lock(m_cache_mutex);
+  auto it = m_cache.find(key);
+  if (it == m_cache.end())
+    return false;
+  result = it->second;
+  return true;
+}
+
+void AnalysisPool::add_cached(uint64_t key, const AnalysisResult &result) {
+  if (m_opts.cache_entries <= 0)
+    return;
+  std::lock_guard<std::mutex> lock(m_cache_mutex);
+  if (!m_cache.emplace(key, result).second)
+    return;
+  m_cache_order.push_back(key);
+  while (int(m_cache.size()) > m_opts.cache_entries) {
+    m_cache.erase(m_cache_order.front());
+    m_cache_order.pop_front();
+  }
+}
+
+void AnalysisPool::clear_cache() {
+  std::lock_guard<std::mutex> lock(m_cache_mutex);
+  m_cache.clear();
+  m_cache_order.clear();
+}
+
+void AnalysisPool::add_latency(double ms) {
+  if (m_opts.latency_samples <= 0)
+    return;
+  std::lock_guard<std::mutex> lock(m_stats_mutex);
+  if (int(m_latencies.size()) < m_opts.latency_samples) {
+    m_latencies.push_back(ms);
+  } else {
+    m_latencies[m_next_latency] = ms;
+    m_next_latency = (m_next_latency + 1) % m_latencies.size();
+  }
+}
+
+AnalysisStats AnalysisPool::get_stats() const {
+  std::lock_guard<std::mutex> lock(m_stats_mutex);
+  AnalysisStats stats = m_stats;
+  std::vector<double> sorted = m_latencies;
+  std::sort(sorted.begin(), sorted.end());
+  if (!sorted.empty()) {
+    auto percentile = [&](double p) {
+      return sorted[std::min(sorted.size() - 1, size_t(p * sorted.size()))];
+    };
+    stats.p50_ms = percentile(0.5);
+    stats.p90_ms = percentile(0.9);
+    stats.p99_ms = percentile(0.99);
+    stats.max_ms = sorted.back();
+  }
+  return stats;
+}
+
+}; // namespace ttt::my_player
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "search.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ttt::my_player {
+
+struct AnalysisOpts {
+  // every position gets a search with these options; the search threads of
+  // one position come on top of the workers
+  SearchOpts search;
+  // positions analysed at once; 0 uses all hardware threads
+  int n_workers = 0;
+  // results kept by position hash; the oldest ones go first
+  int cache_entries = 1 << 16;
+  // moves of the principal variation at most
+  int max_pv = 16;
+  // best moves ranked per position; more than one searches them together
+  // (see `SearchEngine::get_top_lines`)
+  int multi_pv = 1;
+  // latencies kept for the percentiles
+  int latency_samples = 10000;
+};
+
+struct AnalysisResult {
+  // the position is over or has no empty cell: no move
+  bool ended = false;
+  Point best = {-1, -1};
+  // from the side to move (see `WIN_SCORE`)
+  int score = 0;
+  int depth = 0;
+  // the best move and the expected replies, from the transposition table
+  std::vector<Point> pv;
+  // with `AnalysisOpts::multi_pv` above one: the best moves, best first;
+  // the first one is also `best`
+  std::vector<RankedLine> lines;
+  long long nodes = 0;
+  double time_ms = 0;
+  // answered from the result cache
+  bool cached = false;
+};
+
+struct AnalysisStats {
+  long long positions = 0;
+  long long batches = 0;
+  long long cache_hits = 0;
+  // wall time of the batches
+  double busy_ms = 0;
+  // latency of single positions, from the arrival of their batch to their
+  // result, over the last `AnalysisOpts::latency_samples`
+  double p50_ms = 0, p90_ms = 0, p99_ms = 0, max_ms = 0;
+
+  double get_pps() const {
+    return busy_ms > 0 ? positions / busy_ms * 1000 : 0;
+  }
+  double get_cache_hit_rate() const {
+    return positions > 0 ? double(cache_hits) / positions : 0;
+  }
+};
+
+// Analysis of batches of positions by a pool of workers, each with its own
+// search context over one shared `SearchEngine`. A batch is split into
+// positions; repeated positions and positions analysed before (by hash,
+// which covers the board options) are answered from the cache without a
+// search. Results come back in the order of the batch. Batches from several
+// threads are served one after the other.
+class AnalysisPool {
+public:
+  AnalysisPool(const AnalysisOpts &opts = AnalysisOpts());
+  ~AnalysisPool();
+  AnalysisPool(const AnalysisPool &) = delete;
+  AnalysisPool &operator=(const AnalysisPool &) = delete;
+
+  const AnalysisOpts &get_opts() const { return m_opts; }
+  int get_n_workers() const { return int(m_workers.size()); }
+
+  std::vector<AnalysisResult> analyze(const std::vector<State> &batch);
+  AnalysisResult analyze(const State &state);
+
+  AnalysisStats get_stats() const;
+  void clear_cache();
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Job {
+    const State *state;
+    AnalysisResult *result;
+    uint64_t key;
+    // arrival of the batch
+    Clock::time_point start;
+  };
+
+  void run_worker();
+  AnalysisResult search(SearchContext &ctx, const State &state);
+  bool find_cached(uint64_t key, AnalysisResult &result);
+  void add_cached(uint64_t key, const AnalysisResult &result);
+  void add_latency(double ms);
+
+  AnalysisOpts m_opts;
+  SearchEngine m_engine;
+  std::vector<std::thread> m_workers;
+
+  // one batch at a time
+  std::mutex m_batch_mutex;
+  std::mutex m_mutex;
+  std::condition_variable m_work_ready, m_work_done;
+  std::deque<Job> m_jobs;
+  int m_pending = 0;
+  bool m_stop = false;
+
+  mutable std::mutex m_cache_mutex;
+  std::unordered_map<uint64_t, AnalysisResult> m_cache;
+  std::deque<uint64_t> m_cache_order;
+
+  mutable std::mutex m_stats_mutex;
+  AnalysisStats m_stats;
+  std::vector<double> m_latencies;
+  size_t m_next_latency = 0;
+};
+
+}; // namespace ttt::my_player
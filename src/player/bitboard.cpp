@@ -0,0 +1,119 @@
+#include "bitboard.hpp"
+
+#include <bit>
+
+namespace ttt::my_player {
+
+Bitboard::Bitboard(const State::Opts &opts) : m_opts(opts) {
+  if (m_opts.max_moves == 0)
+    m_opts.max_moves = m_opts.rows * m_opts.cols;
+  const int n_words = (get_n_cells() + 63) / 64;
+  m_bits[0].assign(n_words, 0);
+  m_bits[1].assign(n_words, 0);
+  m_in_frontier.assign(get_n_cells(), 0);
+  m_frontier.reserve(get_n_cells());
+  if (m_opts.rows <= 64 && m_opts.cols <= 64) {
+    const int n_diagonals = m_opts.rows + m_opts.cols - 1;
+    const int sizes[N_DIRECTIONS] = {m_opts.rows, m_opts.cols, n_diagonals,
+                                     n_diagonals};
+    for (int dir = 0; dir < N_DIRECTIONS; ++dir)
+      m_line_offsets[dir + 1] = m_line_offsets[dir] + sizes[dir];
+    m_lines.assign(2 * m_line_offsets[N_DIRECTIONS], 0);
+  }
+}
+
+Bitboard::Bitboard(const State &state) : Bitboard(state.get_opts()) {
+  for (int y = 0; y < m_opts.rows; ++y)
+    for (int x = 0; x < m_opts.cols; ++x) {
+      const Sign s = state.get_value(x, y);
+      if (s != Sign::NONE)
+        place(index(x, y), s);
+    }
+  m_move_no = state.get_move_no();
+}
+
+int Bitboard::line_word(int x, int y, int dir) const {
+  switch (dir) {
+  case 0:
+    return y;
+  case 1:
+    return m_line_offsets[1] + x;
+  case 2:
+    return m_line_offsets[2] + x - y + m_opts.rows - 1;
+  default:
+    return m_line_offsets[3] + x + y;
+  }
+}
+
+void Bitboard::place(int idx, Sign sign) {
+  m_bits[sign_index(sign)][idx >> 6] |= uint64_t(1) << (idx & 63);
+  ++m_move_no;
+  const int cx = idx % m_opts.cols, cy = idx / m_opts.cols;
+  if (!m_lines.empty()) {
+    uint64_t *lines =
+        m_lines.data() + sign_index(sign) * m_line_offsets[N_DIRECTIONS];
+    for (int dir = 0; dir < N_DIRECTIONS; ++dir)
+      lines[line_word(cx, cy, dir)] |= uint64_t(1) << line_bit(cx, cy, dir);
+  }
+  for (int y = cy - 1; y <= cy + 1; ++y) {
+    if (y < 0 || y >= m_opts.rows)
+      continue;
+    for (int x = cx - 1; x <= cx + 1; ++x) {
+      if (x < 0 || x >= m_opts.cols)
+        continue;
+      const int n = index(x, y);
+      if (!m_in_frontier[n] && is_empty(n)) {
+        m_in_frontier[n] = 1;
+        m_frontier.push_back(n);
+      }
+    }
+  }
+}
+
+bool Bitboard::makes_line(int idx, Sign sign) const {
+  if (m_lines.empty())
+    return walk_line(idx, sign);
+  const int cx = idx % m_opts.cols, cy = idx / m_opts.cols;
+  const uint64_t *lines =
+      m_lines.data() + sign_index(sign) * m_line_offsets[N_DIRECTIONS];
+  for (int dir = 0; dir < N_DIRECTIONS; ++dir) {
+    const int bit = line_bit(cx, cy, dir);
+    const uint64_t line = lines[line_word(cx, cy, dir)] | uint64_t(1) << bit;
+    // both runs count the cell itself
+    const int count = std::countr_one(line >> bit) +
+                      std::countl_one(line << (63 - bit)) - 1;
+    if (count >= m_opts.win_len)
+      return true;
+  }
+  return false;
+}
+
+bool Bitboard::walk_line(int idx, Sign sign) const {
+  static const int directions[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+  const int cx = idx % m_opts.cols, cy = idx / m_opts.cols;
+  for (auto &dir : directions) {
+    int count = 1;
+    for (int side = -1; side <= 1; side += 2) {
+      int x = cx + side * dir[0], y = cy + side * dir[1];
+      while (x >= 0 && x < m_opts.cols && y >= 0 && y < m_opts.rows &&
+             test(index(x, y), sign)) {
+        ++count;
+        x += side * dir[0];
+        y += side * dir[1];
+      }
+    }
+    if (count >= m_opts.win_len)
+      return true;
+  }
+  return false;
+}
+
+bool Bitboard::has_line_cell(Sign sign) const {
+  // a line cell is always next to a stone of the line
+  for (int idx : m_frontier)
+    if (is_empty(idx) && makes_line(idx, sign))
+      return true;
+  return false;
+}
+
+}; // namespace ttt::my_player
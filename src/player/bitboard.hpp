@@ -0,0 +1,86 @@
+#pragma once
+
+#include "board.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace ttt::my_player {
+
+// Compact board for playouts: one bit per cell and sign, the move count and a
+// frontier of empty cells next to stones. Copying it is cheap, so every
+// playout starts from a copy of the position. Cells are addressed by index
+// `x + y * cols`, like in `Board`. The marks are also kept as one word per
+// row, column and diagonal, so that the run of marks through a cell in each
+// direction is found by counting the ones around its bit; boards with more
+// than 64 rows or columns walk the cells instead.
+class Bitboard {
+public:
+  Bitboard() = default;
+  Bitboard(const State::Opts &opts);
+  explicit Bitboard(const State &state);
+
+  const State::Opts &get_opts() const { return m_opts; }
+  int get_cols() const { return m_opts.cols; }
+  int get_rows() const { return m_opts.rows; }
+  int get_n_cells() const { return m_opts.rows * m_opts.cols; }
+  int index(int x, int y) const { return x + y * m_opts.cols; }
+  Point point(int idx) const { return Point{idx % m_opts.cols, idx / m_opts.cols}; }
+
+  bool test(int idx, Sign sign) const {
+    return (m_bits[sign_index(sign)][idx >> 6] >> (idx & 63)) & 1;
+  }
+  Sign get(int idx) const {
+    return test(idx, Sign::X) ? Sign::X : test(idx, Sign::O) ? Sign::O
+                                                             : Sign::NONE;
+  }
+  bool is_empty(int idx) const {
+    return !(((m_bits[0][idx >> 6] | m_bits[1][idx >> 6]) >> (idx & 63)) & 1);
+  }
+  const std::vector<uint64_t> &get_bits(Sign sign) const {
+    return m_bits[sign_index(sign)];
+  }
+
+  int get_move_no() const { return m_move_no; }
+  Sign get_current_player() const {
+    return m_move_no % 2 == 0 ? Sign::X : Sign::O;
+  }
+  bool is_full() const { return m_move_no >= m_opts.max_moves; }
+
+  void place(int idx, Sign sign);
+  // True if a mark of `sign` at the cell (placed or not) is part of a line.
+  bool makes_line(int idx, Sign sign) const;
+  // True if `sign` has an empty cell which completes a line.
+  bool has_line_cell(Sign sign) const;
+
+  // Empty cells next to a stone; occupied cells are only dropped lazily by
+  // `take_frontier`. Empty when there are no stones.
+  const std::vector<int> &get_frontier() const { return m_frontier; }
+  // Removes the frontier entry at `pos` (swapping the last one in).
+  void take_frontier(int pos) {
+    m_frontier[pos] = m_frontier.back();
+    m_frontier.pop_back();
+  }
+
+private:
+  static const int N_DIRECTIONS = 4;
+
+  // Word of the line through the cell in direction `dir` (rows, columns,
+  // diagonals, anti-diagonals) and the bit of the cell in it.
+  int line_word(int x, int y, int dir) const;
+  int line_bit(int x, int y, int dir) const { return dir == 0 ? x : y; }
+  bool walk_line(int idx, Sign sign) const;
+
+  State::Opts m_opts = {};
+  std::vector<uint64_t> m_bits[2];
+  // line words of X, then those of O; empty on boards too large for them
+  std::vector<uint64_t> m_lines;
+  // first word of every direction and the number of words of one sign
+  std::array<int, N_DIRECTIONS + 1> m_line_offsets = {};
+  int m_move_no = 0;
+  std::vector<int> m_frontier;
+  std::vector<uint8_t> m_in_frontier;
+};
+
+}; // namespace ttt::my_player
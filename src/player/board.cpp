@@ -0,0 +1,242 @@
+#include "board.hpp"
+
+#include <algorithm>
+
+namespace ttt::my_player {
+
+static uint64_t splitmix64(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+// Window weights by the number of missing marks; windows missing more than
+// the table covers score the last value.
+static const int MISSING_WEIGHTS[] = {0, 6000, 700, 80, 9, 1};
+static const int N_MISSING_WEIGHTS =
+    sizeof(MISSING_WEIGHTS) / sizeof(MISSING_WEIGHTS[0]);
+
+Board::Board(const State::Opts &opts) : m_opts(opts) {
+  if (m_opts.max_moves == 0)
+    m_opts.max_moves = m_opts.rows * m_opts.cols;
+  m_cells.assign(get_n_cells(), Sign::NONE);
+  m_near.assign(get_n_cells(), 0);
+  m_moves.reserve(get_n_cells());
+  m_base_hash = m_hash = base_hash(m_opts);
+  build_windows();
+}
+
+Board::Board(const State &state) : Board(state.get_opts()) {
+  for (int y = 0; y < m_opts.rows; ++y)
+    for (int x = 0; x < m_opts.cols; ++x) {
+      const Sign s = state.get_value(x, y);
+      if (s != Sign::NONE)
+        set_cell(index(x, y), s);
+    }
+  m_move_no = state.get_move_no();
+}
+
+void Board::build_windows() {
+  static const int directions[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+  const int len = m_opts.win_len;
+  m_windows_per_cell = 4 * len;
+  m_cell_windows.assign(get_n_cells() * m_windows_per_cell, -1);
+  std::vector<int> n_used(get_n_cells(), 0);
+  m_window_counts.clear();
+  m_window_start.clear();
+  m_window_step.clear();
+  for (auto &dir : directions) {
+    for (int y = 0; y < m_opts.rows; ++y) {
+      for (int x = 0; x < m_opts.cols; ++x) {
+        const int ex = x + dir[0] * (len - 1), ey = y + dir[1] * (len - 1);
+        if (!is_valid(ex, ey))
+          continue;
+        const int w = m_window_counts.size();
+        m_window_counts.push_back({0, 0});
+        m_window_start.push_back(index(x, y));
+        m_window_step.push_back(dir[0] + dir[1] * m_opts.cols);
+        for (int i = 0; i < len; ++i) {
+          const int idx = index(x + dir[0] * i, y + dir[1] * i);
+          m_cell_windows[idx * m_windows_per_cell + n_used[idx]++] = w;
+        }
+      }
+    }
+  }
+  for (auto &open : m_n_open) {
+    open.assign(len + 1, 0);
+    open[0] = m_window_counts.size();
+  }
+}
+
+uint64_t Board::base_hash(const State::Opts &opts) {
+  return splitmix64((uint64_t(opts.rows) << 40) ^ (uint64_t(opts.cols) << 20) ^
+                    uint64_t(opts.win_len));
+}
+
+uint64_t Board::cell_key(int idx, Sign sign) const {
+  return splitmix64(m_base_hash + uint64_t(idx) * 2 + sign_index(sign));
+}
+
+int Board::window_weight(int count) const {
+  if (count == 0)
+    return 0;
+  const int missing = m_opts.win_len - count;
+  return MISSING_WEIGHTS[std::min(missing, N_MISSING_WEIGHTS - 1)];
+}
+
+void Board::update_windows(int idx, int si, int delta) {
+  const int oi = 1 - si;
+  const int *w = &m_cell_windows[idx * m_windows_per_cell];
+  for (int i = 0; i < m_windows_per_cell && w[i] >= 0; ++i) {
+    auto &cnt = m_window_counts[w[i]];
+    const int own = cnt[si], opp = cnt[oi];
+    const int new_own = own + delta;
+    // contributions before and after the change
+    if (opp == 0) {
+      --m_n_open[si][own];
+      ++m_n_open[si][new_own];
+      m_window_score[si] += window_weight(new_own) - window_weight(own);
+      m_n_threats[si] += (new_own == m_opts.win_len - 1) -
+                         (own == m_opts.win_len - 1);
+    }
+    if (own == 0 && new_own > 0) {
+      m_window_score[oi] -= window_weight(opp);
+      m_n_threats[oi] -= opp == m_opts.win_len - 1;
+      --m_n_open[oi][opp];
+    } else if (own > 0 && new_own == 0) {
+      m_window_score[oi] += window_weight(opp);
+      m_n_threats[oi] += opp == m_opts.win_len - 1;
+      ++m_n_open[oi][opp];
+    }
+    cnt[si] = new_own;
+  }
+}
+
+bool Board::enable_patterns() {
+  if (!PatternEvaluator::supports(m_opts))
+    return false;
+  if (!m_patterns) {
+    m_patterns.emplace(m_opts);
+    for (int idx = 0; idx < get_n_cells(); ++idx)
+      if (m_cells[idx] != Sign::NONE)
+        m_patterns->set(idx, m_cells[idx]);
+  }
+  return true;
+}
+
+bool Board::enable_nnue(const NnueNetwork &network) {
+  if (!network.supports(m_opts))
+    return false;
+  if (!m_nnue) {
+    m_nnue.emplace(network);
+    for (int idx = 0; idx < get_n_cells(); ++idx)
+      if (m_cells[idx] != Sign::NONE)
+        m_nnue->set(idx, m_cells[idx]);
+  }
+  return true;
+}
+
+void Board::set_cell(int idx, Sign sign) {
+  m_cells[idx] = sign;
+  if (m_patterns)
+    m_patterns->set(idx, sign);
+  if (m_nnue)
+    m_nnue->set(idx, sign);
+  m_hash ^= cell_key(idx, sign);
+  update_windows(idx, sign_index(sign), 1);
+  const Point pt = point(idx);
+  for (int dy = -NEAR_RADIUS; dy <= NEAR_RADIUS; ++dy)
+    for (int dx = -NEAR_RADIUS; dx <= NEAR_RADIUS; ++dx)
+      if (is_valid(pt.x + dx, pt.y + dy))
+        ++m_near[index(pt.x + dx, pt.y + dy)];
+}
+
+void Board::clear_cell(int idx) {
+  const Sign sign = m_cells[idx];
+  m_cells[idx] = Sign::NONE;
+  if (m_patterns)
+    m_patterns->set(idx, Sign::NONE);
+  if (m_nnue)
+    m_nnue->set(idx, Sign::NONE);
+  m_hash ^= cell_key(idx, sign);
+  update_windows(idx, sign_index(sign), -1);
+  const Point pt = point(idx);
+  for (int dy = -NEAR_RADIUS; dy <= NEAR_RADIUS; ++dy)
+    for (int dx = -NEAR_RADIUS; dx <= NEAR_RADIUS; ++dx)
+      if (is_valid(pt.x + dx, pt.y + dy))
+        --m_near[index(pt.x + dx, pt.y + dy)];
+}
+
+void Board::place(int idx) { place(idx, get_current_player()); }
+
+void Board::place(int idx, Sign sign) {
+  set_cell(idx, sign);
+  m_moves.push_back(idx);
+  ++m_move_no;
+}
+
+void Board::undo() {
+  clear_cell(m_moves.back());
+  m_moves.pop_back();
+  --m_move_no;
+}
+
+int Board::get_drawing_reply(int from) const {
+  for (int idx = from; idx < get_n_cells(); ++idx)
+    if (is_empty(idx) && completes_line(idx, Sign::O))
+      return idx;
+  return -1;
+}
+
+int Board::get_last_move_reply() const {
+  const int reply = get_drawing_reply();
+  if (reply >= 0)
+    return reply;
+  for (int idx = 0; idx < get_n_cells(); ++idx)
+    if (is_empty(idx))
+      return idx;
+  return -1;
+}
+
+bool Board::has_window(int idx, Sign sign, int count) const {
+  const int si = sign_index(sign), oi = 1 - si;
+  const int *w = &m_cell_windows[idx * m_windows_per_cell];
+  for (int i = 0; i < m_windows_per_cell && w[i] >= 0; ++i) {
+    auto &cnt = m_window_counts[w[i]];
+    if (cnt[si] == count && cnt[oi] == 0)
+      return true;
+  }
+  return false;
+}
+
+void Board::collect_window_cells(int idx, Sign sign, int count,
+                                 std::vector<int> &cells) const {
+  const int si = sign_index(sign), oi = 1 - si;
+  const int *w = &m_cell_windows[idx * m_windows_per_cell];
+  for (int i = 0; i < m_windows_per_cell && w[i] >= 0; ++i) {
+    auto &cnt = m_window_counts[w[i]];
+    if (cnt[si] != count || cnt[oi] != 0)
+      continue;
+    for (int j = 0, c = m_window_start[w[i]]; j < m_opts.win_len;
+         ++j, c += m_window_step[w[i]])
+      if (m_cells[c] == Sign::NONE)
+        cells.push_back(c);
+  }
+}
+
+int Board::get_move_gain(int idx, Sign sign) const {
+  const int si = sign_index(sign), oi = 1 - si;
+  const int *w = &m_cell_windows[idx * m_windows_per_cell];
+  int gain = 0;
+  for (int i = 0; i < m_windows_per_cell && w[i] >= 0; ++i) {
+    auto &cnt = m_window_counts[w[i]];
+    if (cnt[oi] == 0)
+      gain += window_weight(cnt[si] + 1) - window_weight(cnt[si]);
+    if (cnt[si] == 0)
+      gain += window_weight(cnt[oi]);
+  }
+  return gain;
+}
+
+}; // namespace ttt::my_player
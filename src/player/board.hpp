@@ -0,0 +1,160 @@
+#pragma once
+
+#include "core/game.hpp"
+#include "nnue.hpp"
+#include "patterns.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace ttt::my_player {
+
+using game::Point;
+using game::Sign;
+using game::State;
+
+inline int sign_index(Sign s) { return s == Sign::X ? 0 : 1; }
+inline Sign opp_sign(Sign s) { return s == Sign::X ? Sign::O : Sign::X; }
+
+// Mutable board for search engines. Unlike `State` it supports undo and keeps
+// incrementally updated data the engines need on every node:
+//  - a Zobrist hash of the position;
+//  - stone counts of every window of `win_len` cells in all four directions,
+//    which give line completion checks and threat counts in O(win_len);
+//  - the number of stones near each cell, for candidate generation;
+//  - optionally, pattern scores of all cells (see `enable_patterns`) and
+//    accumulators of a network (see `enable_nnue`).
+// Cells are addressed by index `x + y * cols`.
+class Board {
+public:
+  // Cells within this Chebyshev distance from a stone are move candidates.
+  static const int NEAR_RADIUS = 2;
+
+  Board(const State::Opts &opts);
+  explicit Board(const State &state);
+
+  const State::Opts &get_opts() const { return m_opts; }
+  int get_rows() const { return m_opts.rows; }
+  int get_cols() const { return m_opts.cols; }
+  int get_win_len() const { return m_opts.win_len; }
+  int get_n_cells() const { return m_opts.rows * m_opts.cols; }
+
+  int index(int x, int y) const { return x + y * m_opts.cols; }
+  Point point(int idx) const { return Point{idx % m_opts.cols, idx / m_opts.cols}; }
+  bool is_valid(int x, int y) const {
+    return x >= 0 && x < m_opts.cols && y >= 0 && y < m_opts.rows;
+  }
+
+  Sign get(int x, int y) const {
+    return is_valid(x, y) ? m_cells[index(x, y)] : Sign::NONE;
+  }
+  Sign at(int idx) const { return m_cells[idx]; }
+  bool is_empty(int idx) const { return m_cells[idx] == Sign::NONE; }
+  bool is_candidate(int idx) const {
+    return m_cells[idx] == Sign::NONE && m_near[idx] > 0;
+  }
+
+  int get_move_no() const { return m_move_no; }
+  Sign get_current_player() const {
+    return m_move_no % 2 == 0 ? Sign::X : Sign::O;
+  }
+  bool is_full() const { return m_move_no >= m_opts.max_moves; }
+  const std::vector<int> &get_moves() const { return m_moves; }
+  uint64_t get_hash() const { return m_hash; }
+
+  // Places a mark of the current player; `undo` takes back the last one.
+  void place(int idx);
+  // Places a mark of the given sign regardless of the turn, e.g. to look at
+  // threats of the opponent. The turn is still taken from the move count.
+  void place(int idx, Sign sign);
+  void undo();
+
+  // True if a mark of `sign` at the empty cell makes a line of `win_len`.
+  bool completes_line(int idx, Sign sign) const {
+    return has_window(idx, sign, m_opts.win_len - 1);
+  }
+  // With `Status::LAST_MOVE` X has made a line and O has one move left:
+  // only a line of O makes a draw. The first cell from `from` on where O
+  // makes one, -1 if there is none.
+  int get_drawing_reply(int from = 0) const;
+  // The move of O then: a drawing one, else the first empty cell, as every
+  // move loses.
+  int get_last_move_reply() const;
+  // True if a window through the cell has `count` marks of `sign` and no
+  // marks of the other sign.
+  bool has_window(int idx, Sign sign, int count) const;
+  // Appends empty cells of such windows through the cell (with repeats).
+  void collect_window_cells(int idx, Sign sign, int count,
+                            std::vector<int> &cells) const;
+  // True if `sign` has a cell which completes a line.
+  bool has_line_threat(Sign sign) const {
+    return m_n_threats[sign_index(sign)] > 0;
+  }
+  // Number of windows without marks of the other sign holding `count` marks
+  // of `sign`, i.e. lines it can still make with `win_len - count` moves.
+  int get_open_windows(Sign sign, int count) const {
+    return m_n_open[sign_index(sign)][count];
+  }
+  // Sum of window weights of `sign`: every window free of the other sign
+  // scores by the number of marks it still misses.
+  int get_window_score(Sign sign) const {
+    return m_window_score[sign_index(sign)];
+  }
+  // Change of own score plus removed opponent score if `sign` plays `idx`.
+  int get_move_gain(int idx, Sign sign) const;
+
+  // Keeps a `PatternEvaluator` up to date from now on; false if the options
+  // are not supported by pattern tables.
+  bool enable_patterns();
+  const PatternEvaluator *get_patterns() const {
+    return m_patterns ? &*m_patterns : nullptr;
+  }
+  // Keeps the accumulators of `network` up to date from now on; false if it
+  // was made for other options. The network must outlive the board.
+  bool enable_nnue(const NnueNetwork &network);
+  const NnueAccumulator *get_nnue() const {
+    return m_nnue ? &*m_nnue : nullptr;
+  }
+
+  // Hash of an empty board with these options.
+  static uint64_t base_hash(const State::Opts &opts);
+  // Zobrist key of a mark on the cell.
+  uint64_t cell_key(int idx, Sign sign) const;
+
+  // Weight of a window holding `count` marks of one sign only.
+  int window_weight(int count) const;
+
+private:
+  void build_windows();
+  void set_cell(int idx, Sign sign);
+  void clear_cell(int idx);
+  void update_windows(int idx, int si, int delta);
+
+  State::Opts m_opts;
+  std::vector<Sign> m_cells;
+  std::vector<uint8_t> m_near;
+  std::vector<int> m_moves;
+  int m_move_no = 0;
+  uint64_t m_base_hash = 0;
+  uint64_t m_hash = 0;
+
+  // m_cell_windows[idx * m_windows_per_cell + i] are the windows through the
+  // cell, -1 padded.
+  int m_windows_per_cell = 0;
+  std::vector<int> m_cell_windows;
+  // first cell and index step of every window
+  std::vector<int> m_window_start;
+  std::vector<int> m_window_step;
+  std::vector<std::array<uint8_t, 2>> m_window_counts;
+  std::array<int, 2> m_window_score = {0, 0};
+  std::array<int, 2> m_n_threats = {0, 0};
+  // m_n_open[si][count]: windows free of the other sign with `count` marks
+  std::array<std::vector<int>, 2> m_n_open;
+
+  std::optional<PatternEvaluator> m_patterns;
+  std::optional<NnueAccumulator> m_nnue;
+};
+
+}; // namespace ttt::my_player
@@ -0,0 +1,158 @@
+#include "book.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ttt::my_player {
+
+int get_n_symmetries(const State::Opts &opts) {
+  return opts.rows == opts.cols ? 8 : 4;
+}
+
+Point apply_symmetry(const State::Opts &opts, int symmetry, Point p) {
+  const int mx = opts.cols - 1, my = opts.rows - 1;
+  switch (symmetry) {
+  case 1:
+    return {mx - p.x, p.y};
+  case 2:
+    return {p.x, my - p.y};
+  case 3:
+    return {mx - p.x, my - p.y};
+  // the rest only for square boards
+  case 4:
+    return {p.y, p.x};
+  case 5:
+    return {mx - p.y, p.x};
+  case 6:
+    return {p.y, mx - p.x};
+  case 7:
+    return {mx - p.y, mx - p.x};
+  default:
+    return p;
+  }
+}
+
+Point invert_symmetry(const State::Opts &opts, int symmetry, Point p) {
+  // the rotations by a quarter are inverse to each other, the rest are
+  // involutions
+  const int inverse = symmetry == 5 ? 6 : symmetry == 6 ? 5 : symmetry;
+  return apply_symmetry(opts, inverse, p);
+}
+
+BookKey get_book_key(const Board &board) {
+  const State::Opts &opts = board.get_opts();
+  BookKey best = {0, -1};
+  for (int sym = 0; sym < get_n_symmetries(opts); ++sym) {
+    uint64_t key = Board::base_hash(opts);
+    for (int idx = 0; idx < board.get_n_cells(); ++idx) {
+      if (board.is_empty(idx))
+        continue;
+      const Point p = apply_symmetry(opts, sym, board.point(idx));
+      key ^= board.cell_key(board.index(p.x, p.y), board.at(idx));
+    }
+    if (best.symmetry < 0 || key < best.key)
+      best = {key, sym};
+  }
+  return best;
+}
+
+bool OpeningBook::open(const std::string &path) {
+  using namespace book_format;
+  close();
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(Header)) {
+    ::close(fd);
+    return false;
+  }
+  void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED)
+    return false;
+  m_data = data;
+  m_size = st.st_size;
+
+  const auto *header = static_cast<const Header *>(m_data);
+  const size_t expected_size = sizeof(Header) +
+                               size_t(header->n_entries) * sizeof(Entry) +
+                               size_t(header->n_moves) * sizeof(Move);
+  if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      header->version != VERSION || m_size < expected_size) {
+    close();
+    return false;
+  }
+  m_header = header;
+  m_entries = reinterpret_cast<const Entry *>(header + 1);
+  m_moves = reinterpret_cast<const Move *>(m_entries + header->n_entries);
+  return true;
+}
+
+void OpeningBook::close() {
+  if (m_data)
+    munmap(m_data, m_size);
+  m_data = nullptr;
+  m_size = 0;
+  m_header = nullptr;
+  m_entries = nullptr;
+  m_moves = nullptr;
+}
+
+State::Opts OpeningBook::get_opts() const {
+  if (!m_header)
+    return {};
+  return {int(m_header->rows), int(m_header->cols), int(m_header->win_len),
+          int(m_header->max_moves)};
+}
+
+std::vector<BookMove> OpeningBook::probe(const Board &board) const {
+  std::vector<BookMove> moves;
+  const State::Opts &opts = board.get_opts();
+  if (!m_header || int(m_header->rows) != opts.rows ||
+      int(m_header->cols) != opts.cols ||
+      int(m_header->win_len) != opts.win_len ||
+      int(m_header->max_moves) != opts.max_moves)
+    return moves;
+
+  const BookKey key = get_book_key(board);
+  size_t lo = 0, hi = m_header->n_entries;
+  while (lo < hi) {
+    const size_t mid = (lo + hi) / 2;
+    if (m_entries[mid].key < key.key)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if (lo == m_header->n_entries || m_entries[lo].key != key.key)
+    return moves;
+
+  // a corrupt entry points past the moves
+  const book_format::Entry &entry = m_entries[lo];
+  if (uint64_t(entry.first_move) + entry.n_moves > m_header->n_moves)
+    return moves;
+  for (uint32_t i = 0; i < entry.n_moves; ++i) {
+    const book_format::Move &stored = m_moves[entry.first_move + i];
+    if (stored.cell < 0 || stored.cell >= board.get_n_cells())
+      continue;
+    const Point p =
+        invert_symmetry(opts, key.symmetry, board.point(stored.cell));
+    // a stale or colliding entry
+    if (!board.is_empty(board.index(p.x, p.y)))
+      continue;
+    BookMove move;
+    move.move = p;
+    move.score = stored.score;
+    move.depth = stored.depth;
+    move.games = stored.games;
+    move.wins = stored.wins;
+    move.draws = stored.draws;
+    moves.push_back(move);
+  }
+  return moves;
+}
+
+}; // namespace ttt::my_player
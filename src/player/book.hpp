@@ -0,0 +1,108 @@
+#pragma once
+
+#include "board.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ttt::my_player {
+
+// A ranked book move with the statistics it was chosen by.
+struct BookMove {
+  Point move = {-1, -1};
+  // search score from the side to move, valid if `depth >= 0`
+  int score = 0;
+  int depth = -1;
+  // self-play games through the move and their outcomes for the mover
+  uint32_t games = 0;
+  uint32_t wins = 0;
+  uint32_t draws = 0;
+
+  double get_win_rate() const {
+    return games > 0 ? (wins + 0.5 * draws) / games : 0;
+  }
+};
+
+// Key of a position shared by all its symmetric images: the smallest hash
+// over the symmetries of the board (mirrors and, for square boards,
+// rotations and transpositions), and the symmetry which gives it.
+struct BookKey {
+  uint64_t key;
+  int symmetry;
+};
+
+BookKey get_book_key(const Board &board);
+// Number of symmetries of boards with these options.
+int get_n_symmetries(const State::Opts &opts);
+Point apply_symmetry(const State::Opts &opts, int symmetry, Point p);
+Point invert_symmetry(const State::Opts &opts, int symmetry, Point p);
+
+// Layout of a book file: a header, entries sorted by key and their moves,
+// best first, with moves in the coordinates of the canonical position.
+namespace book_format {
+
+const char MAGIC[8] = {'T', 'T', 'T', 'B', 'O', 'O', 'K', '\0'};
+const uint32_t VERSION = 1;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t rows, cols, win_len, max_moves;
+  uint32_t n_entries;
+  uint32_t n_moves;
+  uint32_t reserved[3];
+};
+
+struct Entry {
+  uint64_t key;
+  uint32_t first_move;
+  uint32_t n_moves;
+};
+
+struct Move {
+  int32_t score;
+  uint32_t games, wins, draws;
+  int16_t cell;
+  int16_t depth;
+  uint32_t reserved;
+};
+
+static_assert(sizeof(Header) == 48 && sizeof(Entry) == 16 &&
+              sizeof(Move) == 24);
+
+}; // namespace book_format
+
+// Read-only book mapped into memory: opening it only checks the header, and
+// pages are loaded as lookups touch them; a lookup checks its own entry.
+// Lookups are a binary search and may run from any number of threads.
+class OpeningBook {
+public:
+  OpeningBook() = default;
+  OpeningBook(const OpeningBook &) = delete;
+  OpeningBook &operator=(const OpeningBook &) = delete;
+  ~OpeningBook() { close(); }
+
+  // False if the file is missing, its header is not valid or it is too
+  // short for the entries and moves the header counts.
+  bool open(const std::string &path);
+  void close();
+  bool is_open() const { return m_header != nullptr; }
+
+  State::Opts get_opts() const;
+  size_t get_n_positions() const { return m_header ? m_header->n_entries : 0; }
+
+  // Ranked moves of the position in its own coordinates; empty if the
+  // position is not in the book, its entry is corrupt or the book is for
+  // other options.
+  std::vector<BookMove> probe(const Board &board) const;
+
+private:
+  void *m_data = nullptr;
+  size_t m_size = 0;
+  const book_format::Header *m_header = nullptr;
+  const book_format::Entry *m_entries = nullptr;
+  const book_format::Move *m_moves = nullptr;
+};
+
+}; // namespace ttt::my_player
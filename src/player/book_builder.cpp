@@ -0,0 +1,285 @@
+#include "book_builder.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <thread>
+
+namespace ttt::my_player {
+
+using Clock = std::chrono::steady_clock;
+
+BookBuilder::BookBuilder(const State::Opts &opts)
+    : m_opts(Board(opts).get_opts()) {}
+
+size_t BookBuilder::get_n_positions() const {
+  std::lock_guard lock(m_mutex);
+  return m_positions.size();
+}
+
+BookBuilder::Stats &BookBuilder::get_stats(const Board &board, int idx) {
+  const BookKey key = get_book_key(board);
+  const Point p = apply_symmetry(m_opts, key.symmetry, board.point(idx));
+  return m_positions[key.key][board.index(p.x, p.y)];
+}
+
+void BookBuilder::add_search_result(const Board &board, int idx, int score,
+                                    int depth) {
+  std::lock_guard lock(m_mutex);
+  Stats &stats = get_stats(board, idx);
+  if (depth >= stats.depth) {
+    stats.score = score;
+    stats.depth = depth;
+  }
+}
+
+void BookBuilder::add_game_result(const Board &board, int idx, Sign winner) {
+  std::lock_guard lock(m_mutex);
+  Stats &stats = get_stats(board, idx);
+  ++stats.games;
+  if (winner == board.get_current_player())
+    ++stats.wins;
+  else if (winner == Sign::NONE)
+    ++stats.draws;
+}
+
+static double get_win_rate(const book_format::Move &move) {
+  return move.games > 0 ? (move.wins + 0.5 * move.draws) / move.games : 0;
+}
+
+bool BookBuilder::write(const std::string &path) const {
+  using namespace book_format;
+  std::lock_guard lock(m_mutex);
+  std::vector<uint64_t> keys;
+  keys.reserve(m_positions.size());
+  for (auto &[key, moves] : m_positions)
+    keys.push_back(key);
+  std::sort(keys.begin(), keys.end());
+
+  std::vector<Entry> entries;
+  std::vector<Move> moves;
+  for (uint64_t key : keys) {
+    const size_t first = moves.size();
+    for (auto &[cell, stats] : m_positions.at(key)) {
+      Move move = {};
+      move.score = stats.score;
+      move.games = stats.games;
+      move.wins = stats.wins;
+      move.draws = stats.draws;
+      move.cell = cell;
+      move.depth = stats.depth;
+      moves.push_back(move);
+    }
+    std::sort(moves.begin() + first, moves.end(),
+              [](const Move &a, const Move &b) {
+                if ((a.depth >= 0) != (b.depth >= 0))
+                  return a.depth >= 0;
+                if (a.depth >= 0 && a.score != b.score)
+                  return a.score > b.score;
+                if (get_win_rate(a) != get_win_rate(b))
+                  return get_win_rate(a) > get_win_rate(b);
+                return a.games > b.games;
+              });
+    entries.push_back({key, uint32_t(first), uint32_t(moves.size() - first)});
+  }
+
+  Header header = {};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.rows = m_opts.rows;
+  header.cols = m_opts.cols;
+  header.win_len = m_opts.win_len;
+  header.max_moves = m_opts.max_moves;
+  header.n_entries = entries.size();
+  header.n_moves = moves.size();
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(entries.data()),
+            entries.size() * sizeof(Entry));
+  out.write(reinterpret_cast<const char *>(moves.data()),
+            moves.size() * sizeof(Move));
+  return bool(out);
+}
+
+static int resolve_threads(int n_threads) {
+  return n_threads > 0 ? n_threads
+                       : std::max(1u, std::thread::hardware_concurrency());
+}
+
+// The best `n` moves by static gain, one of every symmetric group.
+static std::vector<int> get_candidates(Board &board, int n) {
+  std::vector<std::pair<int, int>> scored;
+  for (int idx = 0; idx < board.get_n_cells(); ++idx)
+    if (board.is_candidate(idx))
+      scored.push_back(
+          {board.get_move_gain(idx, board.get_current_player()), idx});
+  if (scored.empty() && board.get_move_no() == 0)
+    scored.push_back(
+        {0, board.index(board.get_cols() / 2, board.get_rows() / 2)});
+  std::sort(scored.rbegin(), scored.rend());
+
+  std::vector<int> moves;
+  std::set<uint64_t> seen;
+  for (auto &[gain, idx] : scored) {
+    if (int(moves.size()) >= n)
+      break;
+    board.place(idx);
+    const bool is_new = seen.insert(get_book_key(board).key).second;
+    board.undo();
+    if (is_new)
+      moves.push_back(idx);
+  }
+  return moves;
+}
+
+void build_book_by_search(BookBuilder &builder, const SearchOpts &search_opts,
+                          const BookBuildOpts &opts, std::ostream *log) {
+  const State::Opts &board_opts = builder.get_opts();
+  auto engine = std::make_shared<SearchEngine>(search_opts);
+  const int n_threads = resolve_threads(opts.n_threads);
+  const auto start = Clock::now();
+
+  std::vector<State> level = {State(board_opts)};
+  std::set<uint64_t> expanded;
+  std::atomic<long long> n_searches{0};
+  for (int ply = 0; ply < opts.plies && !level.empty(); ++ply) {
+    std::vector<State> next;
+    std::mutex next_mutex;
+    std::atomic<size_t> next_position{0};
+    auto worker = [&] {
+      SearchContext ctx;
+      engine->start_game(ctx, board_opts, Sign::X);
+      for (size_t i; (i = next_position++) < level.size();) {
+        const State &state = level[i];
+        Board board(state);
+        const Sign side = board.get_current_player();
+        std::vector<std::pair<int, int>> scores;
+        std::vector<int> candidates;
+        if (opts.multi_pv) {
+          // the lines come scored from the side to move
+          for (const auto &line :
+               engine->get_top_lines(ctx, state, opts.candidates)) {
+            const int idx = board.index(line.move.x, line.move.y);
+            builder.add_search_result(board, idx, line.score, line.depth);
+            scores.push_back({line.score, idx});
+          }
+          ++n_searches;
+        } else {
+          candidates = get_candidates(board, opts.candidates);
+        }
+        for (int idx : candidates) {
+          const Point p = board.point(idx);
+          State child = state;
+          const MoveResult result = child.process_move(side, p.x, p.y);
+          int score = 0, depth = 0;
+          if (result == MoveResult::WIN) {
+            score = WIN_SCORE;
+          } else if (child.get_status() == game::Status::LAST_MOVE) {
+            // X made a line: a win unless O's last move makes one too
+            const Point reply = engine->make_move(ctx, child);
+            score = child.process_move(opp_sign(side), reply.x, reply.y) ==
+                            MoveResult::DRAW
+                        ? 0
+                        : WIN_SCORE;
+          } else if (result == MoveResult::OK) {
+            // the child is searched from the opponent's side
+            engine->make_move(ctx, child);
+            score = -ctx.last_info.score;
+            depth = ctx.last_info.depth + 1;
+            ++n_searches;
+          }
+          builder.add_search_result(board, idx, score, depth);
+          scores.push_back({score, idx});
+        }
+        std::sort(scores.rbegin(), scores.rend());
+        std::lock_guard lock(next_mutex);
+        for (int j = 0; j < int(scores.size()) && j < opts.width; ++j) {
+          board.place(scores[j].second);
+          const bool is_new = expanded.insert(get_book_key(board).key).second;
+          board.undo();
+          if (!is_new)
+            continue;
+          const Point p = board.point(scores[j].second);
+          State child = state;
+          if (child.process_move(side, p.x, p.y) == MoveResult::OK)
+            next.push_back(child);
+        }
+      }
+    };
+    std::vector<std::thread> threads;
+    for (int t = 1; t < n_threads; ++t)
+      threads.emplace_back(worker);
+    worker();
+    for (auto &thread : threads)
+      thread.join();
+
+    if (log) {
+      const double seconds =
+          std::chrono::duration<double>(Clock::now() - start).count();
+      *log << "ply " << ply << ": " << level.size() << " positions, "
+           << builder.get_n_positions() << " in book, " << n_searches
+           << " searches, " << seconds << " s\n";
+    }
+    level = std::move(next);
+  }
+}
+
+void build_book_by_self_play(BookBuilder &builder,
+                             const SearchOpts &search_opts,
+                             const BookBuildOpts &opts, std::ostream *log) {
+  const State::Opts &board_opts = builder.get_opts();
+  auto engine = std::make_shared<SearchEngine>(search_opts);
+  const int n_threads = resolve_threads(opts.n_threads);
+  const auto start = Clock::now();
+  std::atomic<int> next_game{0};
+  std::atomic<long long> n_moves{0};
+
+  auto worker = [&](int thread_id) {
+    Rng rng(derive_seed(opts.seed, thread_id));
+    SearchContext contexts[2];
+    for (int game; (game = next_game++) < opts.games;) {
+      engine->start_game(contexts[0], board_opts, Sign::X);
+      engine->start_game(contexts[1], board_opts, Sign::O);
+      State state(board_opts);
+      std::vector<std::pair<State, int>> recorded;
+      while (state.get_status() != game::Status::ENDED) {
+        const Sign side = state.get_current_player();
+        Point move;
+        if (state.get_move_no() < opts.random_plies) {
+          Board board(state);
+          auto candidates = get_candidates(board, opts.candidates);
+          move = board.point(candidates[rng.below(candidates.size())]);
+        } else {
+          move = engine->make_move(contexts[sign_index(side)], state);
+        }
+        if (state.get_move_no() < opts.plies)
+          recorded.push_back(
+              {state, move.x + move.y * board_opts.cols});
+        state.process_move(side, move.x, move.y);
+        ++n_moves;
+      }
+      for (auto &[position, idx] : recorded)
+        builder.add_game_result(Board(position), idx, state.get_winner());
+      if (log && thread_id == 0) {
+        const double seconds =
+            std::chrono::duration<double>(Clock::now() - start).count();
+        *log << "game " << game + 1 << "/" << opts.games << ": "
+             << builder.get_n_positions() << " positions, "
+             << next_game / seconds << " games/s, " << n_moves / seconds
+             << " moves/s\n";
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int t = 1; t < n_threads; ++t)
+    threads.emplace_back(worker, t);
+  worker(0);
+  for (auto &thread : threads)
+    thread.join();
+}
+
+}; // namespace ttt::my_player
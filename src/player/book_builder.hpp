@@ -0,0 +1,75 @@
+#pragma once
+
+#include "book.hpp"
+#include "search.hpp"
+
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+namespace ttt::my_player {
+
+// Collects move statistics of positions, merging symmetric ones, and writes
+// them as a book. All methods may be called from several threads.
+class BookBuilder {
+public:
+  BookBuilder(const State::Opts &opts);
+
+  const State::Opts &get_opts() const { return m_opts; }
+  size_t get_n_positions() const;
+
+  // Score of `idx` in the position from a search of `depth`; deeper results
+  // replace shallower ones.
+  void add_search_result(const Board &board, int idx, int score, int depth);
+  // A game which went through the position and `idx`, won by `winner`
+  // (`Sign::NONE` for a draw).
+  void add_game_result(const Board &board, int idx, Sign winner);
+
+  // Searched moves go first by score, the others by win rate.
+  bool write(const std::string &path) const;
+
+private:
+  struct Stats {
+    int score = 0;
+    int depth = -1;
+    uint32_t games = 0, wins = 0, draws = 0;
+  };
+
+  Stats &get_stats(const Board &board, int idx);
+
+  State::Opts m_opts;
+  mutable std::mutex m_mutex;
+  std::unordered_map<uint64_t, std::map<int, Stats>> m_positions;
+};
+
+struct BookBuildOpts {
+  // book positions are at most this many moves into the game
+  int plies = 8;
+  // searched candidates of a position and the best of them expanded further
+  int candidates = 6;
+  int width = 2;
+  // rank the candidates by one multi-PV search of the position (see
+  // `SearchEngine::get_top_lines`) instead of a search after each of them
+  bool multi_pv = false;
+  // self-play games and moves chosen at random among the candidates at the
+  // start of each game
+  int games = 100;
+  int random_plies = 2;
+  int n_threads = 0;
+  uint64_t seed = 1;
+};
+
+// Expands the positions level by level from the empty board: every candidate
+// move is scored by a search of the position after it, and the best `width`
+// moves are expanded. Threads share the positions of one level.
+void build_book_by_search(BookBuilder &builder, const SearchOpts &search_opts,
+                          const BookBuildOpts &opts, std::ostream *log);
+// Plays games of the search engine against itself on all threads and
+// records the results of the first `plies` moves.
+void build_book_by_self_play(BookBuilder &builder,
+                             const SearchOpts &search_opts,
+                             const BookBuildOpts &opts, std::ostream *log);
+
+}; // namespace ttt::my_player
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "core/game.hpp"
+#include "rng.hpp"
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ttt::my_player {
+
+using game::Event;
+using game::IPlayer;
+using game::MoveResult;
+using game::Point;
+using game::Sign;
+using game::State;
+
+// Per-game part of a player: everything which changes while one game is
+// played. Engines derive their own context from it to keep scratch data.
+struct GameContext {
+  Sign sign = Sign::NONE;
+  State::Opts opts = {};
+  // number of the next game and the seed of the current one (see
+  // `get_game_seed`)
+  int next_game_no = 0;
+  uint64_t seed = 0;
+};
+
+// Work done for one move, reported by players which search (see
+// `IStatsPlayer`). Fields an engine does not track stay 0.
+struct MoveStats {
+  // nodes of the main search and of the solvers
+  long long nodes = 0;
+  long long solver_nodes = 0;
+  int depth = 0;
+  // transposition table lookups and those which found the position
+  long long tt_probes = 0;
+  long long tt_hits = 0;
+  // share of the table written by this search (see
+  // `TranspositionTable::get_fill`)
+  double tt_fill = 0;
+  // phases of the move: book and tablebase lookups, solvers (threats or
+  // proof numbers) and the main search
+  double lookup_ms = 0;
+  double solver_ms = 0;
+  double search_ms = 0;
+  double time_ms = 0;
+
+  double get_tt_hit_rate() const {
+    return tt_probes > 0 ? double(tt_hits) / tt_probes : 0;
+  }
+  // Effective branching factor: the growth of the tree per ply of depth.
+  double get_branching_factor() const {
+    return depth > 0 && nodes > 0 ? std::pow(double(nodes), 1.0 / depth) : 0;
+  }
+};
+
+// Players which report the work of their moves; callers find them with
+// `dynamic_cast`, like `ISeededPlayer`.
+struct IStatsPlayer {
+  // Stats of the last `make_move`; false if the player has none.
+  virtual bool get_move_stats(MoveStats &stats) const = 0;
+  virtual ~IStatsPlayer() {}
+};
+
+// One of the best moves of a position with its line (see
+// `IMultiPvPlayer`).
+struct RankedLine {
+  Point move = {-1, -1};
+  // from the side to move, in the scale of the engine
+  int score = 0;
+  int depth = 0;
+  // the move and the expected replies
+  std::vector<Point> pv;
+};
+
+// Players which rank several moves of a position at once, for analysis and
+// book building; callers find them with `dynamic_cast`.
+struct IMultiPvPlayer {
+  // Up to `n_lines` best moves of the side to move, best first, from one
+  // search within the move time; empty if the game is over.
+  virtual std::vector<RankedLine> get_top_lines(const State &state,
+                                                int n_lines) = 0;
+  virtual ~IMultiPvPlayer() {}
+};
+
+// Base for engines shared between many games. An engine owns the heavy,
+// read-mostly data (weights, opening book, shared tables) and must allow
+// concurrent calls from different threads as long as each call gets its own
+// context. Engines override the hooks they need; they are bound statically
+// by EngineContext, so none of them is virtual.
+template <class Context> class EngineBase {
+public:
+  using context_type = Context;
+
+  void start_game(Context &ctx, const State::Opts &opts, Sign sign) {
+    ctx.opts = opts;
+    ctx.sign = sign;
+    ctx.seed = get_game_seed(ctx.next_game_no++, sign);
+  }
+  void end_game(Context &ctx, const State &state, MoveResult result) {}
+  void handle_event(Context &ctx, const State &state, const Event &event) {}
+  bool get_move_stats(const Context &ctx, MoveStats &stats) const {
+    return false;
+  }
+  std::vector<RankedLine> get_top_lines(Context &ctx, const State &state,
+                                        int n_lines) {
+    return {};
+  }
+};
+
+// Players whose random choices follow the game seeds (see `get_game_seed`).
+// Games are numbered from 0 in the order they start; a tournament which
+// spreads games over threads numbers them itself to replay the same games.
+struct ISeededPlayer {
+  virtual void set_next_game_no(int game_no) = 0;
+  virtual ~ISeededPlayer() {}
+};
+
+// Lightweight player for one game at a time, backed by a shared engine. Any
+// number of contexts may use one engine, from any number of threads.
+template <class Engine>
+class EngineContext : public IPlayer,
+                      public ISeededPlayer,
+                      public IStatsPlayer,
+                      public IMultiPvPlayer {
+  std::shared_ptr<Engine> m_engine;
+  typename Engine::context_type m_ctx;
+  std::string m_name;
+
+public:
+  EngineContext(std::shared_ptr<Engine> engine, const char *name)
+      : m_engine(std::move(engine)), m_ctx(), m_name(name) {}
+
+  void set_sign(Sign sign) override { m_ctx.sign = sign; }
+  void on_game_start(const State::Opts &opts, Sign sign) override {
+    m_engine->start_game(m_ctx, opts, sign);
+  }
+  void on_game_end(const State &state, MoveResult result) override {
+    m_engine->end_game(m_ctx, state, result);
+  }
+  Point make_move(const State &state) override {
+    return m_engine->make_move(m_ctx, state);
+  }
+  void handle_event(const State &state, const Event &event) override {
+    m_engine->handle_event(m_ctx, state, event);
+  }
+  const char *get_name() const override { return m_name.c_str(); }
+  void set_next_game_no(int game_no) override {
+    m_ctx.next_game_no = game_no;
+  }
+  bool get_move_stats(MoveStats &stats) const override {
+    stats = MoveStats();
+    return m_engine->get_move_stats(m_ctx, stats);
+  }
+  std::vector<RankedLine> get_top_lines(const State &state,
+                                        int n_lines) override {
+    return m_engine->get_top_lines(m_ctx, state, n_lines);
+  }
+
+  Engine &get_engine() { return *m_engine; }
+  const std::shared_ptr<Engine> &get_shared_engine() const { return m_engine; }
+  typename Engine::context_type &get_context() { return m_ctx; }
+};
+
+}; // namespace ttt::my_player
@@ -0,0 +1,111 @@
+#include "eval_cache.hpp"
+
+#include <map>
+#include <mutex>
+
+namespace ttt::my_player {
+
+EvalCache::EvalCache(size_t size_mb) : m_shards(new Shard[N_SHARDS]) {
+  size_t n_buckets = N_SHARDS;
+  while (n_buckets * 2 * sizeof(Bucket) <= size_mb * 1024 * 1024)
+    n_buckets *= 2;
+  m_buckets.reset(new Bucket[n_buckets]);
+  m_n_buckets = n_buckets;
+  m_shard_buckets = n_buckets / N_SHARDS;
+  clear();
+}
+
+std::shared_ptr<EvalCache> EvalCache::get_shared(size_t size_mb) {
+  static std::mutex mutex;
+  static std::map<size_t, std::weak_ptr<EvalCache>> caches;
+  std::lock_guard<std::mutex> lock(mutex);
+  std::shared_ptr<EvalCache> cache = caches[size_mb].lock();
+  if (!cache) {
+    cache = std::make_shared<EvalCache>(size_mb);
+    caches[size_mb] = cache;
+  }
+  return cache;
+}
+
+void EvalCache::clear() {
+  for (size_t b = 0; b < m_n_buckets; ++b) {
+    for (auto &slot : m_buckets[b].slots)
+      slot.store(0, std::memory_order_relaxed);
+    m_buckets[b].referenced.store(0, std::memory_order_relaxed);
+    m_buckets[b].hand.store(0, std::memory_order_relaxed);
+  }
+  for (int s = 0; s < N_SHARDS; ++s) {
+    m_shards[s].probes.store(0, std::memory_order_relaxed);
+    m_shards[s].hits.store(0, std::memory_order_relaxed);
+    m_shards[s].stores.store(0, std::memory_order_relaxed);
+    m_shards[s].evictions.store(0, std::memory_order_relaxed);
+  }
+}
+
+bool EvalCache::probe(uint64_t key, int &value) {
+  Shard &shard = get_shard(key);
+  Bucket &bucket = get_bucket(key);
+  const uint64_t key_tag = tag(key);
+  shard.probes.fetch_add(1, std::memory_order_relaxed);
+  for (int i = 0; i < BUCKET_SIZE; ++i) {
+    const uint64_t slot = bucket.slots[i].load(std::memory_order_relaxed);
+    if ((slot & 0xffffffff00000000) != key_tag)
+      continue;
+    value = int32_t(uint32_t(slot));
+    // only write the line when the bit changes
+    const uint8_t bit = uint8_t(1) << i;
+    if (!(bucket.referenced.load(std::memory_order_relaxed) & bit))
+      bucket.referenced.fetch_or(bit, std::memory_order_relaxed);
+    shard.hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+void EvalCache::store(uint64_t key, int value) {
+  Shard &shard = get_shard(key);
+  Bucket &bucket = get_bucket(key);
+  const uint64_t key_tag = tag(key);
+  const uint64_t word = key_tag | uint32_t(value);
+  shard.stores.fetch_add(1, std::memory_order_relaxed);
+  int empty = -1;
+  for (int i = 0; i < BUCKET_SIZE; ++i) {
+    const uint64_t slot = bucket.slots[i].load(std::memory_order_relaxed);
+    if ((slot & 0xffffffff00000000) == key_tag) {
+      bucket.slots[i].store(word, std::memory_order_relaxed);
+      return;
+    }
+    if (slot == 0 && empty < 0)
+      empty = i;
+  }
+  if (empty >= 0) {
+    bucket.slots[empty].store(word, std::memory_order_relaxed);
+    return;
+  }
+
+  // clock sweep; every slot loses its bit within one round, so two rounds
+  // always find a victim
+  int hand = bucket.hand.load(std::memory_order_relaxed) % BUCKET_SIZE;
+  for (int step = 0; step < 2 * BUCKET_SIZE; ++step) {
+    const uint8_t bit = uint8_t(1) << hand;
+    if (!(bucket.referenced.fetch_and(~bit, std::memory_order_relaxed) & bit))
+      break;
+    hand = (hand + 1) % BUCKET_SIZE;
+  }
+  bucket.slots[hand].store(word, std::memory_order_relaxed);
+  bucket.hand.store((hand + 1) % BUCKET_SIZE, std::memory_order_relaxed);
+  shard.evictions.fetch_add(1, std::memory_order_relaxed);
+}
+
+EvalCacheStats EvalCache::get_stats() const {
+  EvalCacheStats stats;
+  for (int s = 0; s < N_SHARDS; ++s) {
+    stats.probes += m_shards[s].probes.load(std::memory_order_relaxed);
+    stats.hits += m_shards[s].hits.load(std::memory_order_relaxed);
+    stats.stores += m_shards[s].stores.load(std::memory_order_relaxed);
+    stats.evictions += m_shards[s].evictions.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+}; // namespace ttt::my_player
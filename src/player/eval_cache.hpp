@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace ttt::my_player {
+
+struct EvalCacheStats {
+  long long probes = 0;
+  long long hits = 0;
+  long long stores = 0;
+  // stores which replaced another position
+  long long evictions = 0;
+
+  double get_hit_rate() const {
+    return probes > 0 ? double(hits) / probes : 0;
+  }
+};
+
+// Position hash -> static evaluation, shared without locks by every search
+// thread of the process. A slot is one word, a tag from the high bits of the
+// key next to the value, so reads are never torn. Buckets of seven slots fill
+// a cache line together with their reference bits and clock hand: a hit sets
+// the reference bit of its slot, and a store into a full bucket sweeps the
+// hand over the slots, clearing reference bits, until it finds one which was
+// not used since the last sweep. The buckets are split in shards by the top
+// bits of the key, each with its own counters, so that threads seldom write
+// the same counter line.
+class EvalCache {
+public:
+  static const int BUCKET_SIZE = 7;
+  static const int N_SHARDS = 64;
+
+  // Allocates the largest power-of-two number of buckets fitting `size_mb`,
+  // at least one per shard.
+  explicit EvalCache(size_t size_mb);
+
+  // The cache of this size shared by the whole process; it lives while some
+  // caller holds it.
+  static std::shared_ptr<EvalCache> get_shared(size_t size_mb);
+
+  // Number of entries.
+  size_t get_size() const { return m_n_buckets * BUCKET_SIZE; }
+  void clear();
+
+  bool probe(uint64_t key, int &value);
+  void store(uint64_t key, int value);
+
+  EvalCacheStats get_stats() const;
+
+private:
+  struct alignas(64) Bucket {
+    std::atomic<uint64_t> slots[BUCKET_SIZE];
+    std::atomic<uint8_t> referenced;
+    std::atomic<uint8_t> hand;
+  };
+
+  struct alignas(64) Shard {
+    std::atomic<long long> probes{0};
+    std::atomic<long long> hits{0};
+    std::atomic<long long> stores{0};
+    std::atomic<long long> evictions{0};
+  };
+
+  Shard &get_shard(uint64_t key) { return m_shards[key >> 58]; }
+  Bucket &get_bucket(uint64_t key) {
+    return m_buckets[(key >> 58) * m_shard_buckets +
+                     (key & (m_shard_buckets - 1))];
+  }
+  // Tag of the key in the high half of a slot; never 0, which is empty.
+  static uint64_t tag(uint64_t key) {
+    return (key & 0xffffffff00000000) | uint64_t(1) << 32;
+  }
+  static_assert(N_SHARDS == 64, "shards come from the top 6 bits of keys");
+
+  std::unique_ptr<Bucket[]> m_buckets;
+  size_t m_n_buckets = 0;
+  size_t m_shard_buckets = 0;
+  std::unique_ptr<Shard[]> m_shards;
+};
+
+}; // namespace ttt::my_player
@@ -0,0 +1,119 @@
+#include "heatmap.hpp"
+
+#include <algorithm>
+
+namespace ttt::my_player {
+
+MoveHeatmap::MoveHeatmap(const HeatmapWeights &weights) : m_weights(weights) {
+  // value of the threat bits of one direction
+  auto value = [](int bits, const std::array<int, N_THREAT_TYPES> &w) {
+    return (bits & THREAT_LINE ? w[0] : 0) +
+           (bits & THREAT_DOUBLE_FOUR ? w[2]
+            : bits & THREAT_FOUR      ? w[1]
+                                      : 0) +
+           (bits & THREAT_THREE ? w[3] : 0);
+  };
+  for (int b = 0; b < 256; ++b) {
+    const int lo = b & 15, hi = b >> 4;
+    m_attack[b] = value(lo, weights.attack) + value(hi, weights.attack);
+    m_defence[b] = value(lo, weights.defence) + value(hi, weights.defence);
+    m_strong[b] = ((lo & (THREAT_LINE | THREAT_FOUR)) != 0) +
+                  ((hi & (THREAT_LINE | THREAT_FOUR)) != 0);
+  }
+}
+
+void MoveHeatmap::compute(const State &state) { compute(Bitboard(state)); }
+
+void MoveHeatmap::compute(const Bitboard &board) {
+  m_threats.compute(board);
+  const int n_cells = board.get_n_cells();
+  for (int si = 0; si < 2; ++si) {
+    m_masks[si].assign(n_cells, 0);
+    m_scores[si].assign(n_cells, 0);
+  }
+  score(0, board.get_cols(), 0, board.get_rows());
+}
+
+void MoveHeatmap::update(const Bitboard &board, int idx) {
+  m_threats.update(board, idx);
+  const State::Opts &opts = get_opts();
+  const int pad = opts.win_len - 1;
+  const int x = idx % opts.cols, y = idx / opts.cols;
+  score(std::max(0, x - pad), std::min(opts.cols, x + pad + 1),
+        std::max(0, y - pad), std::min(opts.rows, y + pad + 1));
+}
+
+void MoveHeatmap::score(int x0, int x1, int y0, int y1) {
+  const State::Opts &opts = get_opts();
+  const int cols = opts.cols;
+  const uint64_t row_mask =
+      cols == 64 ? ~uint64_t(0) : (uint64_t(1) << cols) - 1;
+  const uint64_t col_mask =
+      (x1 == 64 ? ~uint64_t(0) : (uint64_t(1) << x1) - 1) &
+      ~((uint64_t(1) << x0) - 1);
+  auto occupied = [&](int y) {
+    if (y < 0 || y >= opts.rows)
+      return uint64_t(0);
+    return m_threats.get_row(Sign::X, y) | m_threats.get_row(Sign::O, y);
+  };
+
+  for (int y = y0; y < y1; ++y) {
+    // masks of the cells from the set bits of the planes
+    for (int si = 0; si < 2; ++si) {
+      uint16_t *masks = m_masks[si].data() + y * cols;
+      std::fill(masks + x0, masks + x1, 0);
+      const Sign sign = si ? Sign::O : Sign::X;
+      for (int dir = 0; dir < N_THREAT_DIRECTIONS; ++dir)
+        for (int t = 0; t < N_THREAT_TYPES; ++t) {
+          const uint16_t bit = uint16_t(1) << (dir * N_THREAT_TYPES + t);
+          uint64_t bits =
+              m_threats.get_plane(sign, dir, ThreatBit(1 << t))[y] & col_mask;
+          while (bits) {
+            masks[__builtin_ctzll(bits)] |= bit;
+            bits &= bits - 1;
+          }
+        }
+    }
+
+    const uint64_t occ = occupied(y);
+    uint64_t near = occupied(y - 1) | occ | occupied(y + 1);
+    near = (near | near << 1 | near >> 1) & ~occ & row_mask;
+    auto attack = [&](uint16_t mask) {
+      const int lo = mask & 255, hi = mask >> 8;
+      return m_attack[lo] + m_attack[hi] +
+             (m_strong[lo] + m_strong[hi] >= 2 ? m_weights.attack_double : 0);
+    };
+    auto defence = [&](uint16_t mask) {
+      const int lo = mask & 255, hi = mask >> 8;
+      return m_defence[lo] + m_defence[hi] +
+             (m_strong[lo] + m_strong[hi] >= 2 ? m_weights.defence_double
+                                               : 0);
+    };
+    const uint16_t *masks_x = m_masks[0].data() + y * cols;
+    const uint16_t *masks_o = m_masks[1].data() + y * cols;
+    int16_t *scores_x = m_scores[0].data() + y * cols;
+    int16_t *scores_o = m_scores[1].data() + y * cols;
+    for (int x = x0; x < x1; ++x) {
+      if ((occ >> x) & 1) {
+        scores_x[x] = scores_o[x] = -1;
+        continue;
+      }
+      const int quiet = (near >> x) & 1 ? m_weights.neighbour : 0;
+      scores_x[x] = std::min(
+          32767, attack(masks_x[x]) + defence(masks_o[x]) + quiet);
+      scores_o[x] = std::min(
+          32767, attack(masks_o[x]) + defence(masks_x[x]) + quiet);
+    }
+  }
+}
+
+int MoveHeatmap::get_best(Sign side) const {
+  const std::vector<int16_t> &scores = m_scores[sign_index(side)];
+  int best = -1;
+  for (int idx = 0; idx < int(scores.size()); ++idx)
+    if (scores[idx] >= 0 && (best < 0 || scores[idx] > scores[best]))
+      best = idx;
+  return best;
+}
+
+}; // namespace ttt::my_player
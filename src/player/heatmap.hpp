@@ -0,0 +1,74 @@
+#pragma once
+
+#include "threat_map.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace ttt::my_player {
+
+// Values of the threat types of one direction, by the bit index of
+// `ThreatBit` (line, four, double four, three). A double four counts
+// instead of the four it contains.
+struct HeatmapWeights {
+  // a line of our own beats anything, blocking one beats any other threat
+  std::array<int, N_THREAT_TYPES> attack = {20000, 160, 800, 16};
+  std::array<int, N_THREAT_TYPES> defence = {4000, 100, 400, 10};
+  // fours or lines in two directions at once, of the own and of the
+  // opponent's marks
+  int attack_double = 600;
+  int defence_double = 300;
+  // an empty cell next to a stone
+  int neighbour = 1;
+};
+
+// Scores of all cells of a position for both sides to move: the value of
+// the threats a mark there makes plus the value of the opponent's threats
+// it blocks, plus `neighbour` next to stones. The threats come from the
+// vectorised `ThreatMap` and the masks of a cell are turned into a score by
+// table lookups, so a whole board costs a few microseconds.
+// After a move only the cells within `win_len - 1` of it change; `update`
+// recomputes those.
+class MoveHeatmap {
+public:
+  static bool supports(const State::Opts &opts) {
+    return ThreatMap::supports(opts);
+  }
+
+  MoveHeatmap(const HeatmapWeights &weights = HeatmapWeights());
+
+  void compute(const State &state);
+  void compute(const Bitboard &board);
+  // `board` is the board of the last `compute` or `update` with a mark
+  // placed (or removed) at `idx`.
+  void update(const Bitboard &board, int idx);
+
+  const State::Opts &get_opts() const { return m_threats.get_opts(); }
+  // Scores of the cells by index for `side` to move; 0 for quiet cells
+  // away from stones, -1 for occupied cells. Scores fit in int16_t.
+  const std::vector<int16_t> &get_scores(Sign side) const {
+    return m_scores[sign_index(side)];
+  }
+  int get_score(int idx, Sign side) const {
+    return m_scores[sign_index(side)][idx];
+  }
+  // The empty cell with the best score for `side`, -1 on a full board.
+  int get_best(Sign side) const;
+  const ThreatMap &get_threats() const { return m_threats; }
+
+private:
+  // Rescores cells `x0 .. x1 - 1` of rows `y0 .. y1 - 1`.
+  void score(int x0, int x1, int y0, int y1);
+
+  HeatmapWeights m_weights;
+  // per mask byte (two directions): value and number of strong directions,
+  // for attack and defence
+  std::array<int, 256> m_attack, m_defence;
+  std::array<uint8_t, 256> m_strong;
+  ThreatMap m_threats;
+  std::vector<uint16_t> m_masks[2];
+  std::vector<int16_t> m_scores[2];
+};
+
+}; // namespace ttt::my_player
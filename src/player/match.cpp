@@ -0,0 +1,80 @@
+#include "match.hpp"
+#include "board.hpp"
+#include "engine.hpp"
+#include "registry.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ttt::my_player {
+
+static void set_game_no(game::IPlayer &player, int game_no) {
+  if (auto *seeded = dynamic_cast<ISeededPlayer *>(&player))
+    seeded->set_next_game_no(game_no);
+}
+
+bool run_match(const std::string &spec_a, const std::string &spec_b,
+               const MatchOpts &opts, MatchResult &result,
+               std::string &error) {
+  auto &registry = PlayerRegistry::get();
+  for (const std::string &spec : {spec_a, spec_b})
+    if (!registry.create(spec, "check", error))
+      return false;
+
+  const int n_threads = std::min(
+      opts.games, opts.n_threads > 0
+                      ? opts.n_threads
+                      : int(std::max(1u, std::thread::hardware_concurrency())));
+  std::atomic<int> next_game{0};
+  std::mutex result_mutex;
+  result = MatchResult();
+
+  auto worker = [&] {
+    std::string spec_error;
+    auto a = registry.create(spec_a, spec_a.c_str(), spec_error);
+    auto b = registry.create(spec_b, spec_b.c_str(), spec_error);
+    MatchResult local;
+    for (int i; (i = next_game++) < opts.games;) {
+      // `a` plays X in even games
+      const bool a_is_x = i % 2 == 0;
+      game::IPlayer &x = a_is_x ? *a : *b, &o = a_is_x ? *b : *a;
+      set_game_no(x, i);
+      set_game_no(o, i);
+      game::Game game(opts.board);
+      game.add_player(game::Sign::X, &x);
+      game.add_player(game::Sign::O, &o);
+      game::MoveResult res;
+      while ((res = game.process()) == game::MoveResult::OK)
+        ;
+      const game::State &state = game.get_state();
+      // a disqualified player is still to move
+      const game::Sign winner =
+          game::is_dq(res) ? opp_sign(state.get_current_player())
+                           : state.get_winner();
+      local.errors += game::is_dq(res);
+      if (res == game::MoveResult::DRAW)
+        ++local.draws;
+      else if ((winner == game::Sign::X) == a_is_x)
+        ++local.wins;
+      else
+        ++local.losses;
+    }
+    std::lock_guard lock(result_mutex);
+    result.wins += local.wins;
+    result.losses += local.losses;
+    result.draws += local.draws;
+    result.errors += local.errors;
+  };
+  std::vector<std::thread> threads;
+  for (int t = 1; t < n_threads; ++t)
+    threads.emplace_back(worker);
+  worker();
+  for (auto &thread : threads)
+    thread.join();
+  return true;
+}
+
+}; // namespace ttt::my_player
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "core/game.hpp"
+
+#include <string>
+
+namespace ttt::my_player {
+
+using game::State;
+
+struct MatchOpts {
+  State::Opts board = {15, 15, 5, 0};
+  // games in total; the players swap signs every game
+  int games = 100;
+  // games played at once, each with its own `Game` and players; 0 uses all
+  // hardware threads
+  int n_threads = 0;
+};
+
+// Outcome of a match for its first player.
+struct MatchResult {
+  int wins = 0;
+  int losses = 0;
+  int draws = 0;
+  // disqualifications, also counted as losses of the offender
+  int errors = 0;
+
+  int get_games() const { return wins + losses + draws; }
+  // 1 for a win, 0.5 for a draw, per game
+  double get_score() const {
+    return get_games() > 0 ? (wins + 0.5 * draws) / get_games() : 0;
+  }
+};
+
+// Plays a match between two players given as `PlayerRegistry` specs: the
+// first one plays X in even games. Game `i` has number `i` for both
+// players (see `EngineContext::set_next_game_no`) where they support it, so
+// a master seed gives the same games on any number of threads. False with
+// `error` set if a spec is wrong.
+bool run_match(const std::string &spec_a, const std::string &spec_b,
+               const MatchOpts &opts, MatchResult &result, std::string &error);
+
+}; // namespace ttt::my_player
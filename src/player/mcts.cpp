@@ -0,0 +1,477 @@
+#include "mcts.hpp"
+#include "patterns.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+namespace ttt::my_player {
+
+using Clock = std::chrono::steady_clock;
+
+void MctsArena::reserve(int capacity) {
+  if (capacity != m_capacity) {
+    m_nodes.reset(new MctsNode[capacity]);
+    m_capacity = capacity;
+  }
+  reset();
+}
+
+namespace {
+
+// Pattern score of a mark of `sign` on the empty cell.
+static int pattern_score(const Bitboard &b, const PatternTable &table, int idx,
+                         Sign sign) {
+  static const int directions[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+  const int len = table.get_win_len();
+  const int x = idx % b.get_cols(), y = idx / b.get_cols();
+  uint32_t codes[4];
+  for (int dir = 0; dir < 4; ++dir) {
+    uint32_t code = 0;
+    for (int pos = 0; pos < table.get_n_neighbors(); ++pos) {
+      const int offset = pos < len - 1 ? pos - (len - 1) : pos - len + 2;
+      const int nx = x + offset * directions[dir][0];
+      const int ny = y + offset * directions[dir][1];
+      int digit = 2;
+      if (nx >= 0 && nx < b.get_cols() && ny >= 0 && ny < b.get_rows()) {
+        const Sign s = b.get(b.index(nx, ny));
+        digit = s == Sign::NONE ? 0 : s == sign ? 1 : 2;
+      }
+      code += digit * table.get_pow3(pos);
+    }
+    codes[dir] = code;
+  }
+  return table.get_cell_score(codes);
+}
+
+static int score_for(Sign winner, Sign mover) {
+  return winner == mover ? 2 : winner == Sign::NONE ? 1 : 0;
+}
+
+class Worker {
+  MctsArena &m_tree;
+  const Bitboard &m_root_board;
+  const int m_root;
+  const MctsOpts &m_opts;
+  Rng m_rng;
+  Bitboard m_board;
+  std::vector<int> m_path;
+  std::vector<int> m_cells;
+  std::vector<int8_t> m_results;
+  std::vector<int> m_priors;
+  const PatternTable *m_patterns = nullptr;
+  long long m_iterations = 0;
+
+public:
+  Worker(MctsArena &tree, const Bitboard &root_board, int root,
+         const MctsOpts &opts, uint64_t seed)
+      : m_tree(tree), m_root_board(root_board), m_root(root), m_opts(opts),
+        m_rng(seed) {
+    if (opts.prior_weight > 0 &&
+        PatternTable::supports(root_board.get_opts().win_len))
+      m_patterns = &PatternTable::get(root_board.get_opts().win_len);
+  }
+
+  void run_iteration();
+  long long get_iterations() const { return m_iterations; }
+
+private:
+  bool expand(MctsNode &node);
+  int select_child(MctsNode &node);
+  Sign playout();
+};
+
+void Worker::run_iteration() {
+  ++m_iterations;
+  m_board = m_root_board;
+  m_path.clear();
+  int idx = m_root;
+  m_tree[idx].visits.fetch_add(1, std::memory_order_relaxed);
+  m_path.push_back(idx);
+
+  Sign winner;
+  while (true) {
+    MctsNode &node = m_tree[idx];
+    if (node.result >= 0) {
+      const Sign mover = opp_sign(m_board.get_current_player());
+      winner = node.result == 2   ? mover
+               : node.result == 1 ? Sign::NONE
+                                  : opp_sign(mover);
+      break;
+    }
+    uint8_t state = node.state.load(std::memory_order_acquire);
+    if (state == MctsNode::LEAF && !m_tree.is_full() &&
+        (idx == m_root ||
+         node.visits.load(std::memory_order_relaxed) >= m_opts.expand_visits) &&
+        expand(node))
+      state = MctsNode::EXPANDED;
+    if (state != MctsNode::EXPANDED || node.n_children == 0) {
+      winner = playout();
+      break;
+    }
+    idx = select_child(node);
+    m_board.place(m_tree[idx].move, m_board.get_current_player());
+    m_path.push_back(idx);
+  }
+
+  // the root was entered by the opponent of the side to move
+  const Sign root_side = m_root_board.get_current_player();
+  for (size_t depth = 0; depth < m_path.size(); ++depth) {
+    const Sign mover = depth % 2 == 1 ? root_side : opp_sign(root_side);
+    m_tree[m_path[depth]].score.fetch_add(score_for(winner, mover),
+                                          std::memory_order_relaxed);
+  }
+}
+
+bool Worker::expand(MctsNode &node) {
+  uint8_t expected = MctsNode::LEAF;
+  if (!node.state.compare_exchange_strong(expected, MctsNode::EXPANDING,
+                                          std::memory_order_acq_rel))
+    return false;
+
+  Bitboard &b = m_board;
+  const Sign side = b.get_current_player(), opp = opp_sign(side);
+  m_cells.clear();
+  for (int idx : b.get_frontier())
+    if (b.is_empty(idx))
+      m_cells.push_back(idx);
+  if (m_cells.empty() && b.get_move_no() == 0)
+    m_cells.push_back(b.index(b.get_cols() / 2, b.get_rows() / 2));
+
+  // a line ends the game; X completing one still lets O draw
+  m_results.assign(m_cells.size(), -1);
+  bool has_win = false, has_line = false;
+  for (size_t i = 0; i < m_cells.size(); ++i) {
+    if (!b.makes_line(m_cells[i], side))
+      continue;
+    has_line = true;
+    m_results[i] = 2;
+    if (side == Sign::X) {
+      Bitboard after = b;
+      after.place(m_cells[i], side);
+      if (after.has_line_cell(Sign::O))
+        m_results[i] = 1;
+    }
+    has_win |= m_results[i] == 2;
+  }
+  size_t n = 0;
+  for (size_t i = 0; i < m_cells.size(); ++i) {
+    // only winning moves, else lines and blocks, else everything
+    const bool keep = has_win    ? m_results[i] == 2
+                      : has_line ? m_results[i] >= 0 ||
+                                       b.makes_line(m_cells[i], opp)
+                                 : true;
+    if (keep) {
+      m_cells[n] = m_cells[i];
+      m_results[n] = m_results[i];
+      ++n;
+    }
+  }
+  if (!has_line) {
+    // blocking a line of the opponent is forced
+    size_t n_blocks = 0;
+    for (size_t i = 0; i < n; ++i)
+      if (b.makes_line(m_cells[i], opp))
+        m_cells[n_blocks++] = m_cells[i];
+    if (n_blocks > 0)
+      n = n_blocks;
+  }
+
+  const int first = n > 0 ? m_tree.allocate(n) : -1;
+  if (first < 0) {
+    node.state.store(MctsNode::LEAF, std::memory_order_release);
+    return false;
+  }
+  // attack and defence value of the moves, scaled to the best one
+  m_priors.assign(n, 0);
+  int max_prior = 1;
+  if (m_patterns) {
+    for (size_t i = 0; i < n; ++i) {
+      m_priors[i] = pattern_score(b, *m_patterns, m_cells[i], side) +
+                    pattern_score(b, *m_patterns, m_cells[i], opp);
+      max_prior = std::max(max_prior, m_priors[i]);
+    }
+  }
+  const bool last_cell = b.get_move_no() + 1 >= b.get_opts().max_moves;
+  for (size_t i = 0; i < n; ++i) {
+    const int result = m_results[i] >= 0 ? m_results[i] : last_cell ? 1 : -1;
+    m_tree[first + i].init(m_cells[i], result,
+                           m_priors[i] * MctsNode::PRIOR_SCALE / max_prior);
+  }
+  node.first_child = first;
+  node.n_children = n;
+  node.state.store(MctsNode::EXPANDED, std::memory_order_release);
+  return true;
+}
+
+int Worker::select_child(MctsNode &node) {
+  const double log_n =
+      std::log(double(node.visits.load(std::memory_order_relaxed)) + 1);
+  const double prior_weight = m_opts.prior_weight / MctsNode::PRIOR_SCALE;
+  int best = node.first_child;
+  double best_value = -1;
+  for (int i = 0; i < node.n_children; ++i) {
+    MctsNode &child = m_tree[node.first_child + i];
+    const int visits = child.visits.load(std::memory_order_relaxed);
+    const double bias = prior_weight * child.prior / (visits + 1);
+    // unvisited children go first, the most promising of them first
+    if (visits == 0) {
+      if (best_value < 10 + bias) {
+        best_value = 10 + bias;
+        best = node.first_child + i;
+      }
+      continue;
+    }
+    const double q =
+        child.score.load(std::memory_order_relaxed) / (2.0 * visits);
+    const double value =
+        q + m_opts.exploration * std::sqrt(log_n / visits) + bias;
+    if (value > best_value) {
+      best_value = value;
+      best = node.first_child + i;
+    }
+  }
+  m_tree[best].visits.fetch_add(1, std::memory_order_relaxed);
+  return best;
+}
+
+Sign Worker::playout() {
+  Bitboard &b = m_board;
+  while (!b.is_full()) {
+    const Sign side = b.get_current_player();
+    int idx = -1;
+    while (!b.get_frontier().empty()) {
+      const int pos = m_rng.below(b.get_frontier().size());
+      const int cell = b.get_frontier()[pos];
+      b.take_frontier(pos);
+      if (b.is_empty(cell)) {
+        idx = cell;
+        break;
+      }
+    }
+    for (int cell = 0; idx < 0 && cell < b.get_n_cells(); ++cell)
+      if (b.is_empty(cell))
+        idx = cell;
+    if (idx < 0)
+      break;
+    b.place(idx, side);
+    if (b.makes_line(idx, side)) {
+      if (side == Sign::O)
+        return Sign::O;
+      return b.has_line_cell(Sign::O) ? Sign::NONE : Sign::X;
+    }
+  }
+  return Sign::NONE;
+}
+
+// Copies the subtree of `src_root` breadth first, as far as `dst` has room.
+static int copy_subtree(MctsArena &src, int src_root, MctsArena &dst) {
+  auto copy_node = [](MctsNode &from, MctsNode &to) {
+    to.init(from.move, from.result, from.prior);
+    to.visits.store(from.visits.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+    to.score.store(from.score.load(std::memory_order_relaxed),
+                   std::memory_order_relaxed);
+  };
+  const int root = dst.allocate(1);
+  copy_node(src[src_root], dst[root]);
+  std::vector<std::pair<int, int>> queue = {{src_root, root}};
+  for (size_t head = 0; head < queue.size(); ++head) {
+    auto [from, to] = queue[head];
+    MctsNode &node = src[from];
+    if (node.state.load(std::memory_order_relaxed) != MctsNode::EXPANDED ||
+        node.n_children == 0)
+      continue;
+    const int first = dst.allocate(node.n_children);
+    if (first < 0)
+      continue;
+    for (int i = 0; i < node.n_children; ++i) {
+      copy_node(src[node.first_child + i], dst[first + i]);
+      queue.push_back({node.first_child + i, first + i});
+    }
+    dst[to].first_child = first;
+    dst[to].n_children = node.n_children;
+    dst[to].state.store(MctsNode::EXPANDED, std::memory_order_relaxed);
+  }
+  return root;
+}
+
+}; // namespace
+
+MctsEngine::MctsEngine(const MctsOpts &opts) : m_opts(opts) {}
+
+void MctsEngine::start_game(MctsContext &ctx, const State::Opts &opts,
+                            Sign sign) {
+  EngineBase::start_game(ctx, opts, sign);
+  if (!ctx.tree) {
+    ctx.tree = std::make_unique<MctsArena>();
+    ctx.spare = std::make_unique<MctsArena>();
+  }
+  ctx.tree->reserve(m_opts.arena_nodes);
+  ctx.spare->reserve(m_opts.arena_nodes);
+  ctx.cells_after_move.clear();
+  ctx.move_node = -1;
+  ctx.n_moves = 0;
+}
+
+int MctsEngine::find_root(MctsContext &ctx, const Bitboard &board) const {
+  const int n_cells = board.get_n_cells();
+  if (!m_opts.reuse_tree || ctx.move_node < 0 ||
+      int(ctx.cells_after_move.size()) != n_cells)
+    return -1;
+  // the opponent's reply must be the only change since our move
+  int reply = -1;
+  for (int idx = 0; idx < n_cells; ++idx) {
+    if (board.get(idx) == ctx.cells_after_move[idx])
+      continue;
+    if (ctx.cells_after_move[idx] != Sign::NONE || reply >= 0)
+      return -1;
+    reply = idx;
+  }
+  MctsArena &tree = *ctx.tree;
+  MctsNode &node = tree[ctx.move_node];
+  if (reply < 0 ||
+      node.state.load(std::memory_order_relaxed) != MctsNode::EXPANDED)
+    return -1;
+  for (int i = 0; i < node.n_children; ++i) {
+    if (tree[node.first_child + i].move != reply)
+      continue;
+    ctx.spare->reset();
+    const int root = copy_subtree(tree, node.first_child + i, *ctx.spare);
+    std::swap(ctx.tree, ctx.spare);
+    return root;
+  }
+  return -1;
+}
+
+Point MctsEngine::make_move(MctsContext &ctx, const State &state) {
+  const auto start = Clock::now();
+  const Bitboard board(state);
+  const int n_cells = board.get_n_cells();
+  const Sign side = board.get_current_player();
+
+  // players which missed `on_game_start` (e.g. with an older game loop)
+  if (!ctx.tree)
+    start_game(ctx, state.get_opts(), side);
+  ++ctx.n_moves;
+
+  MctsInfo info;
+  int best = -1;
+  if (state.get_status() == game::Status::LAST_MOVE) {
+    best = Board(state).get_last_move_reply();
+    ctx.move_node = -1;
+  } else {
+    int root = find_root(ctx, board);
+    MctsArena &tree = *ctx.tree;
+    if (root >= 0) {
+      info.reused_nodes = tree.get_used();
+    } else {
+      tree.reset();
+      root = tree.allocate(1);
+      tree[root].init(-1, -1);
+    }
+
+    int n_threads = m_opts.n_threads;
+    if (n_threads <= 0)
+      n_threads = std::max(1u, std::thread::hardware_concurrency());
+    // the same for the same game and move, whatever the thread count
+    const uint64_t seed =
+        derive_seed(derive_seed(ctx.seed, m_opts.seed), ctx.n_moves);
+    const auto deadline = start + std::chrono::milliseconds(m_opts.time_ms);
+    std::atomic<bool> stop{false};
+    std::atomic<long long> iterations{0};
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < n_threads; ++i) {
+      helpers.emplace_back([&, i] {
+        Worker worker(tree, board, root, m_opts, derive_seed(seed, i));
+        while (!stop.load(std::memory_order_relaxed))
+          worker.run_iteration();
+        iterations += worker.get_iterations();
+      });
+    }
+    Worker worker(tree, board, root, m_opts, seed);
+    MctsNode &root_node = tree[root];
+    while (Clock::now() < deadline) {
+      for (int i = 0; i < 64; ++i)
+        worker.run_iteration();
+      // a forced move needs no search
+      if (root_node.state.load(std::memory_order_acquire) ==
+              MctsNode::EXPANDED &&
+          root_node.n_children <= 1)
+        break;
+    }
+    stop = true;
+    for (auto &helper : helpers)
+      helper.join();
+    iterations += worker.get_iterations();
+
+    // the most visited child; a proven win goes first
+    int best_node = -1, best_visits = -1;
+    if (root_node.state.load(std::memory_order_acquire) == MctsNode::EXPANDED) {
+      for (int i = 0; i < root_node.n_children; ++i) {
+        MctsNode &child = tree[root_node.first_child + i];
+        const int visits = child.result == 2
+                               ? INT32_MAX
+                               : child.visits.load(std::memory_order_relaxed);
+        if (visits > best_visits) {
+          best_visits = visits;
+          best_node = root_node.first_child + i;
+        }
+      }
+    }
+    if (best_node >= 0) {
+      MctsNode &child = tree[best_node];
+      best = child.move;
+      const int visits = child.visits.load(std::memory_order_relaxed);
+      if (visits > 0)
+        info.win_rate = child.score.load(std::memory_order_relaxed) /
+                        (2.0 * visits);
+    }
+    ctx.move_node = best_node;
+    info.iterations = iterations;
+    info.n_threads = n_threads;
+    info.nodes = tree.get_used();
+  }
+  if (best < 0) {
+    for (int idx = 0; idx < n_cells && best < 0; ++idx)
+      if (board.is_empty(idx))
+        best = idx;
+  }
+
+  ctx.cells_after_move.resize(n_cells);
+  for (int idx = 0; idx < n_cells; ++idx)
+    ctx.cells_after_move[idx] = board.get(idx);
+  ctx.cells_after_move[best] = side;
+
+  info.time_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  info.best = board.point(best);
+  ctx.last_info = info;
+  if (m_opts.verbose) {
+    std::cerr << "move " << state.get_move_no() << ": (" << info.best.x << ", "
+              << info.best.y << ") iterations " << info.iterations
+              << " win rate " << info.win_rate << " nodes " << info.nodes
+              << " reused " << info.reused_nodes << '\n';
+  }
+  return info.best;
+}
+
+bool MctsEngine::get_move_stats(const MctsContext &ctx,
+                                MoveStats &stats) const {
+  const MctsInfo &info = ctx.last_info;
+  if (info.best.x < 0)
+    return false;
+  stats.nodes = info.iterations;
+  stats.search_ms = info.time_ms;
+  stats.time_ms = info.time_ms;
+  return true;
+}
+
+MctsPlayer::MctsPlayer(const char *name, const MctsOpts &opts)
+    : EngineContext(std::make_shared<MctsEngine>(opts), name) {}
+
+MctsPlayer::MctsPlayer(std::shared_ptr<MctsEngine> engine, const char *name)
+    : EngineContext(std::move(engine), name) {}
+
+}; // namespace ttt::my_player
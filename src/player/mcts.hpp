@@ -0,0 +1,150 @@
+#pragma once
+
+#include "bitboard.hpp"
+#include "engine.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ttt::my_player {
+
+struct MctsOpts {
+  int time_ms = 50;
+  // search threads per move; 0 uses all hardware threads
+  int n_threads = 0;
+  // tree nodes of one move; a context holds two arenas of this size
+  int arena_nodes = 1 << 19;
+  // UCT exploration constant for win rates in [0, 1]
+  double exploration = 0.7;
+  // visits of a leaf before its children are added
+  int expand_visits = 2;
+  // weight of the pattern score of a move in its UCT value, fading with
+  // visits (progressive bias); 0 disables
+  double prior_weight = 4.0;
+  // keep the subtree under the played moves for the next move
+  bool reuse_tree = true;
+  // mixed into the seed of every game (see `get_game_seed`)
+  uint64_t seed = 0;
+  // print iterations and win rate of every move to stderr
+  bool verbose = false;
+};
+
+// Result of one `make_move` search.
+struct MctsInfo {
+  long long iterations = 0;
+  int n_threads = 0;
+  // nodes in the arena after the search and nodes kept from the last move
+  int nodes = 0;
+  int reused_nodes = 0;
+  double win_rate = 0;
+  double time_ms = 0;
+  Point best = {-1, -1};
+
+  double get_ips() const { return time_ms > 0 ? iterations / time_ms * 1000 : 0; }
+};
+
+// Tree node. Statistics are from the side which made the move into the node:
+// `score` gets 2 for a win and 1 for a draw. Visits are counted on the way
+// down, so a playout in flight is a virtual loss which steers other threads
+// to other children. Children are a contiguous block of the arena,
+// published by `state`.
+struct MctsNode {
+  enum : uint8_t { LEAF, EXPANDING, EXPANDED };
+  static const int PRIOR_SCALE = 1000;
+
+  std::atomic<int32_t> visits;
+  std::atomic<int32_t> score;
+  std::atomic<uint8_t> state;
+  int32_t first_child;
+  int16_t n_children;
+  int16_t move;
+  // pattern score of the move relative to its siblings, 0..PRIOR_SCALE
+  int16_t prior;
+  // score of a terminal node (0, 1 or 2), -1 otherwise
+  int8_t result;
+
+  void init(int idx, int terminal_result, int move_prior = 0) {
+    visits.store(0, std::memory_order_relaxed);
+    score.store(0, std::memory_order_relaxed);
+    state.store(LEAF, std::memory_order_relaxed);
+    first_child = -1;
+    n_children = 0;
+    move = idx;
+    prior = move_prior;
+    result = terminal_result;
+  }
+};
+
+// Fixed-size node storage; allocation is a single atomic add.
+class MctsArena {
+  std::unique_ptr<MctsNode[]> m_nodes;
+  int m_capacity = 0;
+  std::atomic<int> m_used{0};
+
+public:
+  void reserve(int capacity);
+  void reset() { m_used.store(0, std::memory_order_relaxed); }
+  int get_capacity() const { return m_capacity; }
+  int get_used() const {
+    return std::min(m_used.load(std::memory_order_relaxed), m_capacity);
+  }
+  bool is_full() const {
+    return m_used.load(std::memory_order_relaxed) >= m_capacity;
+  }
+
+  // First index of `n` new nodes or -1 when the arena is full.
+  int allocate(int n) {
+    const int first = m_used.fetch_add(n, std::memory_order_relaxed);
+    return first + n <= m_capacity ? first : -1;
+  }
+  MctsNode &operator[](int idx) { return m_nodes[idx]; }
+};
+
+struct MctsContext : GameContext {
+  // the tree of the current move and the spare one the kept subtree is
+  // copied to
+  std::unique_ptr<MctsArena> tree, spare;
+  // the position after our last move and its node, to find the opponent's
+  // reply in the tree
+  std::vector<Sign> cells_after_move;
+  int move_node = -1;
+  int n_moves = 0;
+  MctsInfo last_info;
+};
+
+// Parallel Monte-Carlo tree search. All threads share one tree without
+// locks: a leaf is expanded by the thread which wins a compare-and-swap on
+// its state, the others keep doing playouts meanwhile. Children of a node are
+// the empty cells next to stones, or only the winning or blocking cells when
+// a line can be completed; pattern scores of the moves bias the selection
+// while a child has few visits. Playouts play random frontier cells on a
+// `Bitboard` with a per-thread generator.
+class MctsEngine : public EngineBase<MctsContext> {
+  MctsOpts m_opts;
+
+public:
+  MctsEngine(const MctsOpts &opts = MctsOpts());
+
+  const MctsOpts &get_opts() const { return m_opts; }
+
+  void start_game(MctsContext &ctx, const State::Opts &opts, Sign sign);
+  Point make_move(MctsContext &ctx, const State &state);
+  // Playouts count as nodes; the tree has no depth limit or table.
+  bool get_move_stats(const MctsContext &ctx, MoveStats &stats) const;
+
+private:
+  int find_root(MctsContext &ctx, const Bitboard &board) const;
+};
+
+class MctsPlayer : public EngineContext<MctsEngine> {
+public:
+  MctsPlayer(const char *name, const MctsOpts &opts = MctsOpts());
+  MctsPlayer(std::shared_ptr<MctsEngine> engine, const char *name);
+
+  const MctsInfo &get_last_info() { return get_context().last_info; }
+};
+
+}; // namespace ttt::my_player
@@ -1,12 +1,24 @@
 #include "my_player.hpp"
-#include <cstdlib>
 
 namespace ttt::my_player {
 
-void MyPlayer::set_sign(Sign sign) { m_sign = sign; }
-const char *MyPlayer::get_name() const { return m_name; }
+static std::shared_ptr<MyEngine> get_default_engine() {
+  static std::shared_ptr<MyEngine> engine = std::make_shared<MyEngine>();
+  return engine;
+}
+
+MyPlayer::MyPlayer(const char *name) : MyPlayer(get_default_engine(), name) {}
+
+MyPlayer::MyPlayer(std::shared_ptr<MyEngine> engine, const char *name)
+    : EngineContext(std::move(engine), name) {}
+
+void MyEngine::start_game(MyContext &ctx, const State::Opts &opts,
+                          Sign sign) {
+  EngineBase::start_game(ctx, opts, sign);
+  ctx.rng.seed(ctx.seed);
+}
 
-Point MyPlayer::make_move(const State &state) {
+Point MyEngine::make_move(MyContext &ctx, const State &state) {
   Point result;
   if (state.get_move_no() == 0) {
     result.x = state.get_opts().cols / 2;
@@ -14,8 +26,8 @@ Point MyPlayer::make_move(const State &state) {
     return result;
   }
   for (int n_attempt = 0; n_attempt < 10; ++n_attempt) {
-    result.x = std::rand() % state.get_opts().cols;
-    result.y = std::rand() % state.get_opts().rows;
+    result.x = ctx.rng.below(state.get_opts().cols);
+    result.y = ctx.rng.below(state.get_opts().rows);
     if (state.get_value(result.x, result.y) != Sign::NONE) {
       --n_attempt;
       continue;
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "core/game.hpp"
+#include "engine.hpp"
+
+#include <memory>
 
 namespace ttt::my_player {
 
@@ -10,15 +13,23 @@ using game::Point;
 using game::Sign;
 using game::State;
 
-class MyPlayer : public IPlayer {
-  Sign m_sign = Sign::NONE;
-  const char *m_name;
+struct MyContext : GameContext {
+  Rng rng;
+};
+
+// Plays a random free cell next to an existing mark. Keeps no data between
+// calls, so one instance serves any number of games; the random moves come
+// from the context, seeded per game.
+class MyEngine : public EngineBase<MyContext> {
+public:
+  void start_game(MyContext &ctx, const State::Opts &opts, Sign sign);
+  Point make_move(MyContext &ctx, const State &state);
+};
 
+class MyPlayer : public EngineContext<MyEngine> {
 public:
-  MyPlayer(const char *name) : m_sign(Sign::NONE), m_name(name) {}
-  void set_sign(Sign sign) override;
-  Point make_move(const State &game) override;
-  const char *get_name() const override;
+  MyPlayer(const char *name);
+  MyPlayer(std::shared_ptr<MyEngine> engine, const char *name);
 };
 
 }; // namespace ttt::my_player
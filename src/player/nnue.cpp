@@ -0,0 +1,204 @@
+#include "nnue.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace ttt::my_player {
+
+NnueNetwork::NnueNetwork(const State::Opts &opts, int n_hidden)
+    : m_rows(opts.rows), m_cols(opts.cols), m_win_len(opts.win_len) {
+  m_n_hidden = (std::max(n_hidden, 1) + HIDDEN_STEP - 1) / HIDDEN_STEP *
+               HIDDEN_STEP;
+  m_feature_weights.assign(size_t(get_n_features()) * m_n_hidden, 0);
+  m_biases.assign(m_n_hidden, 0);
+  m_output_weights.assign(2 * m_n_hidden, 0);
+}
+
+int NnueNetwork::get_weight_limit(int n_cells) {
+  return std::min(QA, (INT16_MAX - BIAS_LIMIT) / std::max(n_cells, 1));
+}
+
+bool NnueNetwork::fits_accumulator() const {
+  // each cell adds one of its two features, seen from either side
+  for (int i = 0; i < m_n_hidden; ++i) {
+    int bound = std::abs(int(m_biases[i]));
+    for (int idx = 0; idx < m_rows * m_cols; ++idx)
+      bound += std::max(std::abs(int(get_feature_weights(2 * idx)[i])),
+                        std::abs(int(get_feature_weights(2 * idx + 1)[i])));
+    if (bound > INT16_MAX)
+      return false;
+  }
+  return true;
+}
+
+bool NnueNetwork::supports(const State::Opts &opts) const {
+  return is_loaded() && opts.rows == m_rows && opts.cols == m_cols &&
+         opts.win_len == m_win_len;
+}
+
+bool NnueNetwork::load(const std::string &path) {
+  using namespace nnue_format;
+  std::ifstream in(path, std::ios::binary);
+  Header header;
+  if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      header.version != VERSION || header.n_hidden == 0 ||
+      header.n_hidden % HIDDEN_STEP != 0 || header.rows * header.cols == 0)
+    return false;
+
+  NnueNetwork network({int(header.rows), int(header.cols),
+                       int(header.win_len), 0},
+                      header.n_hidden);
+  auto read = [&in](std::vector<int16_t> &values) {
+    return bool(in.read(reinterpret_cast<char *>(values.data()),
+                        values.size() * sizeof(int16_t)));
+  };
+  if (!read(network.m_feature_weights) || !read(network.m_biases) ||
+      !read(network.m_output_weights) || !network.fits_accumulator())
+    return false;
+  network.m_output_bias = header.output_bias;
+  *this = std::move(network);
+  return true;
+}
+
+bool NnueNetwork::save(const std::string &path) const {
+  using namespace nnue_format;
+  Header header = {};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.rows = m_rows;
+  header.cols = m_cols;
+  header.win_len = m_win_len;
+  header.n_hidden = m_n_hidden;
+  header.output_bias = m_output_bias;
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  auto write = [&out](const std::vector<int16_t> &values) {
+    out.write(reinterpret_cast<const char *>(values.data()),
+              values.size() * sizeof(int16_t));
+  };
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  write(m_feature_weights);
+  write(m_biases);
+  write(m_output_weights);
+  return bool(out);
+}
+
+NnueAccumulator::NnueAccumulator(const NnueNetwork &network)
+    : m_network(&network),
+      m_cells(network.get_rows() * network.get_cols(), Sign::NONE) {
+  for (auto &values : m_values)
+    values = network.get_biases();
+}
+
+void NnueAccumulator::set(int idx, Sign sign) {
+  if (m_cells[idx] == sign)
+    return;
+  if (m_cells[idx] != Sign::NONE)
+    add_features(idx, m_cells[idx], false);
+  if (sign != Sign::NONE)
+    add_features(idx, sign, true);
+  m_cells[idx] = sign;
+}
+
+void NnueAccumulator::add_features(int idx, Sign sign, bool add) {
+  const int n = m_network->get_n_hidden();
+  for (int side = 0; side < 2; ++side) {
+    // own marks are the even features of each side
+    const bool own = (sign == Sign::X) == (side == 0);
+    const int16_t *w = m_network->get_feature_weights(2 * idx + (own ? 0 : 1));
+    int16_t *v = m_values[side].data();
+#if defined(__AVX2__)
+    for (int i = 0; i < n; i += 16) {
+      const __m256i a = _mm256_loadu_si256((const __m256i *)(v + i));
+      const __m256i b = _mm256_loadu_si256((const __m256i *)(w + i));
+      _mm256_storeu_si256((__m256i *)(v + i), add ? _mm256_add_epi16(a, b)
+                                                  : _mm256_sub_epi16(a, b));
+    }
+#elif defined(__SSE2__)
+    for (int i = 0; i < n; i += 8) {
+      const __m128i a = _mm_loadu_si128((const __m128i *)(v + i));
+      const __m128i b = _mm_loadu_si128((const __m128i *)(w + i));
+      _mm_storeu_si128((__m128i *)(v + i),
+                       add ? _mm_add_epi16(a, b) : _mm_sub_epi16(a, b));
+    }
+#else
+    for (int i = 0; i < n; ++i)
+      v[i] = int16_t(add ? v[i] + w[i] : v[i] - w[i]);
+#endif
+  }
+}
+
+// Output sum in network units times `QA * QB` scaled to evaluation units.
+static int scale_output(int64_t sum) {
+  return int(sum * NnueNetwork::EVAL_SCALE /
+             (NnueNetwork::QA * NnueNetwork::QB));
+}
+
+int NnueAccumulator::evaluate(Sign side) const {
+  const int n = m_network->get_n_hidden();
+  const int16_t *weights = m_network->get_output_weights().data();
+  const int16_t *values[2] = {get_values(side), get_values(side == Sign::X
+                                                               ? Sign::O
+                                                               : Sign::X)};
+  int sum = 0;
+#if defined(__AVX2__)
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i qa = _mm256_set1_epi16(NnueNetwork::QA);
+  __m256i acc = _mm256_setzero_si256();
+  for (int s = 0; s < 2; ++s)
+    for (int i = 0; i < n; i += 16) {
+      __m256i v = _mm256_loadu_si256((const __m256i *)(values[s] + i));
+      v = _mm256_min_epi16(_mm256_max_epi16(v, zero), qa);
+      const __m256i w =
+          _mm256_loadu_si256((const __m256i *)(weights + s * n + i));
+      acc = _mm256_add_epi32(acc, _mm256_madd_epi16(v, w));
+    }
+  __m128i acc4 = _mm_add_epi32(_mm256_castsi256_si128(acc),
+                               _mm256_extracti128_si256(acc, 1));
+  acc4 = _mm_add_epi32(acc4, _mm_shuffle_epi32(acc4, 0x4e));
+  acc4 = _mm_add_epi32(acc4, _mm_shuffle_epi32(acc4, 0xb1));
+  sum = _mm_cvtsi128_si32(acc4);
+#elif defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i qa = _mm_set1_epi16(NnueNetwork::QA);
+  __m128i acc = _mm_setzero_si128();
+  for (int s = 0; s < 2; ++s)
+    for (int i = 0; i < n; i += 8) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(values[s] + i));
+      v = _mm_min_epi16(_mm_max_epi16(v, zero), qa);
+      const __m128i w = _mm_loadu_si128((const __m128i *)(weights + s * n + i));
+      acc = _mm_add_epi32(acc, _mm_madd_epi16(v, w));
+    }
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4e));
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xb1));
+  sum = _mm_cvtsi128_si32(acc);
+#else
+  return evaluate_scalar(side);
+#endif
+  return scale_output(int64_t(sum) + m_network->get_output_bias());
+}
+
+int NnueAccumulator::evaluate_scalar(Sign side) const {
+  const int n = m_network->get_n_hidden();
+  const int16_t *weights = m_network->get_output_weights().data();
+  const int16_t *values[2] = {get_values(side), get_values(side == Sign::X
+                                                               ? Sign::O
+                                                               : Sign::X)};
+  int64_t sum = m_network->get_output_bias();
+  for (int s = 0; s < 2; ++s)
+    for (int i = 0; i < n; ++i) {
+      const int v = std::clamp<int>(values[s][i], 0, NnueNetwork::QA);
+      sum += v * weights[s * n + i];
+    }
+  return scale_output(sum);
+}
+
+}; // namespace ttt::my_player
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "core/game.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ttt::my_player {
+
+using game::Sign;
+using game::State;
+
+// Layout of a network file: a header and the quantized weights in the order
+// of `NnueNetwork`'s members, all little-endian.
+namespace nnue_format {
+
+const char MAGIC[8] = {'T', 'T', 'T', 'N', 'N', 'U', 'E', '\0'};
+const uint32_t VERSION = 1;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t rows, cols, win_len;
+  uint32_t n_hidden;
+  int32_t output_bias;
+  uint32_t reserved[2];
+};
+
+static_assert(sizeof(Header) == 40);
+
+}; // namespace nnue_format
+
+// A small network scoring a position for the side to move. The inputs are
+// one feature per cell and sign, seen from each side: feature `2 * idx` is a
+// mark of that side on the cell and `2 * idx + 1` one of the opponent. The
+// first layer maps the features of each side to `n_hidden` values (the
+// accumulators); the accumulators of the side to move and of the opponent
+// are clipped to [0, QA] and their weighted sum is the score. The weights
+// are fixed point: the first layer is scaled by `QA`, the output by `QB`,
+// and `evaluate` scales the result to `EVAL_SCALE` per unit of the float
+// network, about the range of the pattern evaluation.
+class NnueNetwork {
+public:
+  static constexpr int QA = 127;
+  static constexpr int QB = 64;
+  // largest bias of the first layer
+  static constexpr int BIAS_LIMIT = 4 * QA;
+  static constexpr int EVAL_SCALE = 1000;
+  // the accumulator is processed in whole AVX2 registers
+  static constexpr int HIDDEN_STEP = 16;
+
+  NnueNetwork() = default;
+  // Zero weights for these options; `n_hidden` is rounded up to
+  // `HIDDEN_STEP`.
+  NnueNetwork(const State::Opts &opts, int n_hidden);
+
+  // Largest first-layer weight for boards of `n_cells` cells, so that the
+  // accumulators of a full board stay within int16_t.
+  static int get_weight_limit(int n_cells);
+
+  // False if the file is missing or not a valid network, also if the
+  // accumulators of some board could overflow.
+  bool load(const std::string &path);
+  bool save(const std::string &path) const;
+  bool is_loaded() const { return m_n_hidden > 0; }
+  // True if the network was made for boards with these options.
+  bool supports(const State::Opts &opts) const;
+
+  int get_rows() const { return m_rows; }
+  int get_cols() const { return m_cols; }
+  int get_win_len() const { return m_win_len; }
+  int get_n_hidden() const { return m_n_hidden; }
+  int get_n_features() const { return 2 * m_rows * m_cols; }
+
+  // first layer: `n_features` rows of `n_hidden` weights and the biases
+  int16_t *get_feature_weights(int feature) {
+    return &m_feature_weights[size_t(feature) * m_n_hidden];
+  }
+  const int16_t *get_feature_weights(int feature) const {
+    return &m_feature_weights[size_t(feature) * m_n_hidden];
+  }
+  std::vector<int16_t> &get_biases() { return m_biases; }
+  const std::vector<int16_t> &get_biases() const { return m_biases; }
+  // output: weights of the side to move, then of the opponent
+  std::vector<int16_t> &get_output_weights() { return m_output_weights; }
+  const std::vector<int16_t> &get_output_weights() const {
+    return m_output_weights;
+  }
+  int32_t get_output_bias() const { return m_output_bias; }
+  void set_output_bias(int32_t bias) { m_output_bias = bias; }
+
+private:
+  // True if no board takes an accumulator beyond int16_t.
+  bool fits_accumulator() const;
+
+  int m_rows = 0, m_cols = 0, m_win_len = 0;
+  int m_n_hidden = 0;
+  std::vector<int16_t> m_feature_weights;
+  std::vector<int16_t> m_biases;
+  std::vector<int16_t> m_output_weights;
+  int32_t m_output_bias = 0;
+};
+
+// Accumulators of a position for both sides, updated with one row of the
+// first layer per side when a mark is placed or removed, so that a leaf
+// costs only the output layer.
+class NnueAccumulator {
+public:
+  // The network must outlive the accumulator and support the options.
+  NnueAccumulator(const NnueNetwork &network);
+
+  // Places a mark or, with `Sign::NONE`, clears the cell.
+  void set(int idx, Sign sign);
+
+  int evaluate(Sign side) const;
+  // The same without SIMD, for tests.
+  int evaluate_scalar(Sign side) const;
+  const int16_t *get_values(Sign side) const {
+    return m_values[side == Sign::X ? 0 : 1].data();
+  }
+
+private:
+  void add_features(int idx, Sign sign, bool add);
+
+  const NnueNetwork *m_network;
+  std::vector<Sign> m_cells;
+  // accumulators as seen by X and by O
+  std::vector<int16_t> m_values[2];
+};
+
+}; // namespace ttt::my_player
@@ -0,0 +1,215 @@
+#include "nnue_trainer.hpp"
+#include "board.hpp"
+#include "rng.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+
+namespace ttt::my_player {
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// A position as features of the side to move; the opponent's features are
+// the same with the lowest bit flipped.
+struct Sample {
+  std::vector<int16_t> features;
+  float target;
+};
+
+double sigmoid(double x) { return 1 / (1 + std::exp(-x)); }
+
+// Plays one game with a random move among the best few by static gain and
+// appends its positions.
+void play_game(const State::Opts &opts, const NnueTrainOpts &train_opts,
+               Rng &rng, std::vector<Sample> &samples) {
+  Board board(opts);
+  board.enable_patterns();
+  const size_t first = samples.size();
+  std::vector<Sign> sides;
+  Sign winner = Sign::NONE;
+  std::vector<std::pair<int, int>> moves;
+  while (!board.is_full()) {
+    const Sign side = board.get_current_player();
+    moves.clear();
+    for (int idx = 0; idx < board.get_n_cells(); ++idx)
+      if (board.is_candidate(idx))
+        moves.push_back({board.get_move_gain(idx, side), idx});
+    if (moves.empty())
+      moves.push_back({0, board.index(rng.below(board.get_cols()),
+                                      rng.below(board.get_rows()))});
+    std::sort(moves.rbegin(), moves.rend());
+
+    Sample sample;
+    for (int idx = 0; idx < board.get_n_cells(); ++idx)
+      if (!board.is_empty(idx))
+        sample.features.push_back(2 * idx + (board.at(idx) == side ? 0 : 1));
+    const int eval = board.get_patterns()->evaluate(side);
+    sample.target = float(sigmoid(double(eval) / NnueNetwork::EVAL_SCALE));
+    samples.push_back(std::move(sample));
+    sides.push_back(side);
+
+    // mostly among the best three, sometimes anywhere near the marks
+    const size_t n =
+        rng.below(8) == 0 ? moves.size() : std::min<size_t>(3, moves.size());
+    const int idx = moves[rng.below(n)].second;
+    if (board.completes_line(idx, side)) {
+      winner = side;
+      break;
+    }
+    board.place(idx);
+  }
+  const float weight = float(train_opts.result_weight);
+  for (size_t i = first; i < samples.size(); ++i) {
+    const Sign side = sides[i - first];
+    const float result = winner == Sign::NONE ? 0.5f : winner == side ? 1 : 0;
+    samples[i].target = (1 - weight) * samples[i].target + weight * result;
+  }
+}
+
+// The float network being trained, laid out as `NnueNetwork`.
+struct FloatNetwork {
+  int n_hidden;
+  // bound of the feature weights, in network units
+  int weight_limit;
+  std::vector<float> feature_weights, biases, output_weights;
+  float output_bias = 0;
+
+  FloatNetwork(int n_features, int n_hidden, Rng &rng)
+      : n_hidden(n_hidden),
+        weight_limit(NnueNetwork::get_weight_limit(n_features / 2)),
+        feature_weights(size_t(n_features) * n_hidden),
+        biases(n_hidden, 0.5f), output_weights(2 * n_hidden) {
+    std::uniform_real_distribution<float> dist(-0.1f, 0.1f);
+    for (float &w : feature_weights)
+      w = dist(rng);
+    for (float &w : output_weights)
+      w = dist(rng);
+  }
+
+  // One step of stochastic gradient descent; returns the squared error.
+  double train(const Sample &sample, float rate, std::vector<float> &values) {
+    // accumulators of the side to move and the opponent
+    values.assign(2 * n_hidden, 0);
+    for (int s = 0; s < 2; ++s) {
+      float *v = &values[s * n_hidden];
+      std::copy(biases.begin(), biases.end(), v);
+      for (int16_t f : sample.features) {
+        const float *w = &feature_weights[size_t(f ^ s) * n_hidden];
+        for (int i = 0; i < n_hidden; ++i)
+          v[i] += w[i];
+      }
+    }
+    double out = output_bias;
+    for (int i = 0; i < 2 * n_hidden; ++i)
+      out += output_weights[i] * std::clamp(values[i], 0.0f, 1.0f);
+    const double p = sigmoid(out);
+    const double error = p - sample.target;
+    const float grad = float(2 * error * p * (1 - p)) * rate;
+
+    output_bias -= grad;
+    // bounded so that the quantized accumulator cannot overflow
+    const float limit = float(weight_limit) / NnueNetwork::QA;
+    for (int s = 0; s < 2; ++s) {
+      const float *v = &values[s * n_hidden];
+      float *out_w = &output_weights[s * n_hidden];
+      for (int i = 0; i < n_hidden; ++i) {
+        // the gradient passes the clipping only inside (0, 1)
+        const float g = v[i] > 0 && v[i] < 1 ? grad * out_w[i] : 0;
+        out_w[i] -= grad * std::clamp(v[i], 0.0f, 1.0f);
+        biases[i] -= g;
+        if (g == 0)
+          continue;
+        for (int16_t f : sample.features) {
+          float *w = &feature_weights[size_t(f ^ s) * n_hidden];
+          w[i] = std::clamp(w[i] - g, -limit, limit);
+        }
+      }
+    }
+    return error * error;
+  }
+
+  void quantize(NnueNetwork &network) const {
+    auto round = [](float value, int scale, int limit) {
+      return int16_t(std::clamp<long>(std::lround(value * scale), -limit,
+                                      limit));
+    };
+    for (int f = 0; f < network.get_n_features(); ++f)
+      for (int i = 0; i < n_hidden; ++i)
+        network.get_feature_weights(f)[i] = round(
+            feature_weights[size_t(f) * n_hidden + i], NnueNetwork::QA,
+            weight_limit);
+    for (int i = 0; i < n_hidden; ++i)
+      network.get_biases()[i] =
+          round(biases[i], NnueNetwork::QA, NnueNetwork::BIAS_LIMIT);
+    for (int i = 0; i < 2 * n_hidden; ++i)
+      network.get_output_weights()[i] =
+          round(output_weights[i], NnueNetwork::QB, 32767);
+    network.set_output_bias(
+        int32_t(std::lround(output_bias * NnueNetwork::QA * NnueNetwork::QB)));
+  }
+};
+
+}; // namespace
+
+NnueNetwork train_nnue(const State::Opts &opts, const NnueTrainOpts &train_opts,
+                       std::ostream *log) {
+  NnueNetwork network(opts, train_opts.n_hidden);
+  const auto start = Clock::now();
+  auto seconds = [&start] {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  };
+
+  const int n_threads =
+      train_opts.n_threads > 0
+          ? train_opts.n_threads
+          : int(std::max(1u, std::thread::hardware_concurrency()));
+  std::vector<std::vector<Sample>> shards(n_threads);
+  std::atomic<int> n_positions{0};
+  auto worker = [&](int id) {
+    Rng rng(derive_seed(train_opts.seed, id));
+    while (n_positions < train_opts.positions) {
+      const size_t before = shards[id].size();
+      play_game(opts, train_opts, rng, shards[id]);
+      n_positions += int(shards[id].size() - before);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int t = 1; t < n_threads; ++t)
+    threads.emplace_back(worker, t);
+  worker(0);
+  for (auto &thread : threads)
+    thread.join();
+
+  std::vector<Sample> samples;
+  for (auto &shard : shards)
+    for (auto &sample : shard)
+      samples.push_back(std::move(sample));
+  if (log)
+    *log << samples.size() << " positions in " << seconds() << " s\n";
+
+  Rng rng(train_opts.seed);
+  FloatNetwork net(network.get_n_features(), network.get_n_hidden(), rng);
+  std::vector<float> values;
+  for (int epoch = 0; epoch < train_opts.epochs; ++epoch) {
+    std::shuffle(samples.begin(), samples.end(), rng);
+    // halved every epoch
+    const float rate = float(train_opts.learning_rate / (1 << epoch));
+    double loss = 0;
+    for (const Sample &sample : samples)
+      loss += net.train(sample, rate, values);
+    if (log)
+      *log << "epoch " << epoch + 1 << ": loss "
+           << loss / std::max<size_t>(1, samples.size()) << ", " << seconds()
+           << " s\n";
+  }
+  net.quantize(network);
+  return network;
+}
+
+}; // namespace ttt::my_player
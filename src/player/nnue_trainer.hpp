@@ -0,0 +1,32 @@
+#pragma once
+
+#include "nnue.hpp"
+
+#include <cstdint>
+#include <ostream>
+
+namespace ttt::my_player {
+
+struct NnueTrainOpts {
+  int n_hidden = 32;
+  // positions sampled from games of a randomized greedy policy
+  int positions = 200000;
+  int epochs = 4;
+  double learning_rate = 0.05;
+  // weight of the game result in the target, the rest is the pattern
+  // evaluation of the position
+  double result_weight = 0.25;
+  // threads generating positions; 0 uses all hardware threads
+  int n_threads = 0;
+  uint64_t seed = 1;
+};
+
+// Trains a network for these options in float, then quantizes it. The
+// targets are the pattern evaluation (see `PatternEvaluator`) squashed by a
+// sigmoid, mixed with the result of the game the position comes from; the
+// loss is the squared error of the sigmoid of the output. Progress goes to
+// `log` if given.
+NnueNetwork train_nnue(const State::Opts &opts, const NnueTrainOpts &train_opts,
+                       std::ostream *log = nullptr);
+
+}; // namespace ttt::my_player
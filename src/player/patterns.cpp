@@ -0,0 +1,231 @@
+#include "patterns.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace ttt::my_player {
+
+static const int directions[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+
+const PatternTable &PatternTable::get(int win_len) {
+  static std::once_flag flags[MAX_WIN_LEN + 1];
+  static std::unique_ptr<PatternTable> tables[MAX_WIN_LEN + 1];
+  std::call_once(flags[win_len],
+                 [win_len] { tables[win_len].reset(new PatternTable(win_len)); });
+  return *tables[win_len];
+}
+
+int PatternTable::shape_score(Shape shape) {
+  static const int scores[] = {0, 1, 8, 60, 400, 500, 3000, 8000};
+  return scores[int(shape)];
+}
+
+PatternTable::PatternTable(int win_len) : m_win_len(win_len) {
+  const int n_neighbors = get_n_neighbors();
+  m_pow3.resize(n_neighbors + 1);
+  m_pow3[0] = 1;
+  for (int i = 1; i <= n_neighbors; ++i)
+    m_pow3[i] = m_pow3[i - 1] * 3;
+  const uint32_t n_codes = m_pow3[n_neighbors];
+  m_shapes.resize(n_codes);
+  m_scores.resize(n_codes);
+
+  std::vector<uint8_t> line(2 * win_len - 1);
+  for (uint32_t code = 0; code < n_codes; ++code) {
+    uint32_t rest = code;
+    for (int pos = 0; pos < n_neighbors; ++pos, rest /= 3)
+      line[pos < win_len - 1 ? pos : pos + 1] = rest % 3;
+    line[win_len - 1] = 1;
+    m_shapes[code] = classify(line);
+    m_scores[code] = shape_score(m_shapes[code]);
+  }
+}
+
+bool PatternTable::is_line(const std::vector<uint8_t> &line) const {
+  const int center = m_win_len - 1;
+  int run = 1;
+  for (int i = center - 1; i >= 0 && line[i] == 1; --i)
+    ++run;
+  for (int i = center + 1; i < int(line.size()) && line[i] == 1; ++i)
+    ++run;
+  return run >= m_win_len;
+}
+
+int PatternTable::count_line_cells(std::vector<uint8_t> &line) const {
+  int count = 0;
+  for (auto &cell : line) {
+    if (cell != 0)
+      continue;
+    cell = 1;
+    count += is_line(line);
+    cell = 0;
+  }
+  return count;
+}
+
+Shape PatternTable::classify(std::vector<uint8_t> &line) const {
+  if (is_line(line))
+    return Shape::FIVE;
+  const int n_line_cells = count_line_cells(line);
+  if (n_line_cells >= 2)
+    return Shape::OPEN_FOUR;
+  if (n_line_cells == 1)
+    return Shape::FOUR;
+
+  Shape best = Shape::NONE;
+  for (auto &cell : line) {
+    if (cell != 0)
+      continue;
+    cell = 1;
+    const int n = count_line_cells(line);
+    cell = 0;
+    if (n >= 2)
+      return Shape::OPEN_THREE;
+    if (n == 1)
+      best = Shape::THREE;
+  }
+  if (best != Shape::NONE)
+    return best;
+
+  // the fullest window through the center free of blocked cells
+  int max_own = -1;
+  for (int start = 0; start + m_win_len <= int(line.size()); ++start) {
+    int own = 0;
+    bool blocked = false;
+    for (int i = start; i < start + m_win_len; ++i) {
+      own += line[i] == 1;
+      blocked |= line[i] == 2;
+    }
+    if (!blocked)
+      max_own = std::max(max_own, own);
+  }
+  if (max_own < 0)
+    return Shape::NONE;
+  return max_own >= m_win_len - 3 ? Shape::TWO : Shape::ONE;
+}
+
+int PatternTable::get_cell_score(const uint32_t codes[4]) const {
+  int score = 0, n_fours = 0, n_threes = 0;
+  for (int dir = 0; dir < 4; ++dir) {
+    const Shape shape = m_shapes[codes[dir]];
+    score += m_scores[codes[dir]];
+    n_fours += shape >= Shape::FOUR;
+    n_threes += shape == Shape::OPEN_THREE;
+  }
+  // two threats at once can not both be blocked
+  if (n_fours >= 2 || (n_fours == 1 && n_threes >= 1))
+    score += 2000;
+  else if (n_threes >= 2)
+    score += 1000;
+  return std::min(score, 32767);
+}
+
+PatternEvaluator::PatternEvaluator(const State::Opts &opts)
+    : m_table(&PatternTable::get(opts.win_len)), m_rows(opts.rows),
+      m_cols(opts.cols), m_n_cells(opts.rows * opts.cols) {
+  const int len = opts.win_len;
+  m_cells.assign(m_n_cells, Sign::NONE);
+  // cells outside of the board are blocked for both signs
+  for (auto &codes : m_codes) {
+    codes.assign(4 * m_n_cells, 0);
+    for (int y = 0; y < m_rows; ++y)
+      for (int x = 0; x < m_cols; ++x)
+        for (int dir = 0; dir < 4; ++dir) {
+          uint32_t code = 0;
+          for (int pos = 0; pos < 2 * (len - 1); ++pos) {
+            const int offset = pos < len - 1 ? pos - (len - 1) : pos - len + 2;
+            const int nx = x + offset * directions[dir][0];
+            const int ny = y + offset * directions[dir][1];
+            if (nx < 0 || nx >= m_cols || ny < 0 || ny >= m_rows)
+              code += 2 * m_table->get_pow3(pos);
+          }
+          codes[4 * (x + y * m_cols) + dir] = code;
+        }
+  }
+  // padded to whole AVX2 registers
+  m_scores.assign((2 * m_n_cells + 15) / 16 * 16, 0);
+  for (int idx = 0; idx < m_n_cells; ++idx)
+    update_score(idx);
+}
+
+void PatternEvaluator::update_score(int idx) {
+  for (int si = 0; si < 2; ++si)
+    m_scores[2 * idx + si] =
+        m_cells[idx] == Sign::NONE
+            ? m_table->get_cell_score(&m_codes[si][4 * idx])
+            : 0;
+}
+
+void PatternEvaluator::set(int idx, Sign sign) {
+  const Sign old = m_cells[idx];
+  if (old == sign)
+    return;
+  m_cells[idx] = sign;
+  // digit of a cell for X and for O
+  auto digit = [](Sign s, int si) {
+    return s == Sign::NONE ? 0 : (s == Sign::X) == (si == 0) ? 1 : 2;
+  };
+  const int deltas[2] = {digit(sign, 0) - digit(old, 0),
+                         digit(sign, 1) - digit(old, 1)};
+
+  const int len = m_table->get_win_len();
+  const int x = idx % m_cols, y = idx / m_cols;
+  for (int dir = 0; dir < 4; ++dir) {
+    for (int k = -(len - 1); k <= len - 1; ++k) {
+      if (k == 0)
+        continue;
+      const int nx = x + k * directions[dir][0];
+      const int ny = y + k * directions[dir][1];
+      if (nx < 0 || nx >= m_cols || ny < 0 || ny >= m_rows)
+        continue;
+      // the cell is at offset -k from its neighbour
+      const int pos = -k < 0 ? -k + len - 1 : -k + len - 2;
+      const int n = nx + ny * m_cols;
+      for (int si = 0; si < 2; ++si)
+        m_codes[si][4 * n + dir] += deltas[si] * int(m_table->get_pow3(pos));
+      update_score(n);
+    }
+  }
+  update_score(idx);
+}
+
+int PatternEvaluator::evaluate(Sign side) const {
+  const int16_t *scores = m_scores.data();
+  const size_t size = m_scores.size();
+  int sum = 0;
+#if defined(__AVX2__)
+  // pairs (X, O) of int16 times (1, -1) summed into int32 lanes
+  const __m256i weights = _mm256_set1_epi32(int(0xffff0001));
+  __m256i acc = _mm256_setzero_si256();
+  for (size_t i = 0; i < size; i += 16) {
+    const __m256i v = _mm256_loadu_si256((const __m256i *)(scores + i));
+    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(v, weights));
+  }
+  __m128i acc4 = _mm_add_epi32(_mm256_castsi256_si128(acc),
+                               _mm256_extracti128_si256(acc, 1));
+  acc4 = _mm_add_epi32(acc4, _mm_shuffle_epi32(acc4, 0x4e));
+  acc4 = _mm_add_epi32(acc4, _mm_shuffle_epi32(acc4, 0xb1));
+  sum = _mm_cvtsi128_si32(acc4);
+#elif defined(__SSE2__)
+  const __m128i weights = _mm_set1_epi32(int(0xffff0001));
+  __m128i acc = _mm_setzero_si128();
+  for (size_t i = 0; i < size; i += 8) {
+    const __m128i v = _mm_loadu_si128((const __m128i *)(scores + i));
+    acc = _mm_add_epi32(acc, _mm_madd_epi16(v, weights));
+  }
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4e));
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xb1));
+  sum = _mm_cvtsi128_si32(acc);
+#else
+  for (size_t i = 0; i < size; i += 2)
+    sum += scores[i] - scores[i + 1];
+#endif
+  return side == Sign::X ? sum : -sum;
+}
+
+}; // namespace ttt::my_player
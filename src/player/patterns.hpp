@@ -0,0 +1,102 @@
+#pragma once
+
+#include "core/game.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace ttt::my_player {
+
+using game::Sign;
+using game::State;
+
+// Shape of a line through a cell after placing a mark there, weakest first.
+enum class Shape : uint8_t {
+  NONE,       // no window through the cell can become a line
+  ONE,        // a window with this mark only
+  TWO,        // a window missing three marks
+  THREE,      // one more mark makes a four
+  OPEN_THREE, // one more mark makes an open four
+  FOUR,       // one cell completes a line
+  OPEN_FOUR,  // two cells complete a line
+  FIVE,       // a line
+};
+
+// Shapes and scores of every line pattern for one `win_len`. A pattern is the
+// `2 * (win_len - 1)` cells around a center cell in one direction, each cell
+// empty (0), own (1) or blocked by the opponent or the edge (2), packed as a
+// base-3 number with digits for the offsets `-(win_len - 1), ..., -1, 1, ...,
+// win_len - 1` from the lowest one. Tables are built once per `win_len` and
+// shared by all engines.
+class PatternTable {
+public:
+  static const int MAX_WIN_LEN = 6;
+  static bool supports(int win_len) {
+    return win_len >= 2 && win_len <= MAX_WIN_LEN;
+  }
+  // Thread-safe; `win_len` must be supported.
+  static const PatternTable &get(int win_len);
+
+  int get_win_len() const { return m_win_len; }
+  int get_n_neighbors() const { return 2 * (m_win_len - 1); }
+  // Weight of digit `pos` of a code.
+  uint32_t get_pow3(int pos) const { return m_pow3[pos]; }
+
+  Shape get_shape(uint32_t code) const { return m_shapes[code]; }
+  int get_score(uint32_t code) const { return m_scores[code]; }
+  // Score of a cell from the patterns of its four directions, with a bonus
+  // for two strong shapes at once; fits in int16_t.
+  int get_cell_score(const uint32_t codes[4]) const;
+
+  static int shape_score(Shape shape);
+
+private:
+  explicit PatternTable(int win_len);
+  Shape classify(std::vector<uint8_t> &line) const;
+  int count_line_cells(std::vector<uint8_t> &line) const;
+  bool is_line(const std::vector<uint8_t> &line) const;
+
+  int m_win_len;
+  std::vector<uint32_t> m_pow3;
+  std::vector<Shape> m_shapes;
+  std::vector<int16_t> m_scores;
+};
+
+// Incrementally updated pattern codes of every cell and direction for both
+// signs, and the score of every empty cell for both signs: how good a mark
+// of that sign would be there. The evaluation sums the scores of one sign
+// minus the other over the board with SIMD. Setting a cell updates the
+// codes of the cells within `win_len - 1` of it along the four directions.
+class PatternEvaluator {
+public:
+  static bool supports(const State::Opts &opts) {
+    return PatternTable::supports(opts.win_len);
+  }
+
+  PatternEvaluator(const State::Opts &opts);
+
+  // Places a mark or, with `Sign::NONE`, clears the cell.
+  void set(int idx, Sign sign);
+
+  // Sum of cell scores of `side` minus those of the other sign.
+  int evaluate(Sign side) const;
+  int get_cell_score(int idx, Sign sign) const {
+    return m_scores[2 * idx + (sign == Sign::X ? 0 : 1)];
+  }
+  Shape get_shape(int idx, int dir, Sign sign) const {
+    return m_table->get_shape(m_codes[sign == Sign::X ? 0 : 1][4 * idx + dir]);
+  }
+
+private:
+  void update_score(int idx);
+
+  const PatternTable *m_table;
+  int m_rows, m_cols, m_n_cells;
+  std::vector<Sign> m_cells;
+  // codes of (cell, direction) as seen by X and by O
+  std::vector<uint32_t> m_codes[2];
+  // interleaved scores of X and O per cell, zero padded for SIMD
+  std::vector<int16_t> m_scores;
+};
+
+}; // namespace ttt::my_player
@@ -0,0 +1,428 @@
+#include "pn_solver.hpp"
+
+#include <algorithm>
+
+namespace ttt::my_player {
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+const uint32_t INF = 0x7fffffff;
+// keeps the tables of the two proofs apart
+const uint64_t ATTACKER_O_KEY = 0x6a09e667f3bcc909ULL;
+// approximate size of a table entry with its hash map node
+const size_t ENTRY_BYTES = 48;
+
+// Sums stay below INF unless a term is INF, so a large finite sum never
+// reads as a proof.
+uint32_t add(uint32_t a, uint32_t b) {
+  if (a >= INF || b >= INF)
+    return INF;
+  return uint32_t(std::min<uint64_t>(uint64_t(a) + b, INF - 1));
+}
+
+// Threshold for the best child: a bit above the second best, so that the
+// search does not bounce between two close children.
+uint32_t epsilon_threshold(uint32_t second) {
+  if (second >= INF)
+    return INF;
+  return uint32_t(std::min<uint64_t>(second + second / 4 + 1, INF - 1));
+}
+
+// False if no window free of the other side can be filled with the moves
+// `sign` has left.
+bool can_win(const Board &board, Sign sign) {
+  const int n_left = board.get_opts().max_moves - board.get_move_no();
+  const int own_moves =
+      (n_left + (board.get_current_player() == sign ? 1 : 0)) / 2;
+  const int len = board.get_win_len();
+  for (int count = std::max(len - own_moves, 0); count < len; ++count)
+    if (board.get_open_windows(sign, count) > 0)
+      return true;
+  return false;
+}
+
+}; // namespace
+
+const char *to_string(PnResult result) {
+  switch (result) {
+  case PnResult::WIN:
+    return "win";
+  case PnResult::LOSS:
+    return "loss";
+  case PnResult::DRAW:
+    return "draw";
+  default:
+    return "unknown";
+  }
+}
+
+PnSolver::PnSolver(const PnSolverOpts &opts) { set_opts(opts); }
+
+void PnSolver::set_opts(const PnSolverOpts &opts) {
+  m_opts = opts;
+  m_max_entries =
+      std::max<size_t>(size_t(opts.tt_size_mb) * 1024 * 1024 / ENTRY_BYTES,
+                       256);
+}
+
+PnSolverStats PnSolver::get_stats() const {
+  PnSolverStats stats;
+  stats.tt_entries = m_table.size();
+  stats.gc_runs = m_gc_runs;
+  stats.gc_removed = m_gc_removed;
+  return stats;
+}
+
+void PnSolver::init_symmetries(const Board &board) {
+  const State::Opts &opts = board.get_opts();
+  const int rows = opts.rows, cols = opts.cols;
+  m_symmetries.clear();
+  // the mirrors and half turn, and with them quarter turns on square boards
+  for (int s = 0; s < (rows == cols ? 8 : 4); ++s) {
+    std::vector<int> map(board.get_n_cells());
+    for (int y = 0; y < rows; ++y)
+      for (int x = 0; x < cols; ++x) {
+        int tx = s & 1 ? cols - 1 - x : x;
+        int ty = s & 2 ? rows - 1 - y : y;
+        if (s & 4)
+          std::swap(tx, ty);
+        map[board.index(x, y)] = board.index(tx, ty);
+      }
+    m_symmetries.push_back(std::move(map));
+  }
+  m_hashes.assign(m_symmetries.size(), Board::base_hash(opts));
+  for (int idx = 0; idx < board.get_n_cells(); ++idx)
+    if (!board.is_empty(idx))
+      for (size_t s = 0; s < m_symmetries.size(); ++s)
+        m_hashes[s] ^= board.cell_key(m_symmetries[s][idx], board.at(idx));
+}
+
+void PnSolver::play(int idx) {
+  const Sign side = m_board->get_current_player();
+  for (size_t s = 0; s < m_symmetries.size(); ++s)
+    m_hashes[s] ^= m_board->cell_key(m_symmetries[s][idx], side);
+  m_board->place(idx);
+}
+
+void PnSolver::take_back() {
+  const int idx = m_board->get_moves().back();
+  const Sign side = m_board->at(idx);
+  m_board->undo();
+  for (size_t s = 0; s < m_symmetries.size(); ++s)
+    m_hashes[s] ^= m_board->cell_key(m_symmetries[s][idx], side);
+}
+
+uint64_t PnSolver::key() const {
+  const uint64_t hash = *std::min_element(m_hashes.begin(), m_hashes.end());
+  return m_attacker == Sign::O ? hash ^ ATTACKER_O_KEY : hash;
+}
+
+uint64_t PnSolver::child_key(int idx) const {
+  const Sign side = m_board->get_current_player();
+  uint64_t hash = UINT64_MAX;
+  for (size_t s = 0; s < m_symmetries.size(); ++s)
+    hash = std::min(hash, m_hashes[s] ^
+                              m_board->cell_key(m_symmetries[s][idx], side));
+  return m_attacker == Sign::O ? hash ^ ATTACKER_O_KEY : hash;
+}
+
+bool PnSolver::out_of_budget() {
+  if (m_aborted)
+    return true;
+  ++m_nodes;
+  if (m_nodes > m_opts.max_nodes ||
+      ((m_nodes & 1023) == 0 && Clock::now() >= m_deadline))
+    m_aborted = true;
+  return m_aborted;
+}
+
+void PnSolver::generate(int ply) {
+  Board &b = *m_board;
+  const Sign side = b.get_current_player(), opp = opp_sign(side);
+  const int n_cells = b.get_n_cells();
+  const bool last = b.get_move_no() + 1 >= b.get_opts().max_moves;
+  auto &children = m_children[ply];
+  children.clear();
+
+  auto terminal = [&](int idx, Sign winner) {
+    const bool proven = winner == m_attacker;
+    children.push_back({idx, true, winner, proven ? 0 : INF, proven ? INF : 0});
+  };
+  for (int idx = 0; idx < n_cells; ++idx) {
+    if (!b.is_empty(idx) || !b.completes_line(idx, side))
+      continue;
+    // a line of X lets O draw with a line of its own, unless it fills the
+    // board
+    Sign winner = side;
+    if (side == Sign::X && !last) {
+      b.place(idx, side);
+      if (b.has_line_threat(Sign::O))
+        winner = Sign::NONE;
+      b.undo();
+    }
+    terminal(idx, winner);
+    // a won game needs no other move
+    if (winner == side) {
+      children.erase(children.begin(), children.end() - 1);
+      return;
+    }
+  }
+
+  // X must block a line of O; the other moves lose at once
+  const bool forced = side == Sign::X && b.has_line_threat(opp);
+  std::vector<std::pair<int, int>> order;
+  for (int idx = 0; idx < n_cells; ++idx) {
+    if (!b.is_empty(idx) || b.completes_line(idx, side))
+      continue;
+    if (forced && !b.completes_line(idx, opp))
+      continue;
+    order.push_back({-b.get_move_gain(idx, side), idx});
+  }
+  std::sort(order.begin(), order.end());
+  for (auto [gain, idx] : order) {
+    if (last)
+      terminal(idx, Sign::NONE);
+    else
+      children.push_back({idx, false, Sign::NONE, 1, 1});
+  }
+}
+
+void PnSolver::update_children(int ply) {
+  for (Child &child : m_children[ply]) {
+    if (child.terminal)
+      continue;
+    auto it = m_table.find(child_key(child.idx));
+    if (it != m_table.end()) {
+      child.pn = it->second.pn;
+      child.dn = it->second.dn;
+    } else {
+      child.pn = child.dn = 1;
+    }
+  }
+}
+
+void PnSolver::mid(uint32_t th_pn, uint32_t th_dn, int ply) {
+  if (out_of_budget())
+    return;
+  const long long start_nodes = m_nodes;
+  Board &b = *m_board;
+  const bool or_node = b.get_current_player() == m_attacker;
+  if (!can_win(b, m_attacker)) {
+    Entry &entry = m_table[key()];
+    entry.pn = INF;
+    entry.dn = 0;
+    entry.work = std::max<uint32_t>(entry.work, 1);
+    return;
+  }
+  generate(ply);
+  auto &children = m_children[ply];
+
+  uint32_t pn = 0, dn = 0;
+  while (true) {
+    update_children(ply);
+    // the best child and the second best value: least pn at OR nodes,
+    // least dn at AND nodes
+    int best = -1;
+    uint32_t best_value = INF, second = INF;
+    pn = or_node ? INF : 0;
+    dn = or_node ? 0 : INF;
+    for (int i = 0; i < int(children.size()); ++i) {
+      const Child &child = children[i];
+      const uint32_t value = or_node ? child.pn : child.dn;
+      if (or_node) {
+        pn = std::min(pn, child.pn);
+        dn = add(dn, child.dn);
+      } else {
+        pn = add(pn, child.pn);
+        dn = std::min(dn, child.dn);
+      }
+      if (best < 0 || value < best_value) {
+        second = best_value;
+        best = i;
+        best_value = value;
+      } else if (value < second) {
+        second = value;
+      }
+    }
+    if (pn >= th_pn || dn >= th_dn || m_aborted)
+      break;
+
+    const Child &child = children[best];
+    uint32_t child_pn, child_dn;
+    if (or_node) {
+      child_pn = std::min(th_pn, epsilon_threshold(second));
+      child_dn = uint32_t(std::min<uint64_t>(uint64_t(th_dn) - dn + child.dn,
+                                             INF));
+    } else {
+      child_dn = std::min(th_dn, epsilon_threshold(second));
+      child_pn = uint32_t(std::min<uint64_t>(uint64_t(th_pn) - pn + child.pn,
+                                             INF));
+    }
+    const int idx = child.idx;
+    play(idx);
+    mid(child_pn, child_dn, ply + 1);
+    take_back();
+  }
+
+  Entry &entry = m_table[key()];
+  entry.pn = pn;
+  entry.dn = dn;
+  entry.work = uint32_t(
+      std::min<long long>(entry.work + (m_nodes - start_nodes), UINT32_MAX));
+  if (m_table.size() > m_max_entries)
+    collect_garbage();
+}
+
+void PnSolver::collect_garbage() {
+  std::vector<uint32_t> works;
+  works.reserve(m_table.size());
+  for (auto &[key, entry] : m_table)
+    works.push_back(entry.work);
+  const size_t k = std::min(works.size() - 1,
+                            size_t(works.size() * m_opts.gc_fraction));
+  std::nth_element(works.begin(), works.begin() + k, works.end());
+  const uint32_t threshold = works[k];
+  const size_t before = m_table.size();
+  for (auto it = m_table.begin(); it != m_table.end();) {
+    if (it->second.work <= threshold)
+      it = m_table.erase(it);
+    else
+      ++it;
+  }
+  ++m_gc_runs;
+  m_gc_removed += before - m_table.size();
+}
+
+bool PnSolver::prove(Board &board, Sign attacker, uint32_t &pn,
+                     uint32_t &dn) {
+  m_board = &board;
+  m_attacker = attacker;
+  if (!can_win(board, attacker)) {
+    pn = INF;
+    dn = 0;
+    m_children[0].clear();
+    return false;
+  }
+  mid(INF, INF, 0);
+  // from the children as the root saw them last: its own entry may have been
+  // collected right after the store
+  const bool or_node = board.get_current_player() == attacker;
+  pn = or_node ? INF : 0;
+  dn = or_node ? 0 : INF;
+  for (const Child &child : m_children[0]) {
+    if (or_node) {
+      pn = std::min(pn, child.pn);
+      dn = add(dn, child.dn);
+    } else {
+      pn = add(pn, child.pn);
+      dn = std::min(dn, child.dn);
+    }
+  }
+  return pn == 0;
+}
+
+PnSolution PnSolver::solve(const State &state) {
+  Board board(state);
+  if (state.get_status() == game::Status::LAST_MOVE) {
+    PnSolution solution;
+    solution.result = board.get_drawing_reply() >= 0 ? PnResult::DRAW
+                                                     : PnResult::LOSS;
+    solution.move = board.point(board.get_last_move_reply());
+    return solution;
+  }
+  if (state.get_status() == game::Status::ENDED)
+    return PnSolution();
+  return solve(board);
+}
+
+PnSolution PnSolver::solve(Board &board) {
+  const auto start = Clock::now();
+  m_deadline = start + std::chrono::milliseconds(m_opts.time_ms);
+  m_nodes = 0;
+  m_aborted = false;
+  if (m_children.size() < size_t(board.get_n_cells() + 1))
+    m_children.resize(board.get_n_cells() + 1);
+  init_symmetries(board);
+
+  PnSolution solution;
+  const Sign side = board.get_current_player();
+  uint32_t pn, dn;
+  auto pick = [&](auto better) {
+    const Child *chosen = nullptr;
+    for (const Child &child : m_children[0])
+      if (!chosen || better(child, *chosen))
+        chosen = &child;
+    if (chosen)
+      solution.move = board.point(chosen->idx);
+  };
+  if (prove(board, side, pn, dn)) {
+    solution.result = PnResult::WIN;
+    pick([](const Child &a, const Child &b) { return a.pn < b.pn; });
+  } else if (dn == 0) {
+    const bool lost = prove(board, opp_sign(side), pn, dn);
+    if (lost) {
+      // the refutation which took most work, as the move a weaker
+      // opponent most likely misses
+      solution.result = PnResult::LOSS;
+      auto work = [&](const Child &child) -> uint32_t {
+        if (child.terminal)
+          return 0;
+        auto it = m_table.find(child_key(child.idx));
+        return it != m_table.end() ? it->second.work + 1 : 1;
+      };
+      pick([&](const Child &a, const Child &b) { return work(a) > work(b); });
+    } else if (dn == 0) {
+      solution.result = PnResult::DRAW;
+      pick([](const Child &a, const Child &b) { return a.dn < b.dn; });
+      // neither side can make a line any more: every move draws
+      for (int idx = 0; idx < board.get_n_cells() && solution.move.x < 0;
+           ++idx)
+        if (board.is_empty(idx))
+          solution.move = board.point(idx);
+    }
+  }
+  if (solution.result == PnResult::UNKNOWN)
+    solution.move = {-1, -1};
+  solution.nodes = m_nodes;
+  solution.time_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  m_board = nullptr;
+  return solution;
+}
+
+PnEngine::PnEngine(const PnPlayerOpts &opts)
+    : m_opts(opts), m_search(opts.search) {}
+
+void PnEngine::start_game(PnContext &ctx, const State::Opts &opts,
+                          Sign sign) {
+  m_search.start_game(ctx, opts, sign);
+  ctx.solver.set_opts(m_opts.solver);
+}
+
+Point PnEngine::make_move(PnContext &ctx, const State &state) {
+  ctx.solver.set_opts(m_opts.solver);
+  ctx.last_solution = ctx.solver.solve(state);
+  ctx.searched = ctx.last_solution.result == PnResult::UNKNOWN ||
+                 ctx.last_solution.move.x < 0;
+  if (!ctx.searched)
+    return ctx.last_solution.move;
+  return m_search.make_move(ctx, state);
+}
+
+bool PnEngine::get_move_stats(const PnContext &ctx, MoveStats &stats) const {
+  if (ctx.searched && !m_search.get_move_stats(ctx, stats))
+    return false;
+  if (!ctx.searched && ctx.last_solution.move.x < 0)
+    return false;
+  stats.solver_nodes += ctx.last_solution.nodes;
+  stats.solver_ms += ctx.last_solution.time_ms;
+  stats.time_ms += ctx.last_solution.time_ms;
+  return true;
+}
+
+PnPlayer::PnPlayer(const char *name, const PnPlayerOpts &opts)
+    : EngineContext(std::make_shared<PnEngine>(opts), name) {}
+
+}; // namespace ttt::my_player
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "board.hpp"
+#include "search.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ttt::my_player {
+
+struct PnSolverOpts {
+  int time_ms = 1000;
+  long long max_nodes = 100000000;
+  // memory of the table; beyond it the entries with the least work are
+  // collected
+  int tt_size_mb = 64;
+  // share of the entries a collection removes
+  double gc_fraction = 0.5;
+};
+
+// Game-theoretic value for the side to move.
+enum class PnResult { WIN, LOSS, DRAW, UNKNOWN };
+
+const char *to_string(PnResult result);
+
+struct PnSolution {
+  PnResult result = PnResult::UNKNOWN;
+  // a move keeping the result: the winning or drawing move, or the move
+  // which took most work to refute in a lost position
+  Point move = {-1, -1};
+  long long nodes = 0;
+  double time_ms = 0;
+};
+
+struct PnSolverStats {
+  size_t tt_entries = 0;
+  long long gc_runs = 0;
+  long long gc_removed = 0;
+};
+
+// Depth-first proof-number search (df-pn) with the 1 + epsilon threshold
+// trick. Three results come from two binary proofs: "the side to move
+// wins" and, failing that, "the opponent wins"; if neither holds the
+// position is a draw. Moves fill every empty cell, so it is exact, and
+// meant for boards up to about 9x9. The game rules are those of `State`: a
+// line of O wins at once, a line of X lets O answer with a line of its own
+// for a draw.
+//
+// Positions have no cycles and are fully described by their marks, and
+// mirrored or turned positions share an entry. So the table stays valid
+// from move to move and game to game: once the root is solved, every later
+// move of the game is a lookup. Its entries hold the proof and disproof
+// numbers and the nodes spent below them; when the table outgrows
+// `tt_size_mb` the cheapest entries are dropped.
+class PnSolver {
+public:
+  PnSolver(const PnSolverOpts &opts = PnSolverOpts());
+
+  const PnSolverOpts &get_opts() const { return m_opts; }
+  void set_opts(const PnSolverOpts &opts);
+
+  PnSolution solve(const State &state);
+  PnSolution solve(Board &board);
+
+  void clear() { m_table.clear(); }
+  PnSolverStats get_stats() const;
+
+private:
+  struct Entry {
+    uint32_t pn = 1;
+    uint32_t dn = 1;
+    // nodes searched below the entry
+    uint32_t work = 0;
+  };
+
+  struct Child {
+    int idx;
+    // for terminal children, the winner (NONE for a draw)
+    bool terminal;
+    Sign winner;
+    // pn/dn of the move for the attacker
+    uint32_t pn, dn;
+  };
+
+  // Proves or disproves a win of `attacker` from the position of the board.
+  bool prove(Board &board, Sign attacker, uint32_t &pn, uint32_t &dn);
+  void mid(uint32_t th_pn, uint32_t th_dn, int ply);
+  void generate(int ply);
+  void update_children(int ply);
+  void init_symmetries(const Board &board);
+  // Moves on the board which keep the hashes of all symmetries.
+  void play(int idx);
+  void take_back();
+  // The least hash over the symmetries of the position (or of the position
+  // after `idx`), so that mirrored positions share entries.
+  uint64_t key() const;
+  uint64_t child_key(int idx) const;
+  bool out_of_budget();
+  void collect_garbage();
+
+  PnSolverOpts m_opts;
+  size_t m_max_entries = 0;
+  std::unordered_map<uint64_t, Entry> m_table;
+  long long m_gc_runs = 0;
+  long long m_gc_removed = 0;
+
+  // state of the current proof
+  Board *m_board = nullptr;
+  Sign m_attacker = Sign::NONE;
+  bool m_aborted = false;
+  long long m_nodes = 0;
+  std::chrono::steady_clock::time_point m_deadline;
+  std::vector<std::vector<Child>> m_children;
+  // cell maps of the board symmetries and the position hash under each
+  std::vector<std::vector<int>> m_symmetries;
+  std::vector<uint64_t> m_hashes;
+};
+
+struct PnPlayerOpts {
+  // the solver gets this much of every move first
+  PnSolverOpts solver = {50, 5000000, 64, 0.5};
+  // plays where the solver runs out of time
+  SearchOpts search;
+};
+
+struct PnContext : SearchContext {
+  PnSolver solver;
+  PnSolution last_solution;
+  // the last move came from the search
+  bool searched = false;
+};
+
+// Plays the solved move where the solver finishes in time and searches
+// otherwise, so it is exact on small boards and still plays big ones.
+class PnEngine : public EngineBase<PnContext> {
+  PnPlayerOpts m_opts;
+  SearchEngine m_search;
+
+public:
+  PnEngine(const PnPlayerOpts &opts = PnPlayerOpts());
+
+  const PnPlayerOpts &get_opts() const { return m_opts; }
+
+  void start_game(PnContext &ctx, const State::Opts &opts, Sign sign);
+  Point make_move(PnContext &ctx, const State &state);
+  bool get_move_stats(const PnContext &ctx, MoveStats &stats) const;
+};
+
+class PnPlayer : public EngineContext<PnEngine> {
+public:
+  PnPlayer(const char *name, const PnPlayerOpts &opts = PnPlayerOpts());
+
+  const PnSolution &get_last_solution() {
+    return get_context().last_solution;
+  }
+};
+
+}; // namespace ttt::my_player
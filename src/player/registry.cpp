@@ -0,0 +1,242 @@
+#include "registry.hpp"
+#include "mcts.hpp"
+#include "my_player.hpp"
+#include "pn_solver.hpp"
+#include "search.hpp"
+
+#ifdef TTT_HAS_BASELINE
+#include "core/baseline.hpp"
+#endif
+
+#include <cstdlib>
+
+namespace ttt::my_player {
+
+bool PlayerParams::parse(const std::string &text, std::string &error) {
+  size_t pos = 0;
+  while (pos < text.size()) {
+    size_t end = text.find(',', pos);
+    if (end == std::string::npos)
+      end = text.size();
+    const std::string item = text.substr(pos, end - pos);
+    pos = end + 1;
+    if (item.empty())
+      continue;
+    const size_t eq = item.find('=');
+    if (eq == std::string::npos || eq == 0) {
+      error = "expected key=value, got '" + item + "'";
+      return false;
+    }
+    if (!m_values.emplace(item.substr(0, eq), item.substr(eq + 1)).second) {
+      error = "repeated key '" + item.substr(0, eq) + "'";
+      return false;
+    }
+  }
+  return true;
+}
+
+const std::string *PlayerParams::find(const std::string &key) const {
+  m_read.insert(key);
+  auto it = m_values.find(key);
+  return it == m_values.end() ? nullptr : &it->second;
+}
+
+int PlayerParams::get_int(const std::string &key, int def) const {
+  const std::string *value = find(key);
+  if (!value)
+    return def;
+  char *end = nullptr;
+  const long result = std::strtol(value->c_str(), &end, 10);
+  if (value->empty() || *end != '\0') {
+    add_error(key + ": expected an integer, got '" + *value + "'");
+    return def;
+  }
+  return int(result);
+}
+
+double PlayerParams::get_double(const std::string &key, double def) const {
+  const std::string *value = find(key);
+  if (!value)
+    return def;
+  char *end = nullptr;
+  const double result = std::strtod(value->c_str(), &end);
+  if (value->empty() || *end != '\0') {
+    add_error(key + ": expected a number, got '" + *value + "'");
+    return def;
+  }
+  return result;
+}
+
+bool PlayerParams::get_bool(const std::string &key, bool def) const {
+  const std::string *value = find(key);
+  if (!value)
+    return def;
+  for (const char *yes : {"1", "true", "yes", "on"})
+    if (*value == yes)
+      return true;
+  for (const char *no : {"0", "false", "no", "off"})
+    if (*value == no)
+      return false;
+  add_error(key + ": expected a boolean, got '" + *value + "'");
+  return def;
+}
+
+std::string PlayerParams::get_string(const std::string &key,
+                                     const std::string &def) const {
+  const std::string *value = find(key);
+  return value ? *value : def;
+}
+
+std::vector<std::string> PlayerParams::get_errors() const {
+  std::vector<std::string> errors = m_errors;
+  for (auto &[key, value] : m_values)
+    if (!m_read.count(key))
+      errors.push_back("unknown parameter '" + key + "'");
+  return errors;
+}
+
+static std::unique_ptr<IPlayer> make_search_player(const char *name,
+                                                   const PlayerParams &params) {
+  SearchOpts opts;
+  opts.time_ms = params.get_int("time", opts.time_ms);
+  opts.max_depth = params.get_int("depth", opts.max_depth);
+  opts.tt_size_mb = params.get_int("tt_mb", opts.tt_size_mb);
+  opts.keep_tt = params.get_bool("keep_tt", opts.keep_tt);
+  opts.tt_path = params.get_string("tt_file", opts.tt_path);
+  opts.tt_shm_name = params.get_string("tt_shm", opts.tt_shm_name);
+  opts.tt_huge_pages = params.get_bool("huge_pages", opts.tt_huge_pages);
+  opts.max_branching = params.get_int("branching", opts.max_branching);
+  opts.n_threads = params.get_int("threads", opts.n_threads);
+  const std::string eval = params.get_string("eval", "patterns");
+  if (eval == "windows")
+    opts.evaluator = Evaluator::WINDOWS;
+  else if (eval == "patterns")
+    opts.evaluator = Evaluator::PATTERNS;
+  else if (eval == "nnue")
+    opts.evaluator = Evaluator::NNUE;
+  else
+    params.add_error("eval: expected windows, patterns or nnue, got '" +
+                     eval + "'");
+  opts.nnue_path = params.get_string("nnue", opts.nnue_path);
+  opts.eval_cache_mb = params.get_int("eval_cache", opts.eval_cache_mb);
+  opts.use_threat_solver = params.get_bool("threats", opts.use_threat_solver);
+  opts.threat_opts.time_ms =
+      params.get_int("threat_time", opts.threat_opts.time_ms);
+  opts.threat_opts.max_depth =
+      params.get_int("threat_depth", opts.threat_opts.max_depth);
+  opts.book_path = params.get_string("book", opts.book_path);
+  opts.tablebase_path = params.get_string("tablebase", opts.tablebase_path);
+  opts.verbose = params.get_bool("verbose", opts.verbose);
+  return std::make_unique<SearchPlayer>(name, opts);
+}
+
+static std::unique_ptr<IPlayer> make_mcts_player(const char *name,
+                                                 const PlayerParams &params) {
+  MctsOpts opts;
+  opts.time_ms = params.get_int("time", opts.time_ms);
+  opts.n_threads = params.get_int("threads", opts.n_threads);
+  opts.arena_nodes = params.get_int("arena", opts.arena_nodes);
+  opts.exploration = params.get_double("exploration", opts.exploration);
+  opts.expand_visits = params.get_int("expand", opts.expand_visits);
+  opts.prior_weight = params.get_double("prior", opts.prior_weight);
+  opts.reuse_tree = params.get_bool("reuse", opts.reuse_tree);
+  opts.seed = params.get_int("seed", int(opts.seed));
+  opts.verbose = params.get_bool("verbose", opts.verbose);
+  return std::make_unique<MctsPlayer>(name, opts);
+}
+
+static std::unique_ptr<IPlayer> make_pn_player(const char *name,
+                                               const PlayerParams &params) {
+  PnPlayerOpts opts;
+  opts.solver.time_ms = params.get_int("time", opts.solver.time_ms);
+  opts.solver.max_nodes = params.get_int("nodes", int(opts.solver.max_nodes));
+  opts.solver.tt_size_mb = params.get_int("tt_mb", opts.solver.tt_size_mb);
+  opts.search.time_ms = params.get_int("search_time", opts.search.time_ms);
+  opts.search.n_threads = params.get_int("threads", opts.search.n_threads);
+  return std::make_unique<PnPlayer>(name, opts);
+}
+
+static void register_builtin_players(PlayerRegistry &registry) {
+  registry.add("random", "random cell next to a mark (MyPlayer)",
+               [](const char *name, const PlayerParams &) {
+                 return std::make_unique<MyPlayer>(name);
+               });
+  registry.add("search",
+               "alpha-beta search (SearchPlayer): time, depth, tt_mb, "
+               "keep_tt, tt_file, tt_shm, huge_pages, branching, threads, "
+               "eval=windows|patterns|nnue, nnue, eval_cache, threats, "
+               "threat_time, threat_depth, book, tablebase, verbose",
+               make_search_player);
+  registry.add("mcts",
+               "Monte Carlo tree search (MctsPlayer): time, threads, arena, "
+               "exploration, expand, prior, reuse, seed, verbose",
+               make_mcts_player);
+  registry.add("solver",
+               "proof-number solver, searching where it runs out of time "
+               "(PnPlayer): time, nodes, tt_mb, search_time, threads",
+               make_pn_player);
+#ifdef TTT_HAS_BASELINE
+  registry.add("easy", "baseline easy player",
+               [](const char *name, const PlayerParams &) {
+                 return std::unique_ptr<IPlayer>(
+                     baseline::get_easy_player(name));
+               });
+  registry.add("harder", "baseline harder player",
+               [](const char *name, const PlayerParams &) {
+                 return std::unique_ptr<IPlayer>(
+                     baseline::get_harder_player(name));
+               });
+#endif
+}
+
+PlayerRegistry &PlayerRegistry::get() {
+  static PlayerRegistry registry = [] {
+    PlayerRegistry registry;
+    register_builtin_players(registry);
+    return registry;
+  }();
+  return registry;
+}
+
+void PlayerRegistry::add(const std::string &engine, const std::string &help,
+                         PlayerFactory factory) {
+  m_entries[engine] = {help, std::move(factory)};
+}
+
+std::vector<std::string> PlayerRegistry::get_engines() const {
+  std::vector<std::string> engines;
+  for (auto &[engine, entry] : m_entries)
+    engines.push_back(engine);
+  return engines;
+}
+
+std::unique_ptr<IPlayer> PlayerRegistry::create(const std::string &spec,
+                                                const char *name,
+                                                std::string &error) const {
+  const size_t colon = spec.find(':');
+  const std::string engine = spec.substr(0, colon);
+  auto it = m_entries.find(engine);
+  if (it == m_entries.end()) {
+    error = "unknown engine '" + engine + "'";
+    return nullptr;
+  }
+  PlayerParams params;
+  if (colon != std::string::npos &&
+      !params.parse(spec.substr(colon + 1), error))
+    return nullptr;
+  auto player = it->second.factory(name, params);
+  const auto errors = params.get_errors();
+  if (!errors.empty()) {
+    error = engine + ": " + errors.front();
+    return nullptr;
+  }
+  return player;
+}
+
+void PlayerRegistry::print_help(std::ostream &os) const {
+  os << "players: engine[:key=value,...]\n";
+  for (auto &[engine, entry] : m_entries)
+    os << "  " << engine << " - " << entry.help << '\n';
+}
+
+}; // namespace ttt::my_player
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "core/game.hpp"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ttt::my_player {
+
+using game::IPlayer;
+
+// `key=value` parameters of a player, given as a comma separated list.
+// Factories read what they know; keys nobody read are reported as errors,
+// so a typo does not silently play with the defaults.
+class PlayerParams {
+public:
+  // False and `error` set if an item has no `=` or a key repeats.
+  bool parse(const std::string &text, std::string &error);
+
+  bool has(const std::string &key) const { return m_values.count(key) > 0; }
+  // The value of `key` or `def` if it is missing; a value which is not a
+  // number is an error, see `get_errors`.
+  int get_int(const std::string &key, int def) const;
+  double get_double(const std::string &key, double def) const;
+  // "1", "true", "yes" or "on" and "0", "false", "no" or "off"
+  bool get_bool(const std::string &key, bool def) const;
+  std::string get_string(const std::string &key, const std::string &def) const;
+
+  // For values a factory rejects itself.
+  void add_error(const std::string &error) const { m_errors.push_back(error); }
+  // Bad values and keys which were never read.
+  std::vector<std::string> get_errors() const;
+
+private:
+  const std::string *find(const std::string &key) const;
+
+  std::map<std::string, std::string> m_values;
+  mutable std::set<std::string> m_read;
+  mutable std::vector<std::string> m_errors;
+};
+
+using PlayerFactory = std::function<std::unique_ptr<IPlayer>(
+    const char *name, const PlayerParams &params)>;
+
+// Engines by name, so test, tournament and client binaries pick players and
+// their settings on the command line. A player is given by a spec
+// `engine[:key=value,...]`, e.g. `search:time=20,threads=2`. The built-in
+// engines are registered on first use of `get`.
+class PlayerRegistry {
+public:
+  static PlayerRegistry &get();
+
+  // Replaces an engine of the same name.
+  void add(const std::string &engine, const std::string &help,
+           PlayerFactory factory);
+  bool has(const std::string &engine) const {
+    return m_entries.count(engine) > 0;
+  }
+  std::vector<std::string> get_engines() const;
+
+  // A player named `name` by `spec`; nullptr with `error` set if the engine
+  // is unknown or the parameters are wrong.
+  std::unique_ptr<IPlayer> create(const std::string &spec, const char *name,
+                                  std::string &error) const;
+
+  // Engines with their parameters, for `--help` messages.
+  void print_help(std::ostream &os) const;
+
+private:
+  struct Entry {
+    std::string help;
+    PlayerFactory factory;
+  };
+
+  PlayerRegistry() = default;
+
+  std::map<std::string, Entry> m_entries;
+};
+
+}; // namespace ttt::my_player
@@ -0,0 +1,22 @@
+#include "rng.hpp"
+
+#include <atomic>
+
+namespace ttt::my_player {
+
+static std::atomic<uint64_t> master_seed{0};
+
+void set_master_seed(uint64_t seed) {
+  master_seed.store(seed, std::memory_order_relaxed);
+}
+
+uint64_t get_master_seed() {
+  return master_seed.load(std::memory_order_relaxed);
+}
+
+uint64_t get_game_seed(int game_no, game::Sign sign) {
+  const uint64_t stream = 2 * uint64_t(game_no) + (sign == game::Sign::O);
+  return derive_seed(get_master_seed(), stream);
+}
+
+}; // namespace ttt::my_player
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "core/game.hpp"
+
+#include <cstdint>
+#include <limits>
+
+namespace ttt::my_player {
+
+// SplitMix64 step: a well mixed 64-bit function of `x`, used to expand seeds.
+inline uint64_t splitmix64(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+// Seed of an independent stream `stream` of `seed`, e.g. of a thread or a
+// game.
+inline uint64_t derive_seed(uint64_t seed, uint64_t stream) {
+  return splitmix64(seed ^ splitmix64(stream));
+}
+
+// xoshiro256**: a small fast generator owned by one player or thread, so
+// there is no shared state nor lock as with `std::rand`. Satisfies
+// UniformRandomBitGenerator for the standard distributions and shuffles.
+class Rng {
+  uint64_t m_s[4];
+
+  static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+  using result_type = uint64_t;
+  static constexpr uint64_t min() { return 0; }
+  static constexpr uint64_t max() {
+    return std::numeric_limits<uint64_t>::max();
+  }
+
+  explicit Rng(uint64_t seed = 0) { this->seed(seed); }
+
+  void seed(uint64_t seed) {
+    for (auto &s : m_s)
+      s = seed = splitmix64(seed);
+  }
+
+  uint64_t next() {
+    const uint64_t result = rotl(m_s[1] * 5, 7) * 9;
+    const uint64_t t = m_s[1] << 17;
+    m_s[2] ^= m_s[0];
+    m_s[3] ^= m_s[1];
+    m_s[1] ^= m_s[2];
+    m_s[0] ^= m_s[3];
+    m_s[2] ^= t;
+    m_s[3] = rotl(m_s[3], 45);
+    return result;
+  }
+  uint64_t operator()() { return next(); }
+
+  // uniform in [0, n)
+  uint32_t below(uint32_t n) { return uint32_t(((next() >> 32) * n) >> 32); }
+  // uniform in [0, 1)
+  double next_double() { return (next() >> 11) * 0x1.0p-53; }
+};
+
+// Process-wide seed every game seed derives from; test and tool mains set it
+// from the command line instead of `std::srand`. Defaults to 0.
+void set_master_seed(uint64_t seed);
+uint64_t get_master_seed();
+
+// Seed of the `game_no`-th game of a player of `sign`: the same master seed
+// replays the same games no matter how they are spread over threads.
+uint64_t get_game_seed(int game_no, game::Sign sign);
+
+}; // namespace ttt::my_player
@@ -0,0 +1,712 @@
+#include "search.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+namespace ttt::my_player {
+
+using Clock = std::chrono::steady_clock;
+
+static const int INF = WIN_SCORE + 1;
+// scores beyond this are wins or losses at a known distance
+static const int WIN_THRESHOLD = WIN_SCORE - 2 * MAX_PLY;
+
+static int score_to_tt(int score, int ply) {
+  if (score >= WIN_THRESHOLD)
+    return score + ply;
+  if (score <= -WIN_THRESHOLD)
+    return score - ply;
+  return score;
+}
+
+static int score_from_tt(int score, int ply) {
+  if (score >= WIN_THRESHOLD)
+    return score - ply;
+  if (score <= -WIN_THRESHOLD)
+    return score + ply;
+  return score;
+}
+
+static int evaluate(const Board &board) {
+  const Sign side = board.get_current_player();
+  if (const NnueAccumulator *nnue = board.get_nnue())
+    return nnue->evaluate(side);
+  if (const PatternEvaluator *patterns = board.get_patterns())
+    return patterns->evaluate(side);
+  return board.get_window_score(side) - board.get_window_score(opp_sign(side));
+}
+
+// Mixed into the keys of the evaluation cache, so that engines evaluating
+// differently never share entries.
+static uint64_t get_eval_salt(const Board &board, const SearchOpts &opts) {
+  if (board.get_nnue())
+    return 0x3c6ef372fe94f82bULL ^ std::hash<std::string>()(opts.nnue_path);
+  if (board.get_patterns())
+    return 0xa54ff53a5f1d36f1ULL;
+  return 0x510e527fade682d1ULL;
+}
+
+void OrderingTables::reset(int n_cells) {
+  for (auto &h : history)
+    h.assign(n_cells, 0);
+  for (auto &k : killers)
+    k = {-1, -1};
+}
+
+void OrderingTables::age() {
+  for (auto &h : history)
+    for (auto &v : h)
+      v /= 2;
+}
+
+void SearchTotals::add(const SearchInfo &info) {
+  ++n_searches;
+  max_depth = std::max(max_depth, info.depth);
+  depth_sum += info.depth;
+  nodes += info.nodes;
+  tt_probes += info.tt_probes;
+  tt_hits += info.tt_hits;
+  time_ms += info.time_ms;
+}
+
+namespace {
+
+struct ScoredMove {
+  int idx;
+  int score;
+};
+
+class Searcher {
+  TranspositionTable &m_tt;
+  OrderingTables &m_tables;
+  Board &m_board;
+  Clock::time_point m_deadline;
+  // set by the main thread on the deadline or when its search is over
+  std::atomic<bool> &m_stop;
+  bool m_is_main;
+  long long m_nodes = 0;
+  long long m_tt_probes = 0;
+  long long m_tt_hits = 0;
+  EvalCache *m_eval_cache = nullptr;
+  uint64_t m_eval_salt = 0;
+  int m_root_best = -1;
+  int m_max_branching;
+  std::vector<std::vector<ScoredMove>> m_moves;
+  // root moves to search; empty allows all
+  std::vector<char> m_root_allowed;
+  // root moves of the lines before (multi-PV); the root is not stored
+  // while some are left out, its result is not the one of the position
+  std::vector<int> m_root_excluded;
+
+public:
+  Searcher(TranspositionTable &tt, OrderingTables &tables, Board &board,
+           Clock::time_point deadline, std::atomic<bool> &stop, bool is_main,
+           int max_branching)
+      : m_tt(tt), m_tables(tables), m_board(board), m_deadline(deadline),
+        m_stop(stop), m_is_main(is_main), m_max_branching(max_branching),
+        m_moves(MAX_PLY) {}
+
+  int search(int depth, int alpha, int beta, int ply);
+
+  bool is_stopped() const { return m_stop.load(std::memory_order_relaxed); }
+  long long get_nodes() const { return m_nodes; }
+  long long get_tt_probes() const { return m_tt_probes; }
+  long long get_tt_hits() const { return m_tt_hits; }
+  int get_root_best() const { return m_root_best; }
+  void set_root_allowed(std::vector<char> allowed) {
+    m_root_allowed = std::move(allowed);
+  }
+  const std::vector<char> &get_root_allowed() const { return m_root_allowed; }
+  void set_root_excluded(std::vector<int> excluded) {
+    m_root_excluded = std::move(excluded);
+  }
+  void set_eval_cache(EvalCache *cache, uint64_t salt) {
+    m_eval_cache = cache;
+    m_eval_salt = salt;
+  }
+
+  // Candidates of the side to move, best first; empty board gives the center.
+  void generate(int ply, int tt_move, bool threatened);
+  const std::vector<ScoredMove> &get_moves(int ply) const {
+    return m_moves[ply];
+  }
+
+private:
+  void update_quiet_stats(int idx, int depth, int ply);
+  int evaluate_leaf();
+};
+
+int Searcher::evaluate_leaf() {
+  if (!m_eval_cache)
+    return evaluate(m_board);
+  const uint64_t key = m_board.get_hash() ^ m_eval_salt;
+  int value;
+  if (!m_eval_cache->probe(key, value)) {
+    value = evaluate(m_board);
+    m_eval_cache->store(key, value);
+  }
+  return value;
+}
+
+void Searcher::generate(int ply, int tt_move, bool threatened) {
+  auto &moves = m_moves[ply];
+  moves.clear();
+  const Sign side = m_board.get_current_player(), opp = opp_sign(side);
+  const int si = sign_index(side);
+  const int n_cells = m_board.get_n_cells();
+  const bool own_threat = m_board.has_line_threat(side);
+  for (int idx = 0; idx < n_cells; ++idx) {
+    if (!m_board.is_candidate(idx))
+      continue;
+    if (ply == 0 && !m_root_allowed.empty() && !m_root_allowed[idx])
+      continue;
+    if (ply == 0 && std::find(m_root_excluded.begin(), m_root_excluded.end(),
+                              idx) != m_root_excluded.end())
+      continue;
+    if (threatened) {
+      // only blocking the line (or making own line, leading to a draw for X)
+      if (m_board.completes_line(idx, opp) ||
+          (own_threat && m_board.completes_line(idx, side)))
+        moves.push_back({idx, m_board.get_move_gain(idx, side)});
+      continue;
+    }
+    int score = m_board.get_move_gain(idx, side) + m_tables.history[si][idx] / 16;
+    if (idx == tt_move)
+      score += 1 << 30;
+    else if (idx == m_tables.killers[ply][0])
+      score += 1 << 29;
+    else if (idx == m_tables.killers[ply][1])
+      score += 1 << 28;
+    moves.push_back({idx, score});
+  }
+  if (moves.empty() && m_board.get_move_no() == 0 &&
+      m_root_excluded.empty()) {
+    moves.push_back(
+        {m_board.index(m_board.get_cols() / 2, m_board.get_rows() / 2), 0});
+  }
+  std::sort(moves.begin(), moves.end(),
+            [](const ScoredMove &a, const ScoredMove &b) {
+              return a.score > b.score;
+            });
+}
+
+void Searcher::update_quiet_stats(int idx, int depth, int ply) {
+  auto &killers = m_tables.killers[ply];
+  if (killers[0] != idx) {
+    killers[1] = killers[0];
+    killers[0] = idx;
+  }
+  const int si = sign_index(m_board.get_current_player());
+  m_tables.history[si][idx] += depth * depth;
+}
+
+int Searcher::search(int depth, int alpha, int beta, int ply) {
+  if ((++m_nodes & 1023) == 0 && m_is_main && Clock::now() >= m_deadline)
+    m_stop.store(true, std::memory_order_relaxed);
+  if (m_stop.load(std::memory_order_relaxed))
+    return 0;
+
+  const Sign side = m_board.get_current_player(), opp = opp_sign(side);
+  // X completing a line still gives O a last move, which draws with O's line
+  if (ply > 0 && m_board.has_line_threat(side) &&
+      (side == Sign::O || !m_board.has_line_threat(Sign::O)))
+    return WIN_SCORE - ply - 1;
+  if (m_board.is_full())
+    return 0;
+  const bool threatened = m_board.has_line_threat(opp);
+  if (ply >= MAX_PLY - 1 || (depth <= 0 && !threatened))
+    return evaluate_leaf();
+
+  const uint64_t key = m_board.get_hash();
+  int tt_move = -1;
+  TTEntry entry;
+  ++m_tt_probes;
+  if (m_tt.probe(key, entry)) {
+    ++m_tt_hits;
+    tt_move = entry.move;
+    if (ply > 0 && entry.depth >= depth) {
+      const int score = score_from_tt(entry.score, ply);
+      if (entry.bound == Bound::EXACT ||
+          (entry.bound == Bound::LOWER && score >= beta) ||
+          (entry.bound == Bound::UPPER && score <= alpha))
+        return score;
+    }
+  }
+
+  generate(ply, tt_move, threatened);
+  auto &moves = m_moves[ply];
+  if (moves.empty())
+    return threatened ? -(WIN_SCORE - ply - 2) : 0;
+  if (ply > 0 && int(moves.size()) > m_max_branching)
+    moves.resize(m_max_branching);
+
+  // forced replies to a line threat do not consume depth
+  const int new_depth = threatened ? depth : depth - 1;
+  const int alpha_orig = alpha;
+  int best = -INF, best_move = -1;
+  for (size_t i = 0; i < moves.size(); ++i) {
+    const int idx = moves[i].idx;
+    int score;
+    if (m_board.completes_line(idx, side)) {
+      m_board.place(idx);
+      if (side == Sign::O || !m_board.has_line_threat(Sign::O))
+        score = WIN_SCORE - ply - 1;
+      else
+        score = 0;
+      m_board.undo();
+    } else {
+      m_board.place(idx);
+      if (m_board.is_full()) {
+        score = 0;
+      } else if (i == 0) {
+        score = -search(new_depth, -beta, -alpha, ply + 1);
+      } else {
+        score = -search(new_depth, -alpha - 1, -alpha, ply + 1);
+        if (score > alpha && score < beta)
+          score = -search(new_depth, -beta, -alpha, ply + 1);
+      }
+      m_board.undo();
+    }
+    if (is_stopped())
+      return 0;
+    if (score > best) {
+      best = score;
+      best_move = idx;
+      if (ply == 0)
+        m_root_best = idx;
+    }
+    if (score > alpha)
+      alpha = score;
+    if (alpha >= beta) {
+      if (!threatened)
+        update_quiet_stats(idx, depth, ply);
+      break;
+    }
+  }
+
+  const Bound bound = best <= alpha_orig ? Bound::UPPER
+                      : best >= beta     ? Bound::LOWER
+                                         : Bound::EXACT;
+  if (ply > 0 || m_root_excluded.empty())
+    m_tt.store(key, depth, score_to_tt(best, ply), bound, best_move);
+  return best;
+}
+
+// Plays a forced win of the side to move if the threat solver finds one.
+// Otherwise, when the opponent threatens a win by fours, restricts the root to
+// the moves after which that win is gone; moves left unchecked when the time
+// share runs out stay allowed.
+static int solve_threats(SearchContext &ctx, Board &board, Searcher &searcher,
+                         Clock::time_point deadline, SearchInfo &info) {
+  ThreatSolver &solver = ctx.threats;
+  const Sign side = board.get_current_player(), opp = opp_sign(side);
+  ThreatSolution solution = solver.solve_vcf(board, side);
+  info.threat_nodes += solution.nodes;
+  if (solution.result == ThreatResult::WIN)
+    return board.index(solution.move.x, solution.move.y);
+
+  // an existing line threat is handled by the forced replies of the search
+  if (!board.has_line_threat(opp)) {
+    solution = solver.solve_vcf(board, opp);
+    info.threat_nodes += solution.nodes;
+    if (solution.result == ThreatResult::WIN) {
+      searcher.generate(0, -1, false);
+      std::vector<char> allowed(board.get_n_cells(), 0);
+      bool any = false;
+      for (const auto &move : searcher.get_moves(0)) {
+        bool refutes = true;
+        if (Clock::now() < deadline) {
+          board.place(move.idx);
+          const ThreatSolution reply = solver.solve_vcf(board, opp);
+          board.undo();
+          info.threat_nodes += reply.nodes;
+          refutes = reply.result != ThreatResult::WIN;
+        }
+        allowed[move.idx] = refutes;
+        any |= refutes;
+      }
+      // a lost position: search all moves to delay the loss
+      if (any)
+        searcher.set_root_allowed(std::move(allowed));
+      return -1;
+    }
+  }
+
+  solution = solver.solve_vct(board, side);
+  info.threat_nodes += solution.nodes;
+  if (solution.result == ThreatResult::WIN)
+    return board.index(solution.move.x, solution.move.y);
+  return -1;
+}
+
+// Work of the helper threads, added up when they finish.
+struct HelperCounters {
+  std::atomic<long long> nodes{0};
+  std::atomic<long long> tt_probes{0};
+  std::atomic<long long> tt_hits{0};
+};
+
+// Lazy SMP helper: iterative deepening over the same root with own board and
+// ordering tables until the main thread stops it. Odd helpers start one ply
+// deeper, so that the threads spread over depths. Arguments are copied by the
+// thread constructor before the main thread moves on.
+static void run_helper(TranspositionTable &tt, OrderingTables tables,
+                       Board board, std::vector<char> root_allowed,
+                       std::atomic<bool> &stop, int id, int max_depth,
+                       int max_branching, EvalCache *eval_cache,
+                       uint64_t eval_salt, HelperCounters &counters) {
+  Searcher searcher(tt, tables, board, Clock::time_point::max(), stop, false,
+                    max_branching);
+  searcher.set_root_allowed(std::move(root_allowed));
+  searcher.set_eval_cache(eval_cache, eval_salt);
+  for (int depth = 1 + id % 2; depth <= max_depth && !searcher.is_stopped();
+       ++depth)
+    searcher.search(depth, -INF, INF, 0);
+  counters.nodes += searcher.get_nodes();
+  counters.tt_probes += searcher.get_tt_probes();
+  counters.tt_hits += searcher.get_tt_hits();
+}
+
+}; // namespace
+
+SearchEngine::SearchEngine(const SearchOpts &opts) : m_opts(opts) {
+  // a missing book only means searching from the first move
+  if (!m_opts.book_path.empty())
+    m_book.open(m_opts.book_path);
+  if (!m_opts.tablebase_path.empty() &&
+      !m_tablebase.open(m_opts.tablebase_path) && m_opts.verbose)
+    std::cerr << "cannot open tablebase '" << m_opts.tablebase_path << "'\n";
+  if (m_opts.evaluator == Evaluator::NNUE &&
+      !m_network.load(m_opts.nnue_path) && m_opts.verbose)
+    std::cerr << "cannot load network '" << m_opts.nnue_path
+              << "', evaluating patterns\n";
+  if (m_opts.eval_cache_mb > 0)
+    m_eval_cache = EvalCache::get_shared(m_opts.eval_cache_mb);
+}
+
+void SearchEngine::start_game(SearchContext &ctx, const State::Opts &opts,
+                              Sign sign) {
+  EngineBase::start_game(ctx, opts, sign);
+  const bool first_game = ctx.tt.get_size() == 0;
+  std::string error;
+  if (first_game && !m_opts.tt_shm_name.empty() &&
+      !ctx.tt.attach_shared(m_opts.tt_shm_name, m_opts.tt_size_mb,
+                            m_opts.tt_huge_pages, error) &&
+      m_opts.verbose)
+    std::cerr << error << ", using a private table\n";
+  // a shared table keeps its size and entries, other processes use them
+  if (!ctx.tt.is_shared()) {
+    ctx.tt.resize(m_opts.tt_size_mb);
+    // a missing or stale snapshot only means starting cold
+    if (first_game && !m_opts.tt_path.empty())
+      ctx.tt.load(m_opts.tt_path);
+    else if (!first_game && !m_opts.keep_tt)
+      ctx.tt.clear();
+  }
+  ctx.threats.set_opts(m_opts.threat_opts);
+  ctx.threats.clear_cache();
+  ctx.tables.reset(opts.rows * opts.cols);
+}
+
+void SearchEngine::end_game(SearchContext &ctx, const State &state,
+                            MoveResult result) {
+  if (!m_opts.tt_path.empty() && !ctx.tt.save(m_opts.tt_path) &&
+      m_opts.verbose)
+    std::cerr << "cannot write '" << m_opts.tt_path << "'\n";
+}
+
+Point SearchEngine::make_move(SearchContext &ctx, const State &state) {
+  const auto start = Clock::now();
+  Board board(state);
+  const int n_cells = board.get_n_cells();
+  const Sign side = board.get_current_player();
+
+  // players which missed `on_game_start` (e.g. with an older game loop)
+  if (ctx.tt.get_size() == 0 || int(ctx.tables.history[0].size()) != n_cells)
+    start_game(ctx, state.get_opts(), side);
+  ctx.tables.age();
+  ctx.tt.new_generation();
+
+  std::atomic<bool> stop{false};
+  Searcher searcher(ctx.tt, ctx.tables, board,
+                    start + std::chrono::milliseconds(m_opts.time_ms), stop,
+                    true, m_opts.max_branching);
+  SearchInfo info;
+  int best = -1;
+  Point tb_move;
+  TbEntry tb_entry;
+  if (m_tablebase.get_best_move(board, tb_move, tb_entry)) {
+    best = board.index(tb_move.x, tb_move.y);
+    info.tablebase = true;
+    if (tb_entry.result == TbResult::WIN)
+      info.score = WIN_SCORE - tb_entry.distance;
+    else if (tb_entry.result == TbResult::LOSS)
+      info.score = tb_entry.distance - WIN_SCORE;
+  } else if (state.get_status() == game::Status::LAST_MOVE) {
+    best = board.get_last_move_reply();
+  } else if (m_book.is_open()) {
+    const auto moves = m_book.probe(board);
+    if (!moves.empty()) {
+      best = board.index(moves[0].move.x, moves[0].move.y);
+      info.book = true;
+      info.score = moves[0].score;
+    }
+  }
+  const auto lookup_end = Clock::now();
+  info.lookup_ms =
+      std::chrono::duration<double, std::milli>(lookup_end - start).count();
+  if (best < 0 && m_opts.use_threat_solver) {
+    best = solve_threats(ctx, board, searcher,
+                         start + std::chrono::milliseconds(m_opts.time_ms / 4),
+                         info);
+    info.threat_win = best >= 0;
+    if (info.threat_win)
+      info.score = WIN_SCORE - MAX_PLY;
+  }
+  info.threat_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - lookup_end)
+          .count();
+  std::vector<std::thread> helpers;
+  HelperCounters helper_counters;
+  if (best < 0) {
+    // after the threat solver, which needs neither patterns nor the network
+    if (m_opts.evaluator == Evaluator::PATTERNS ||
+        (m_opts.evaluator == Evaluator::NNUE && !board.enable_nnue(m_network)))
+      board.enable_patterns();
+    const uint64_t eval_salt = get_eval_salt(board, m_opts);
+    searcher.set_eval_cache(m_eval_cache.get(), eval_salt);
+    info.n_threads = m_opts.n_threads > 0
+                         ? m_opts.n_threads
+                         : std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < info.n_threads; ++i)
+      helpers.emplace_back(run_helper, std::ref(ctx.tt), ctx.tables, board,
+                           searcher.get_root_allowed(), std::ref(stop), i,
+                           m_opts.max_depth, m_opts.max_branching,
+                           m_eval_cache.get(), eval_salt,
+                           std::ref(helper_counters));
+
+    int score = 0;
+    const int n_empty = board.get_opts().max_moves - board.get_move_no();
+    for (int depth = 1; depth <= m_opts.max_depth; ++depth) {
+      int alpha = -INF, beta = INF;
+      if (depth > 2 && std::abs(score) < WIN_THRESHOLD) {
+        alpha = score - 150;
+        beta = score + 150;
+      }
+      int value;
+      while (true) {
+        value = searcher.search(depth, alpha, beta, 0);
+        if (searcher.is_stopped())
+          break;
+        if (value <= alpha && alpha > -INF)
+          alpha = -INF;
+        else if (value >= beta && beta < INF)
+          beta = INF;
+        else
+          break;
+      }
+      if (searcher.is_stopped())
+        break;
+      best = searcher.get_root_best();
+      score = value;
+      info.depth = depth;
+      info.score = score;
+      if (std::abs(score) >= WIN_THRESHOLD || depth >= n_empty)
+        break;
+      // the next iteration would hardly finish in time
+      if (Clock::now() - start > std::chrono::milliseconds(m_opts.time_ms / 2))
+        break;
+    }
+    if (best < 0)
+      best = searcher.get_root_best();
+    if (best < 0) {
+      for (int idx = 0; idx < n_cells && best < 0; ++idx)
+        if (board.is_empty(idx))
+          best = idx;
+    }
+  }
+
+  stop = true;
+  for (auto &helper : helpers)
+    helper.join();
+  info.nodes = searcher.get_nodes() + helper_counters.nodes;
+  info.tt_probes = searcher.get_tt_probes() + helper_counters.tt_probes;
+  info.tt_hits = searcher.get_tt_hits() + helper_counters.tt_hits;
+  info.tt_fill = ctx.tt.get_fill();
+  info.time_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  info.search_ms = info.time_ms - info.lookup_ms - info.threat_ms;
+  info.best = board.point(best);
+  ctx.last_info = info;
+  ctx.totals.add(info);
+  if (m_opts.verbose) {
+    std::cerr << "move " << state.get_move_no() << ": (" << info.best.x << ", "
+              << info.best.y << ") threads " << info.n_threads << " depth "
+              << info.depth << " score "
+              << info.score << " nodes " << info.nodes << " nps "
+              << long(info.get_nps()) << " tt hits "
+              << int(100 * info.get_tt_hit_rate()) << "%";
+    if (m_eval_cache)
+      std::cerr << " eval cache hits "
+                << int(100 * m_eval_cache->get_stats().get_hit_rate()) << "%";
+    std::cerr << " threat nodes " << info.threat_nodes
+              << (info.threat_win ? " (threat win)" : "")
+              << (info.book ? " (book)" : "")
+              << (info.tablebase ? " (tablebase)" : "") << '\n';
+  }
+  return info.best;
+}
+
+bool SearchEngine::get_move_stats(const SearchContext &ctx,
+                                  MoveStats &stats) const {
+  const SearchInfo &info = ctx.last_info;
+  if (info.best.x < 0)
+    return false;
+  stats.nodes = info.nodes;
+  stats.solver_nodes = info.threat_nodes;
+  stats.depth = info.depth;
+  stats.tt_probes = info.tt_probes;
+  stats.tt_hits = info.tt_hits;
+  stats.tt_fill = info.tt_fill;
+  stats.lookup_ms = info.lookup_ms;
+  stats.solver_ms = info.threat_ms;
+  stats.search_ms = info.search_ms;
+  stats.time_ms = info.time_ms;
+  return true;
+}
+
+std::vector<RankedLine> SearchEngine::get_top_lines(SearchContext &ctx,
+                                                   const State &state,
+                                                   int n_lines) {
+  const auto start = Clock::now();
+  std::vector<RankedLine> lines;
+  Board board(state);
+  const int n_cells = board.get_n_cells();
+  const Sign side = board.get_current_player();
+  if (n_lines <= 0 || state.get_status() == game::Status::ENDED ||
+      board.is_full())
+    return lines;
+  if (ctx.tt.get_size() == 0 || int(ctx.tables.history[0].size()) != n_cells)
+    start_game(ctx, state.get_opts(), side);
+  ctx.tables.age();
+  ctx.tt.new_generation();
+
+  std::atomic<bool> stop{false};
+  Searcher searcher(ctx.tt, ctx.tables, board,
+                    start + std::chrono::milliseconds(m_opts.time_ms), stop,
+                    true, m_opts.max_branching);
+  SearchInfo info;
+  if (state.get_status() == game::Status::LAST_MOVE) {
+    // the drawing replies first, every other move loses
+    int drawing = board.get_drawing_reply();
+    for (int idx = 0; idx < n_cells; ++idx) {
+      if (!board.is_empty(idx))
+        continue;
+      const bool draws = idx == drawing;
+      if (draws)
+        drawing = board.get_drawing_reply(idx + 1);
+      lines.push_back({board.point(idx), draws ? 0 : 1 - WIN_SCORE, 1, {}});
+    }
+    std::stable_sort(lines.begin(), lines.end(),
+                     [](const RankedLine &a, const RankedLine &b) {
+                       return a.score > b.score;
+                     });
+  } else {
+    if (m_opts.evaluator == Evaluator::PATTERNS ||
+        (m_opts.evaluator == Evaluator::NNUE && !board.enable_nnue(m_network)))
+      board.enable_patterns();
+    searcher.set_eval_cache(m_eval_cache.get(), get_eval_salt(board, m_opts));
+    searcher.generate(0, -1, board.has_line_threat(opp_sign(side)));
+    const std::vector<ScoredMove> root_moves = searcher.get_moves(0);
+    const int n_moves = std::min<int>(n_lines, root_moves.size());
+    // the static order until the first iteration is over
+    for (int i = 0; i < n_moves; ++i)
+      lines.push_back({board.point(root_moves[i].idx), 0, 0, {}});
+
+    const int n_empty = board.get_opts().max_moves - board.get_move_no();
+    for (int depth = 1; depth <= m_opts.max_depth; ++depth) {
+      std::vector<RankedLine> found;
+      std::vector<int> excluded;
+      for (int i = 0; i < n_moves; ++i) {
+        searcher.set_root_excluded(excluded);
+        const int value = searcher.search(depth, -INF, INF, 0);
+        if (searcher.is_stopped())
+          break;
+        const int best = searcher.get_root_best();
+        excluded.push_back(best);
+        found.push_back({board.point(best), value, depth, {}});
+      }
+      if (searcher.is_stopped())
+        break;
+      std::stable_sort(found.begin(), found.end(),
+                       [](const RankedLine &a, const RankedLine &b) {
+                         return a.score > b.score;
+                       });
+      lines = std::move(found);
+      info.depth = depth;
+      bool decided = true;
+      for (const auto &line : lines)
+        decided = decided && std::abs(line.score) >= WIN_THRESHOLD;
+      if (decided || depth >= n_empty)
+        break;
+      // the next iteration would hardly finish in time
+      if (Clock::now() - start > std::chrono::milliseconds(m_opts.time_ms / 2))
+        break;
+    }
+    searcher.set_root_excluded({});
+  }
+  if (int(lines.size()) > n_lines)
+    lines.resize(n_lines);
+  for (auto &line : lines)
+    line.pv = get_table_pv(ctx.tt, state, line.move, MAX_PLY);
+
+  info.nodes = searcher.get_nodes();
+  info.tt_probes = searcher.get_tt_probes();
+  info.tt_hits = searcher.get_tt_hits();
+  info.tt_fill = ctx.tt.get_fill();
+  info.time_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  info.search_ms = info.time_ms;
+  if (!lines.empty()) {
+    info.best = lines[0].move;
+    info.score = lines[0].score;
+  }
+  ctx.last_info = info;
+  ctx.totals.add(info);
+  return lines;
+}
+
+std::vector<Point> get_table_pv(const TranspositionTable &tt,
+                                const State &state, Point first,
+                                int max_len) {
+  std::vector<Point> pv;
+  Board board(state);
+  int idx = board.is_valid(first.x, first.y) ? board.index(first.x, first.y)
+                                             : -1;
+  while (int(pv.size()) < max_len) {
+    if (idx < 0 || idx >= board.get_n_cells() || !board.is_empty(idx))
+      break;
+    const bool line = board.completes_line(idx, board.get_current_player());
+    board.place(idx);
+    pv.push_back(board.point(idx));
+    TTEntry entry;
+    if (line || board.is_full() || !tt.probe(board.get_hash(), entry))
+      break;
+    idx = entry.move;
+  }
+  return pv;
+}
+
+SearchPlayer::SearchPlayer(const char *name, const SearchOpts &opts)
+    : EngineContext(std::make_shared<SearchEngine>(opts), name) {}
+
+SearchPlayer::SearchPlayer(std::shared_ptr<SearchEngine> engine,
+                           const char *name)
+    : EngineContext(std::move(engine), name) {}
+
+}; // namespace ttt::my_player
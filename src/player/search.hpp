@@ -0,0 +1,206 @@
+#pragma once
+
+#include "board.hpp"
+#include "book.hpp"
+#include "engine.hpp"
+#include "eval_cache.hpp"
+#include "nnue.hpp"
+#include "tablebase.hpp"
+#include "threat_solver.hpp"
+#include "tt.hpp"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ttt::my_player {
+
+// Static evaluation of the leaves.
+enum class Evaluator {
+  // window weights kept by `Board`
+  WINDOWS,
+  // pattern scores of all cells (see `PatternEvaluator`)
+  PATTERNS,
+  // the network of `SearchOpts::nnue_path` (see `NnueNetwork`)
+  NNUE,
+};
+
+struct SearchOpts {
+  int time_ms = 50;
+  int max_depth = 64;
+  int tt_size_mb = 16;
+  // keep the transposition table from game to game; entries of earlier
+  // searches age by generation instead
+  bool keep_tt = true;
+  // snapshot of the table, loaded when a context starts its first game and
+  // written at the end of every game; several contexts may share it
+  std::string tt_path;
+  // shared-memory segment holding the table instead of process memory, so
+  // that bot processes on one host share their results (see
+  // `TranspositionTable::attach_shared`); created with `tt_size_mb` by the
+  // first process, kept from game to game whatever `keep_tt` is. A private
+  // table is used where it cannot be attached.
+  std::string tt_shm_name;
+  // back the shared table with transparent huge pages where possible
+  bool tt_huge_pages = false;
+  // best-ordered moves searched below the root
+  int max_branching = 12;
+  // falls back to patterns where the network is missing or made for other
+  // options, and to windows where pattern tables do not support them
+  Evaluator evaluator = Evaluator::PATTERNS;
+  // network file for `Evaluator::NNUE`
+  std::string nnue_path;
+  // static evaluations kept in the process-wide cache of this size, shared
+  // by every engine asking for the same size (see `EvalCache`); 0 disables
+  int eval_cache_mb = 0;
+  // threads per move: the main one and helpers searching the same root
+  // (lazy SMP); 0 uses all hardware threads
+  int n_threads = 1;
+  // look for forced wins by threats of both sides before the search
+  bool use_threat_solver = true;
+  ThreatSolverOpts threat_opts;
+  // opening book file; its best move is played while the position is in it
+  std::string book_path;
+  // tablebase file (see `Tablebase`); its move is played in every position
+  // of a game with the options it was generated for
+  std::string tablebase_path;
+  // print depth, score and speed of every search to stderr
+  bool verbose = false;
+};
+
+// Result of one `make_move` search.
+struct SearchInfo {
+  int n_threads = 1;
+  int depth = 0;
+  int score = 0;
+  long long nodes = 0;
+  long long threat_nodes = 0;
+  // transposition table lookups of all threads and those which found the
+  // position
+  long long tt_probes = 0;
+  long long tt_hits = 0;
+  // the move wins by a forcing sequence found by the threat solver
+  bool threat_win = false;
+  // the move comes from the opening book
+  bool book = false;
+  // the move and its exact score come from the tablebase
+  bool tablebase = false;
+  // share of the table written by this search
+  double tt_fill = 0;
+  // time of the book and tablebase lookups, the threat solver and the main
+  // search
+  double lookup_ms = 0;
+  double threat_ms = 0;
+  double search_ms = 0;
+  double time_ms = 0;
+  Point best = {-1, -1};
+
+  double get_nps() const { return time_ms > 0 ? nodes / time_ms * 1000 : 0; }
+  double get_tt_hit_rate() const {
+    return tt_probes > 0 ? double(tt_hits) / tt_probes : 0;
+  }
+};
+
+// Search statistics accumulated over all moves of a context.
+struct SearchTotals {
+  int n_searches = 0;
+  int max_depth = 0;
+  long long depth_sum = 0;
+  long long nodes = 0;
+  long long tt_probes = 0;
+  long long tt_hits = 0;
+  double time_ms = 0;
+
+  void add(const SearchInfo &info);
+  double get_average_depth() const {
+    return n_searches > 0 ? double(depth_sum) / n_searches : 0;
+  }
+  double get_nps() const { return time_ms > 0 ? nodes / time_ms * 1000 : 0; }
+  double get_tt_hit_rate() const {
+    return tt_probes > 0 ? double(tt_hits) / tt_probes : 0;
+  }
+};
+
+// Scores are from the side to move; wins are `WIN_SCORE` minus the distance
+// to the end of the game in plies.
+const int WIN_SCORE = 1000000;
+const int MAX_PLY = 128;
+
+// Move ordering tables; every search thread has its own.
+struct OrderingTables {
+  std::array<std::array<int, 2>, MAX_PLY> killers;
+  std::array<std::vector<int>, 2> history;
+
+  void reset(int n_cells);
+  // Halves the history, so that older moves weigh less.
+  void age();
+};
+
+struct SearchContext : GameContext {
+  TranspositionTable tt;
+  ThreatSolver threats;
+  OrderingTables tables;
+  SearchInfo last_info;
+  SearchTotals totals;
+};
+
+// Iterative-deepening principal variation search with aspiration windows.
+// Moves are generated near existing marks and ordered by the transposition
+// table move, killer moves, history and the static gain of the move; forced
+// replies to a line threat do not consume depth. Before the search the threat
+// solver looks for a forced win of the side to move; if the opponent threatens
+// one, only moves which refute it are searched. With several threads the
+// helpers search the same root at staggered depths and share only the
+// transposition table; the main thread watches the time and stops them.
+// Per-game tables live in the context, so the engine itself is only read
+// while searching. The transposition table of a context outlives its games
+// (see `SearchOpts::keep_tt`).
+class SearchEngine : public EngineBase<SearchContext> {
+  SearchOpts m_opts;
+  OpeningBook m_book;
+  Tablebase m_tablebase;
+  NnueNetwork m_network;
+  std::shared_ptr<EvalCache> m_eval_cache;
+
+public:
+  SearchEngine(const SearchOpts &opts = SearchOpts());
+
+  const SearchOpts &get_opts() const { return m_opts; }
+  const OpeningBook &get_book() const { return m_book; }
+  const Tablebase &get_tablebase() const { return m_tablebase; }
+  const NnueNetwork &get_network() const { return m_network; }
+  // Null unless `SearchOpts::eval_cache_mb` is set.
+  const std::shared_ptr<EvalCache> &get_eval_cache() const {
+    return m_eval_cache;
+  }
+
+  void start_game(SearchContext &ctx, const State::Opts &opts, Sign sign);
+  void end_game(SearchContext &ctx, const State &state, MoveResult result);
+  Point make_move(SearchContext &ctx, const State &state);
+  bool get_move_stats(const SearchContext &ctx, MoveStats &stats) const;
+  // Multi-PV: every iteration searches the root again for each line with
+  // the moves of the lines before left out. The lines share the table, so
+  // the later ones mostly replay its entries and cost far less than the
+  // first. Runs on the calling thread only, without the book, tablebase or
+  // threat solver; `last_info` gets the totals and the first line.
+  std::vector<RankedLine> get_top_lines(SearchContext &ctx,
+                                        const State &state, int n_lines);
+};
+
+// The best move and the expected replies after it, following the table
+// moves; stops where the table has no move or the game is over.
+std::vector<Point> get_table_pv(const TranspositionTable &tt,
+                                const State &state, Point first,
+                                int max_len);
+
+class SearchPlayer : public EngineContext<SearchEngine> {
+public:
+  SearchPlayer(const char *name, const SearchOpts &opts = SearchOpts());
+  SearchPlayer(std::shared_ptr<SearchEngine> engine, const char *name);
+
+  const SearchInfo &get_last_info() { return get_context().last_info; }
+  const SearchTotals &get_totals() { return get_context().totals; }
+};
+
+}; // namespace ttt::my_player
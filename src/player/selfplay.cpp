@@ -0,0 +1,291 @@
+#include "selfplay.hpp"
+#include "board.hpp"
+#include "registry.hpp"
+#include "rng.hpp"
+#include "search.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace ttt::my_player {
+
+using Clock = std::chrono::steady_clock;
+
+int16_t to_dataset_score(int score) {
+  using dataset_format::MAX_SCORE;
+  if (score >= WIN_SCORE - MAX_PLY)
+    return MAX_SCORE;
+  if (score <= -(WIN_SCORE - MAX_PLY))
+    return -MAX_SCORE;
+  return int16_t(std::clamp(score, -MAX_SCORE + 1, MAX_SCORE - 1));
+}
+
+DatasetWriter::DatasetWriter(const std::string &prefix,
+                             const State::Opts &opts, int shard_games)
+    : m_prefix(prefix), m_opts(opts), m_shard_games(std::max(shard_games, 1)) {
+}
+
+template <class T> static void append(std::vector<char> &buffer, const T &v) {
+  const char *bytes = reinterpret_cast<const char *>(&v);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+bool DatasetWriter::add(const SelfPlayRecord &game) {
+  using namespace dataset_format;
+  Game header;
+  header.n_moves = uint16_t(game.cells.size());
+  header.winner = game.winner == Sign::X ? 1 : game.winner == Sign::O ? 2 : 0;
+  header.random_plies = uint8_t(std::min(game.random_plies, 255));
+
+  std::lock_guard lock(m_mutex);
+  append(m_buffer, header);
+  for (size_t i = 0; i < game.cells.size(); ++i)
+    append(m_buffer, Move{game.cells[i], game.scores[i]});
+  ++m_n_games;
+  m_n_positions += int(game.cells.size());
+  return m_n_games < m_shard_games || write_shard();
+}
+
+bool DatasetWriter::flush() {
+  std::lock_guard lock(m_mutex);
+  return m_n_games == 0 || write_shard();
+}
+
+int DatasetWriter::get_n_shards() const {
+  std::lock_guard lock(m_mutex);
+  return m_n_shards;
+}
+
+long long DatasetWriter::get_bytes() const {
+  std::lock_guard lock(m_mutex);
+  return m_bytes;
+}
+
+bool DatasetWriter::write_shard() {
+  using namespace dataset_format;
+  Header header = {};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.rows = m_opts.rows;
+  header.cols = m_opts.cols;
+  header.win_len = m_opts.win_len;
+  header.n_games = m_n_games;
+  header.n_positions = m_n_positions;
+
+  char name[32];
+  std::snprintf(name, sizeof(name), "-%05d.bin", m_n_shards);
+  std::ofstream out(m_prefix + name, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(m_buffer.data(), m_buffer.size());
+  m_bytes += sizeof(header) + m_buffer.size();
+  ++m_n_shards;
+  m_buffer.clear();
+  m_n_games = 0;
+  m_n_positions = 0;
+  return bool(out);
+}
+
+bool read_dataset_shard(const std::string &path, State::Opts &opts,
+                        std::vector<SelfPlayRecord> &games) {
+  using namespace dataset_format;
+  std::ifstream in(path, std::ios::binary);
+  Header header;
+  if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      header.version != VERSION)
+    return false;
+  opts = {int(header.rows), int(header.cols), int(header.win_len), 0};
+  const int n_cells = opts.rows * opts.cols;
+  for (uint32_t i = 0; i < header.n_games; ++i) {
+    Game game;
+    if (!in.read(reinterpret_cast<char *>(&game), sizeof(game)))
+      return false;
+    SelfPlayRecord record;
+    record.winner = game.winner == 1   ? Sign::X
+                    : game.winner == 2 ? Sign::O
+                                       : Sign::NONE;
+    record.random_plies = game.random_plies;
+    std::vector<Move> moves(game.n_moves);
+    if (!in.read(reinterpret_cast<char *>(moves.data()),
+                 moves.size() * sizeof(Move)))
+      return false;
+    for (const Move &move : moves) {
+      if (move.cell >= n_cells)
+        return false;
+      record.cells.push_back(move.cell);
+      record.scores.push_back(move.score);
+    }
+    games.push_back(std::move(record));
+  }
+  return true;
+}
+
+namespace {
+
+// Plays random moves near the marks for the first plies of a game, then
+// the wrapped player, and records every move with the player's search
+// score where it has one.
+class RecordingPlayer : public game::IPlayer {
+  game::IPlayer &m_base;
+  SelfPlayRecord *m_record = nullptr;
+  Rng m_rng;
+  int m_random_plies = 0;
+
+public:
+  RecordingPlayer(game::IPlayer &base) : m_base(base) {}
+
+  void start(SelfPlayRecord &record, uint64_t seed, int random_plies) {
+    m_record = &record;
+    m_rng.seed(seed);
+    m_random_plies = random_plies;
+  }
+
+  void set_sign(Sign sign) override { m_base.set_sign(sign); }
+  const char *get_name() const override { return m_base.get_name(); }
+  void on_game_start(const State::Opts &opts, Sign sign) override {
+    m_base.on_game_start(opts, sign);
+  }
+  void on_game_end(const State &state, game::MoveResult result) override {
+    m_base.on_game_end(state, result);
+  }
+  void handle_event(const State &state, const game::Event &event) override {
+    m_base.handle_event(state, event);
+  }
+
+  Point make_move(const State &state) override {
+    Point p;
+    int16_t score = dataset_format::NO_SCORE;
+    if (state.get_move_no() < m_random_plies) {
+      p = random_move(state);
+    } else {
+      p = m_base.make_move(state);
+      if (auto *search = dynamic_cast<SearchPlayer *>(&m_base))
+        score = to_dataset_score(search->get_last_info().score);
+    }
+    m_record->cells.push_back(uint16_t(p.x + p.y * state.get_opts().cols));
+    m_record->scores.push_back(score);
+    return p;
+  }
+
+private:
+  Point random_move(const State &state) {
+    Board board(state);
+    std::vector<int> cells;
+    for (int idx = 0; idx < board.get_n_cells(); ++idx)
+      if (board.is_candidate(idx))
+        cells.push_back(idx);
+    if (cells.empty()) {
+      // the first move: anywhere within two cells of the center
+      const int x = board.get_cols() / 2 + int(m_rng.below(5)) - 2;
+      const int y = board.get_rows() / 2 + int(m_rng.below(5)) - 2;
+      return {std::clamp(x, 0, board.get_cols() - 1),
+              std::clamp(y, 0, board.get_rows() - 1)};
+    }
+    return board.point(cells[m_rng.below(cells.size())]);
+  }
+};
+
+}; // namespace
+
+bool run_self_play(const SelfPlayOpts &opts, const std::string &prefix,
+                   SelfPlayStats &stats, std::string &error,
+                   std::ostream *log) {
+  auto &registry = PlayerRegistry::get();
+  for (const std::string &spec : {opts.player_x, opts.player_o})
+    if (!registry.create(spec, "check", error))
+      return false;
+
+  DatasetWriter writer(prefix, opts.board, opts.shard_games);
+  const int n_threads =
+      opts.n_threads > 0
+          ? opts.n_threads
+          : int(std::max(1u, std::thread::hardware_concurrency()));
+  const auto start = Clock::now();
+  std::atomic<int> next_game{0}, n_games{0}, n_errors{0};
+  std::atomic<long long> n_positions{0};
+  std::atomic<bool> write_failed{false};
+  std::mutex log_mutex;
+  auto last_log = start;
+
+  auto worker = [&](int id) {
+    std::string spec_error;
+    auto x = registry.create(opts.player_x, "X", spec_error);
+    auto o = registry.create(opts.player_o, "O", spec_error);
+    RecordingPlayer rx(*x), ro(*o);
+    game::Game game(opts.board);
+    game.add_player(Sign::X, &rx);
+    game.add_player(Sign::O, &ro);
+    SelfPlayRecord record;
+    for (int game_no; (game_no = next_game++) < opts.games;) {
+      record = SelfPlayRecord();
+      record.random_plies = opts.random_plies;
+      const uint64_t seed = derive_seed(opts.seed, game_no);
+      rx.start(record, derive_seed(seed, 0), opts.random_plies);
+      ro.start(record, derive_seed(seed, 1), opts.random_plies);
+      for (game::IPlayer *player : {x.get(), o.get()})
+        if (auto *seeded = dynamic_cast<ISeededPlayer *>(player))
+          seeded->set_next_game_no(game_no);
+      game::MoveResult result;
+      while ((result = game.process()) == game::MoveResult::OK)
+        ;
+      if (game::is_dq(result)) {
+        ++n_errors;
+      } else {
+        record.winner = result == game::MoveResult::DRAW
+                            ? Sign::NONE
+                            : game.get_state().get_winner();
+        if (!writer.add(record))
+          write_failed = true;
+        ++n_games;
+        n_positions += record.cells.size();
+      }
+      game.reset();
+
+      if (log && id == 0) {
+        std::lock_guard lock(log_mutex);
+        const auto now = Clock::now();
+        if (std::chrono::duration<double>(now - last_log).count() >=
+            opts.log_interval) {
+          last_log = now;
+          const double seconds =
+              std::chrono::duration<double>(now - start).count();
+          *log << n_games << "/" << opts.games << " games, "
+               << n_games / seconds << " games/s, " << n_positions / seconds
+               << " positions/s" << std::endl;
+        }
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int t = 1; t < n_threads; ++t)
+    threads.emplace_back(worker, t);
+  worker(0);
+  for (auto &thread : threads)
+    thread.join();
+  if (!writer.flush())
+    write_failed = true;
+
+  stats.games = n_games;
+  stats.errors = n_errors;
+  stats.positions = n_positions;
+  stats.shards = writer.get_n_shards();
+  stats.bytes = writer.get_bytes();
+  stats.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  if (log)
+    *log << stats.games << " games, " << stats.positions << " positions in "
+         << stats.shards << " shards (" << stats.bytes << " bytes), "
+         << stats.get_games_per_second() << " games/s, "
+         << stats.get_positions_per_second() << " positions/s" << std::endl;
+  if (write_failed) {
+    error = "cannot write shards of '" + prefix + "'";
+    return false;
+  }
+  return true;
+}
+
+}; // namespace ttt::my_player
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "core/game.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ttt::my_player {
+
+using game::Sign;
+using game::State;
+
+// Layout of a dataset shard: a header, then the games one after another,
+// each a `Game` followed by `n_moves` moves. A position is a prefix of the
+// moves of a game, labelled by the search score of the next move and the
+// result of the game, so it costs 4 bytes.
+namespace dataset_format {
+
+const char MAGIC[8] = {'T', 'T', 'T', 'D', 'A', 'T', 'A', '\0'};
+const uint32_t VERSION = 1;
+
+// scores of moves without a search (random openings, other engines)
+const int16_t NO_SCORE = INT16_MIN;
+// search scores are clipped to this; won positions score it exactly
+const int16_t MAX_SCORE = 32000;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t rows, cols, win_len;
+  uint32_t n_games;
+  uint32_t n_positions;
+  uint32_t reserved[2];
+};
+
+struct Game {
+  uint16_t n_moves;
+  // 0 for a draw, 1 if X won, 2 if O won
+  uint8_t winner;
+  // moves of the random opening
+  uint8_t random_plies;
+};
+
+struct Move {
+  uint16_t cell;
+  // from the side to move
+  int16_t score;
+};
+
+static_assert(sizeof(Header) == 40 && sizeof(Game) == 4 && sizeof(Move) == 4);
+
+}; // namespace dataset_format
+
+// One game of a dataset.
+struct SelfPlayRecord {
+  std::vector<uint16_t> cells;
+  std::vector<int16_t> scores;
+  Sign winner = Sign::NONE;
+  int random_plies = 0;
+};
+
+// Clips a search score to the dataset range.
+int16_t to_dataset_score(int score);
+
+// Appends games to numbered shards `<prefix>-00000.bin`, ... of at most
+// `shard_games` games each. Only the current shard is kept in memory; all
+// methods may be called from several threads.
+class DatasetWriter {
+public:
+  DatasetWriter(const std::string &prefix, const State::Opts &opts,
+                int shard_games);
+  ~DatasetWriter() { flush(); }
+
+  // False if a shard could not be written.
+  bool add(const SelfPlayRecord &game);
+  // Writes the current shard even if it is not full.
+  bool flush();
+
+  int get_n_shards() const;
+  long long get_bytes() const;
+
+private:
+  bool write_shard();
+
+  mutable std::mutex m_mutex;
+  std::string m_prefix;
+  State::Opts m_opts;
+  int m_shard_games;
+  std::vector<char> m_buffer;
+  int m_n_games = 0;
+  int m_n_positions = 0;
+  int m_n_shards = 0;
+  long long m_bytes = 0;
+};
+
+// Reads all games of a shard; false if it is missing or corrupt.
+bool read_dataset_shard(const std::string &path, State::Opts &opts,
+                        std::vector<SelfPlayRecord> &games);
+
+struct SelfPlayOpts {
+  // players as `PlayerRegistry` specs
+  std::string player_x = "search:time=10";
+  std::string player_o = "search:time=10";
+  State::Opts board = {15, 15, 5, 0};
+  int games = 100;
+  // threads with their own `Game` and players; 0 uses all hardware threads
+  int n_threads = 0;
+  // random moves near the marks at the start of every game
+  int random_plies = 4;
+  int shard_games = 10000;
+  uint64_t seed = 1;
+  // seconds between progress lines
+  double log_interval = 5;
+};
+
+struct SelfPlayStats {
+  int games = 0;
+  // games lost to disqualifications, not written
+  int errors = 0;
+  long long positions = 0;
+  int shards = 0;
+  long long bytes = 0;
+  double seconds = 0;
+
+  double get_games_per_second() const {
+    return seconds > 0 ? games / seconds : 0;
+  }
+  double get_positions_per_second() const {
+    return seconds > 0 ? positions / seconds : 0;
+  }
+};
+
+// Plays `opts.games` games on all threads and writes them under `prefix`,
+// reporting throughput to `log` if given. False with `error` set if a
+// player spec is wrong or a shard could not be written.
+bool run_self_play(const SelfPlayOpts &opts, const std::string &prefix,
+                   SelfPlayStats &stats, std::string &error,
+                   std::ostream *log = nullptr);
+
+}; // namespace ttt::my_player
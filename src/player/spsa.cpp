@@ -0,0 +1,120 @@
+#include "spsa.hpp"
+#include "rng.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace ttt::my_player {
+
+SpsaTuner::SpsaTuner(const SpsaOpts &opts) : m_opts(opts) {}
+
+std::string SpsaTuner::get_spec() const {
+  std::vector<double> values;
+  for (const SpsaParam &param : m_opts.params)
+    values.push_back(param.value);
+  return get_spec(values);
+}
+
+std::string SpsaTuner::get_spec(const std::vector<double> &values) const {
+  std::ostringstream spec;
+  spec << m_opts.engine;
+  char separator = m_opts.engine.find(':') == std::string::npos ? ':' : ',';
+  for (size_t i = 0; i < m_opts.params.size(); ++i) {
+    const SpsaParam &param = m_opts.params[i];
+    spec << separator << param.name << '=';
+    if (param.integer)
+      spec << std::lround(values[i]);
+    else
+      spec << values[i];
+    separator = ',';
+  }
+  return spec.str();
+}
+
+bool SpsaTuner::step(std::string &error, std::ostream *log) {
+  const int k = m_iteration + 1;
+  const double c_k = 1 / std::pow(k, m_opts.gamma);
+  const double a_k = std::pow(1 + m_opts.big_a, m_opts.alpha) /
+                     std::pow(k + m_opts.big_a, m_opts.alpha);
+
+  Rng rng(derive_seed(m_opts.seed, m_iteration));
+  std::vector<double> plus, minus, signs;
+  for (const SpsaParam &param : m_opts.params) {
+    const double sign = rng.below(2) ? 1 : -1;
+    const double delta = sign * param.c * c_k;
+    plus.push_back(std::clamp(param.value + delta, param.min, param.max));
+    minus.push_back(std::clamp(param.value - delta, param.min, param.max));
+    signs.push_back(sign);
+  }
+
+  MatchResult result;
+  if (!run_match(get_spec(plus), get_spec(minus), m_opts.match, result,
+                 error))
+    return false;
+  // in [-1, 1]: how much better the plus side did
+  const double gain = 2 * result.get_score() - 1;
+  for (size_t i = 0; i < m_opts.params.size(); ++i) {
+    SpsaParam &param = m_opts.params[i];
+    param.value = std::clamp(param.value + a_k * param.a * gain * signs[i],
+                             param.min, param.max);
+  }
+  ++m_iteration;
+
+  if (log) {
+    *log << "iteration " << m_iteration << ": +" << result.wins << " -"
+         << result.losses << " =" << result.draws << ", " << get_spec()
+         << std::endl;
+  }
+  if (!m_opts.checkpoint_path.empty() &&
+      !save_checkpoint(m_opts.checkpoint_path)) {
+    error = "cannot write checkpoint '" + m_opts.checkpoint_path + "'";
+    return false;
+  }
+  return true;
+}
+
+bool SpsaTuner::run(std::string &error, std::ostream *log) {
+  while (m_iteration < m_opts.iterations)
+    if (!step(error, log))
+      return false;
+  return true;
+}
+
+bool SpsaTuner::load_checkpoint(const std::string &path) {
+  std::ifstream in(path);
+  std::string word;
+  int iteration;
+  if (!(in >> word >> iteration) || word != "iteration" || iteration < 0)
+    return false;
+  std::string name;
+  double value;
+  while (in >> name >> value) {
+    for (SpsaParam &param : m_opts.params)
+      if (param.name == name)
+        param.value = std::clamp(value, param.min, param.max);
+  }
+  if (!in.eof())
+    return false;
+  m_iteration = iteration;
+  return true;
+}
+
+bool SpsaTuner::save_checkpoint(const std::string &path) const {
+  // a crash while writing leaves the previous checkpoint
+  const std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::trunc);
+    out.precision(17);
+    out << "iteration " << m_iteration << '\n';
+    for (const SpsaParam &param : m_opts.params)
+      out << param.name << ' ' << param.value << '\n';
+    if (!out)
+      return false;
+  }
+  return std::rename(tmp_path.c_str(), path.c_str()) == 0;
+}
+
+}; // namespace ttt::my_player
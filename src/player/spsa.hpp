@@ -0,0 +1,75 @@
+#pragma once
+
+#include "match.hpp"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ttt::my_player {
+
+// A numeric parameter of a player spec under tuning.
+struct SpsaParam {
+  std::string name;
+  double value = 0;
+  double min = 0, max = 0;
+  // perturbation of the first iteration; decays as `k^-gamma`
+  double c = 1;
+  // step of the first iteration for a match won by every game; decays as
+  // `(k + A)^-alpha`
+  double a = 1;
+  // passed rounded to the nearest integer
+  bool integer = false;
+};
+
+struct SpsaOpts {
+  // spec the parameters are appended to, e.g. "mcts:time=10"
+  std::string engine = "search:time=10";
+  std::vector<SpsaParam> params;
+  int iterations = 100;
+  // games per iteration between the two perturbed players
+  MatchOpts match;
+  double alpha = 0.602;
+  double gamma = 0.101;
+  // stability constant, about a tenth of the iterations
+  double big_a = 10;
+  uint64_t seed = 1;
+  // written after every iteration if not empty
+  std::string checkpoint_path;
+};
+
+// Simultaneous perturbation stochastic approximation over matches: every
+// iteration moves all parameters at once by `+-c_k` (random signs), plays a
+// match between the two perturbed players and steps every parameter
+// towards the side which scored more. A checkpoint keeps the iteration and
+// the values, so a stopped run continues where it was.
+class SpsaTuner {
+public:
+  SpsaTuner(const SpsaOpts &opts);
+
+  const SpsaOpts &get_opts() const { return m_opts; }
+  const std::vector<SpsaParam> &get_params() const { return m_opts.params; }
+  int get_iteration() const { return m_iteration; }
+
+  // The engine spec with the given values (the current ones by default).
+  std::string get_spec() const;
+  std::string get_spec(const std::vector<double> &values) const;
+
+  // Plays one iteration; false with `error` set if a spec is wrong or the
+  // checkpoint could not be written.
+  bool step(std::string &error, std::ostream *log = nullptr);
+  // Runs the remaining iterations.
+  bool run(std::string &error, std::ostream *log = nullptr);
+
+  // The checkpoint holds the iteration and `name value` lines; parameters
+  // missing from it keep their values. False if the file is missing or
+  // corrupt.
+  bool load_checkpoint(const std::string &path);
+  bool save_checkpoint(const std::string &path) const;
+
+private:
+  SpsaOpts m_opts;
+  int m_iteration = 0;
+};
+
+}; // namespace ttt::my_player
@@ -0,0 +1,585 @@
+#include "tablebase.hpp"
+#include "book.hpp"
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace ttt::my_player {
+
+namespace {
+
+State::Opts normalize(State::Opts opts) {
+  if (opts.max_moves == 0)
+    opts.max_moves = opts.rows * opts.cols;
+  return opts;
+}
+
+bool same_opts(const State::Opts &a, const State::Opts &b) {
+  return a.rows == b.rows && a.cols == b.cols && a.win_len == b.win_len &&
+         a.max_moves == b.max_moves;
+}
+
+std::vector<uint64_t> get_line_masks(const State::Opts &opts) {
+  static const int DIRS[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+  std::vector<uint64_t> lines;
+  for (const auto &dir : DIRS) {
+    for (int y = 0; y < opts.rows; ++y) {
+      for (int x = 0; x < opts.cols; ++x) {
+        const int ex = x + dir[0] * (opts.win_len - 1);
+        const int ey = y + dir[1] * (opts.win_len - 1);
+        if (ex < 0 || ex >= opts.cols || ey < 0 || ey >= opts.rows)
+          continue;
+        uint64_t mask = 0;
+        for (int i = 0; i < opts.win_len; ++i)
+          mask |= uint64_t(1) << (x + dir[0] * i + (y + dir[1] * i) *
+                                                        opts.cols);
+        lines.push_back(mask);
+      }
+    }
+  }
+  return lines;
+}
+
+bool has_line(const std::vector<uint64_t> &lines, uint64_t bits) {
+  for (uint64_t line : lines)
+    if ((bits & line) == line)
+      return true;
+  return false;
+}
+
+// The result of a finished game after `k` moves, following
+// `State::process_move`: O wins by completing a line, X needs O to miss the
+// reply (or the last allowed move), and a full board is a draw. False if the
+// game goes on.
+bool get_terminal(const std::vector<uint64_t> &lines, int max_moves,
+                  uint64_t x_bits, uint64_t o_bits, int k, TbEntry &entry) {
+  const bool x_line = has_line(lines, x_bits);
+  const bool o_line = has_line(lines, o_bits);
+  entry = {};
+  if (k % 2 == 0) {
+    // X to move, O has replied
+    if (o_line)
+      entry.result = x_line ? TbResult::DRAW : TbResult::LOSS;
+    else if (x_line)
+      entry.result = TbResult::WIN;
+    else if (k >= max_moves)
+      entry.result = TbResult::DRAW;
+  } else {
+    // O to move; a line of O ended the game before
+    if (o_line)
+      entry.result = TbResult::WIN;
+    else if (k >= max_moves)
+      entry.result = x_line ? TbResult::LOSS : TbResult::DRAW;
+  }
+  return entry.result != TbResult::UNKNOWN;
+}
+
+// The result in two bits, then the distance.
+int get_entry_bits(const State::Opts &opts) {
+  return 2 + std::bit_width(unsigned(opts.max_moves));
+}
+
+uint64_t encode(const TbEntry &entry) {
+  return uint64_t(entry.result) | uint64_t(entry.distance) << 2;
+}
+
+TbEntry decode(uint64_t value) {
+  return {TbResult(value & 3), int(value >> 2)};
+}
+
+uint64_t read_entry(const uint64_t *words, int bits, uint64_t index) {
+  const uint64_t pos = index * bits;
+  const uint64_t w = pos / 64;
+  const int shift = pos % 64;
+  uint64_t value = words[w] >> shift;
+  if (shift + bits > 64)
+    value |= words[w + 1] << (64 - shift);
+  return value & ((uint64_t(1) << bits) - 1);
+}
+
+// Entries of a table under construction; positions are written once, by
+// or-ing into zeroed words, so threads may share a word.
+class TbBuffer {
+public:
+  TbBuffer(uint64_t n_positions, int bits)
+      : m_bits(bits), m_n_words((n_positions * bits + 63) / 64),
+        m_words(new std::atomic<uint64_t>[m_n_words]) {
+    for (uint64_t w = 0; w < m_n_words; ++w)
+      m_words[w].store(0, std::memory_order_relaxed);
+  }
+
+  uint64_t get_n_words() const { return m_n_words; }
+  uint64_t get_word(uint64_t w) const {
+    return m_words[w].load(std::memory_order_relaxed);
+  }
+
+  TbEntry get(uint64_t index) const {
+    const uint64_t pos = index * m_bits;
+    const uint64_t w = pos / 64;
+    const int shift = pos % 64;
+    uint64_t value = get_word(w) >> shift;
+    if (shift + m_bits > 64)
+      value |= get_word(w + 1) << (64 - shift);
+    return decode(value & ((uint64_t(1) << m_bits) - 1));
+  }
+
+  void set(uint64_t index, const TbEntry &entry) {
+    const uint64_t value = encode(entry);
+    const uint64_t pos = index * m_bits;
+    const uint64_t w = pos / 64;
+    const int shift = pos % 64;
+    m_words[w].fetch_or(value << shift, std::memory_order_relaxed);
+    if (shift + m_bits > 64)
+      m_words[w + 1].fetch_or(value >> (64 - shift),
+                              std::memory_order_relaxed);
+  }
+
+private:
+  int m_bits;
+  uint64_t m_n_words;
+  std::unique_ptr<std::atomic<uint64_t>[]> m_words;
+};
+
+// Solves the layers of one table.
+class TbGenerator {
+public:
+  TbGenerator(const State::Opts &opts, int n_threads)
+      : m_index(opts), m_lines(get_line_masks(opts)),
+        m_n_threads(std::max(1, n_threads)),
+        m_buffer(m_index.get_n_positions(),
+                 get_entry_bits(m_index.get_opts())) {
+    const int n_cells = m_index.get_n_cells();
+    for (int sym = 1; sym < get_n_symmetries(opts); ++sym) {
+      std::vector<int> perm(n_cells);
+      for (int idx = 0; idx < n_cells; ++idx) {
+        const Point p = apply_symmetry(
+            opts, sym, Point{idx % opts.cols, idx / opts.cols});
+        perm[idx] = p.x + p.y * opts.cols;
+      }
+      m_perms.push_back(std::move(perm));
+    }
+  }
+
+  const TbIndex &get_index() const { return m_index; }
+  const TbBuffer &get_buffer() const { return m_buffer; }
+  uint64_t get_solved() const { return m_solved; }
+
+  void run() {
+    for (int k = m_index.get_opts().max_moves; k >= 0; --k) {
+      m_next = 0;
+      std::vector<std::thread> threads;
+      for (int t = 1; t < m_n_threads; ++t)
+        threads.emplace_back([this, k] { solve_layer(k); });
+      solve_layer(k);
+      for (auto &thread : threads)
+        thread.join();
+    }
+  }
+
+private:
+  static const uint64_t CHUNK = 4096;
+
+  uint64_t permute(const std::vector<int> &perm, uint64_t bits) const {
+    uint64_t result = 0;
+    for (; bits; bits &= bits - 1)
+      result |= uint64_t(1) << perm[std::countr_zero(bits)];
+    return result;
+  }
+
+  void solve_layer(int k) {
+    const uint64_t offset = m_index.get_layer_offset(k);
+    const uint64_t size = m_index.get_layer_size(k);
+    uint64_t solved = 0;
+    std::vector<uint64_t> images;
+    while (true) {
+      const uint64_t begin = m_next.fetch_add(CHUNK);
+      if (begin >= size)
+        break;
+      const uint64_t end = std::min(size, begin + CHUNK);
+      for (uint64_t r = offset + begin; r < offset + end; ++r) {
+        uint64_t x_bits, o_bits;
+        m_index.unrank(k, r - offset, x_bits, o_bits);
+        // only the smallest image is solved
+        images.clear();
+        bool canonical = true;
+        for (const auto &perm : m_perms) {
+          const uint64_t image =
+              m_index.rank(permute(perm, x_bits), permute(perm, o_bits));
+          if (image < r) {
+            canonical = false;
+            break;
+          }
+          images.push_back(image);
+        }
+        if (!canonical)
+          continue;
+        const TbEntry entry = solve(x_bits, o_bits, k);
+        m_buffer.set(r, entry);
+        for (size_t i = 0; i < images.size(); ++i) {
+          bool repeated = images[i] == r;
+          for (size_t j = 0; j < i && !repeated; ++j)
+            repeated = images[j] == images[i];
+          if (!repeated)
+            m_buffer.set(images[i], entry);
+        }
+        ++solved;
+      }
+    }
+    m_solved += solved;
+  }
+
+  TbEntry solve(uint64_t x_bits, uint64_t o_bits, int k) const {
+    TbEntry entry;
+    if (get_terminal(m_lines, m_index.get_opts().max_moves, x_bits, o_bits,
+                     k, entry))
+      return entry;
+    const uint64_t all = (uint64_t(1) << m_index.get_n_cells()) - 1;
+    uint64_t empty = all & ~(x_bits | o_bits);
+    int win_distance = -1, loss_distance = -1;
+    bool draw = false;
+    for (; empty; empty &= empty - 1) {
+      const uint64_t cell = empty & -empty;
+      const uint64_t child = k % 2 == 0 ? m_index.rank(x_bits | cell, o_bits)
+                                        : m_index.rank(x_bits, o_bits | cell);
+      const TbEntry reply = m_buffer.get(child);
+      if (reply.result == TbResult::LOSS) {
+        if (win_distance < 0 || reply.distance < win_distance)
+          win_distance = reply.distance;
+      } else if (reply.result == TbResult::DRAW) {
+        draw = true;
+      } else if (reply.distance > loss_distance) {
+        loss_distance = reply.distance;
+      }
+    }
+    if (win_distance >= 0)
+      return {TbResult::WIN, win_distance + 1};
+    if (draw)
+      return {TbResult::DRAW, 0};
+    return {TbResult::LOSS, loss_distance + 1};
+  }
+
+  TbIndex m_index;
+  std::vector<uint64_t> m_lines;
+  // cell permutations of the symmetries but the identity
+  std::vector<std::vector<int>> m_perms;
+  int m_n_threads;
+  TbBuffer m_buffer;
+  std::atomic<uint64_t> m_next{0};
+  std::atomic<uint64_t> m_solved{0};
+};
+
+}; // namespace
+
+const char *to_string(TbResult result) {
+  switch (result) {
+  case TbResult::WIN:
+    return "win";
+  case TbResult::LOSS:
+    return "loss";
+  case TbResult::DRAW:
+    return "draw";
+  default:
+    return "unknown";
+  }
+}
+
+TbIndex::TbIndex(const State::Opts &opts)
+    : m_opts(normalize(opts)), m_n_cells(opts.rows * opts.cols),
+      m_binomial(MAX_CELLS + 1, std::vector<uint64_t>(MAX_CELLS + 1, 0)) {
+  for (int n = 0; n <= MAX_CELLS; ++n) {
+    m_binomial[n][0] = 1;
+    for (int m = 1; m <= n; ++m)
+      m_binomial[n][m] = m_binomial[n - 1][m - 1] + m_binomial[n - 1][m];
+  }
+  m_offsets.push_back(0);
+  const int max_moves = std::min(m_opts.max_moves, m_n_cells);
+  for (int k = 0; k <= max_moves; ++k) {
+    const int nx = (k + 1) / 2, no = k / 2;
+    m_offsets.push_back(m_offsets.back() + m_binomial[m_n_cells][nx] *
+                                               m_binomial[m_n_cells - nx][no]);
+  }
+}
+
+bool TbIndex::supports(const State::Opts &opts) {
+  const State::Opts norm = normalize(opts);
+  const int n_cells = norm.rows * norm.cols;
+  if (norm.rows <= 0 || norm.cols <= 0 || n_cells > MAX_CELLS ||
+      norm.win_len <= 0 || norm.max_moves > n_cells)
+    return false;
+  return TbIndex(norm).get_n_positions() <= MAX_POSITIONS;
+}
+
+uint64_t TbIndex::rank_set(uint64_t bits) const {
+  uint64_t r = 0;
+  for (int i = 1; bits; bits &= bits - 1, ++i)
+    r += m_binomial[std::countr_zero(bits)][i];
+  return r;
+}
+
+uint64_t TbIndex::unrank_set(int n, int m, uint64_t r) const {
+  uint64_t bits = 0;
+  int c = n - 1;
+  for (int i = m; i > 0; --i) {
+    while (m_binomial[c][i] > r)
+      --c;
+    bits |= uint64_t(1) << c;
+    r -= m_binomial[c][i];
+    --c;
+  }
+  return bits;
+}
+
+uint64_t TbIndex::rank(uint64_t x_bits, uint64_t o_bits) const {
+  const int nx = std::popcount(x_bits), no = std::popcount(o_bits);
+  const int k = nx + no;
+  // O cells renumbered among the cells without X
+  uint64_t o_free = 0;
+  for (uint64_t bits = o_bits; bits; bits &= bits - 1) {
+    const uint64_t below = (bits & -bits) - 1;
+    o_free |= uint64_t(1) << std::popcount(below & ~x_bits);
+  }
+  return m_offsets[k] +
+         rank_set(x_bits) * m_binomial[m_n_cells - nx][no] +
+         rank_set(o_free);
+}
+
+void TbIndex::unrank(int k, uint64_t r, uint64_t &x_bits,
+                     uint64_t &o_bits) const {
+  const int nx = (k + 1) / 2, no = k / 2;
+  const uint64_t o_count = m_binomial[m_n_cells - nx][no];
+  x_bits = unrank_set(m_n_cells, nx, r / o_count);
+  const uint64_t o_free = unrank_set(m_n_cells - nx, no, r % o_count);
+  o_bits = 0;
+  int free_no = 0;
+  for (int c = 0; c < m_n_cells; ++c) {
+    if (x_bits >> c & 1)
+      continue;
+    if (o_free >> free_no & 1)
+      o_bits |= uint64_t(1) << c;
+    ++free_no;
+  }
+}
+
+bool Tablebase::generate(const State::Opts &opts, int n_threads,
+                         const std::string &path, TbGenerateStats &stats,
+                         std::string &error) {
+  using namespace tablebase_format;
+  if (!supports(opts)) {
+    error = "board is too large for a tablebase";
+    return false;
+  }
+  const auto start_time = std::chrono::steady_clock::now();
+  TbGenerator generator(opts, n_threads);
+  generator.run();
+  const TbIndex &index = generator.get_index();
+  const TbBuffer &buffer = generator.get_buffer();
+
+  stats = {};
+  stats.positions = index.get_n_positions();
+  stats.solved = generator.get_solved();
+  stats.start = buffer.get(0);
+  for (uint64_t r = 0; r < stats.positions; ++r) {
+    switch (buffer.get(r).result) {
+    case TbResult::WIN:
+      ++stats.wins;
+      break;
+    case TbResult::LOSS:
+      ++stats.losses;
+      break;
+    default:
+      ++stats.draws;
+    }
+  }
+
+  Header header = {};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  const State::Opts &norm = index.get_opts();
+  header.rows = norm.rows;
+  header.cols = norm.cols;
+  header.win_len = norm.win_len;
+  header.max_moves = norm.max_moves;
+  header.distance_bits = get_entry_bits(norm) - 2;
+  header.n_positions = index.get_n_positions();
+  header.n_words = buffer.get_n_words();
+
+  // written aside and renamed, so readers never map half a table
+  const std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    std::vector<uint64_t> words;
+    for (uint64_t w = 0; w < header.n_words && out; w += words.size()) {
+      words.clear();
+      for (uint64_t i = w; i < header.n_words && words.size() < 4096; ++i)
+        words.push_back(buffer.get_word(i));
+      out.write(reinterpret_cast<const char *>(words.data()),
+                words.size() * sizeof(uint64_t));
+    }
+    if (!out) {
+      error = "cannot write " + tmp_path;
+      return false;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    error = "cannot rename " + tmp_path + " to " + path;
+    return false;
+  }
+  stats.time_ms = std::chrono::duration<double, std::milli>(
+                      std::chrono::steady_clock::now() - start_time)
+                      .count();
+  return true;
+}
+
+bool Tablebase::open(const std::string &path) {
+  using namespace tablebase_format;
+  close();
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(Header)) {
+    ::close(fd);
+    return false;
+  }
+  void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED)
+    return false;
+  m_data = data;
+  m_size = st.st_size;
+
+  const auto *header = static_cast<const Header *>(m_data);
+  const State::Opts opts = {int(header->rows), int(header->cols),
+                            int(header->win_len), int(header->max_moves)};
+  if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      header->version != VERSION || !supports(opts) ||
+      header->max_moves == 0) {
+    close();
+    return false;
+  }
+  m_index = TbIndex(opts);
+  m_entry_bits = get_entry_bits(opts);
+  const uint64_t n_words =
+      (m_index.get_n_positions() * m_entry_bits + 63) / 64;
+  if (header->distance_bits + 2 != uint32_t(m_entry_bits) ||
+      header->n_positions != m_index.get_n_positions() ||
+      header->n_words != n_words ||
+      m_size < sizeof(Header) + n_words * sizeof(uint64_t)) {
+    close();
+    return false;
+  }
+  m_header = header;
+  m_words = reinterpret_cast<const uint64_t *>(header + 1);
+  m_lines = get_line_masks(opts);
+  return true;
+}
+
+void Tablebase::close() {
+  if (m_data)
+    munmap(m_data, m_size);
+  m_data = nullptr;
+  m_size = 0;
+  m_header = nullptr;
+  m_words = nullptr;
+  m_index = TbIndex();
+  m_entry_bits = 0;
+  m_lines.clear();
+}
+
+bool Tablebase::covers(const State::Opts &opts) const {
+  return m_header && same_opts(normalize(opts), m_index.get_opts());
+}
+
+TbEntry Tablebase::probe(uint64_t x_bits, uint64_t o_bits) const {
+  if (!m_header)
+    return {};
+  const int nx = std::popcount(x_bits), no = std::popcount(o_bits);
+  if (nx != no && nx != no + 1)
+    return {};
+  if (nx + no > m_index.get_opts().max_moves)
+    return {};
+  return decode(read_entry(m_words, m_entry_bits,
+                           m_index.rank(x_bits, o_bits)));
+}
+
+TbEntry Tablebase::probe(const State &state) const {
+  if (!covers(state.get_opts()))
+    return {};
+  const State::Opts &opts = state.get_opts();
+  uint64_t x_bits = 0, o_bits = 0;
+  for (int y = 0; y < opts.rows; ++y) {
+    for (int x = 0; x < opts.cols; ++x) {
+      const Sign sign = state.get_value(x, y);
+      if (sign == Sign::X)
+        x_bits |= uint64_t(1) << (x + y * opts.cols);
+      else if (sign == Sign::O)
+        o_bits |= uint64_t(1) << (x + y * opts.cols);
+    }
+  }
+  return probe(x_bits, o_bits);
+}
+
+TbEntry Tablebase::probe(const Board &board) const {
+  if (!covers(board.get_opts()))
+    return {};
+  uint64_t x_bits = 0, o_bits = 0;
+  for (int idx = 0; idx < board.get_n_cells(); ++idx) {
+    if (board.at(idx) == Sign::X)
+      x_bits |= uint64_t(1) << idx;
+    else if (board.at(idx) == Sign::O)
+      o_bits |= uint64_t(1) << idx;
+  }
+  return probe(x_bits, o_bits);
+}
+
+bool Tablebase::get_best_move(const Board &board, Point &move,
+                              TbEntry &entry) const {
+  entry = probe(board);
+  if (entry.result == TbResult::UNKNOWN)
+    return false;
+  uint64_t x_bits = 0, o_bits = 0;
+  for (int idx = 0; idx < board.get_n_cells(); ++idx) {
+    if (board.at(idx) == Sign::X)
+      x_bits |= uint64_t(1) << idx;
+    else if (board.at(idx) == Sign::O)
+      o_bits |= uint64_t(1) << idx;
+  }
+  const int k = board.get_move_no();
+  TbEntry terminal;
+  if (get_terminal(m_lines, m_index.get_opts().max_moves, x_bits, o_bits, k,
+                   terminal))
+    return false;
+
+  // the reply the value came from
+  TbResult wanted = TbResult::DRAW;
+  if (entry.result == TbResult::WIN)
+    wanted = TbResult::LOSS;
+  else if (entry.result == TbResult::LOSS)
+    wanted = TbResult::WIN;
+  const int distance = entry.result == TbResult::DRAW ? 0 : entry.distance - 1;
+  for (int idx = 0; idx < board.get_n_cells(); ++idx) {
+    if (!board.is_empty(idx))
+      continue;
+    const uint64_t cell = uint64_t(1) << idx;
+    const TbEntry reply = k % 2 == 0 ? probe(x_bits | cell, o_bits)
+                                     : probe(x_bits, o_bits | cell);
+    if (reply.result == wanted && reply.distance == distance) {
+      move = board.point(idx);
+      return true;
+    }
+  }
+  return false;
+}
+
+}; // namespace ttt::my_player
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "board.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ttt::my_player {
+
+// Game-theoretic value for the side to move.
+enum class TbResult : uint8_t { UNKNOWN, WIN, LOSS, DRAW };
+
+const char *to_string(TbResult result);
+
+struct TbEntry {
+  TbResult result = TbResult::UNKNOWN;
+  // plies to the end of the game with the winner hurrying and the loser
+  // delaying; 0 for draws and finished games
+  int distance = 0;
+};
+
+// Numbering of all positions of a board with `max_moves` moves at most.
+// Positions after `k` moves have `(k + 1) / 2` marks of X and `k / 2` of O;
+// they form layer `k`, numbered by the combination of X cells times the
+// combination of O cells among the free ones. So only positions with the
+// right mark counts get a number, and ranking one costs a few operations per
+// cell, whatever the size of the table.
+class TbIndex {
+public:
+  // Boards of up to `MAX_CELLS` cells and `MAX_POSITIONS` positions.
+  static const int MAX_CELLS = 25;
+  static const uint64_t MAX_POSITIONS = uint64_t(1) << 32;
+
+  TbIndex() = default;
+  explicit TbIndex(const State::Opts &opts);
+
+  static bool supports(const State::Opts &opts);
+
+  const State::Opts &get_opts() const { return m_opts; }
+  int get_n_cells() const { return m_n_cells; }
+  uint64_t get_n_positions() const { return m_offsets.back(); }
+  uint64_t get_layer_offset(int k) const { return m_offsets[k]; }
+  uint64_t get_layer_size(int k) const {
+    return m_offsets[k + 1] - m_offsets[k];
+  }
+
+  // Cells as bits `x + y * cols`.
+  uint64_t rank(uint64_t x_bits, uint64_t o_bits) const;
+  void unrank(int k, uint64_t r, uint64_t &x_bits, uint64_t &o_bits) const;
+
+private:
+  uint64_t rank_set(uint64_t bits) const;
+  uint64_t unrank_set(int n, int m, uint64_t r) const;
+
+  State::Opts m_opts = {};
+  int m_n_cells = 0;
+  // binomials C(n, m) for n, m <= MAX_CELLS
+  std::vector<std::vector<uint64_t>> m_binomial;
+  // first position of every layer and the total at the end
+  std::vector<uint64_t> m_offsets;
+};
+
+// Layout of a tablebase file: a header and the entries of all positions in
+// `TbIndex` order, packed into 64-bit words with `2 + distance_bits` bits
+// each (the result, then the distance).
+namespace tablebase_format {
+
+const char MAGIC[8] = {'T', 'T', 'T', 'T', 'B', 'A', 'S', 'E'};
+const uint32_t VERSION = 1;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t rows, cols, win_len, max_moves;
+  uint32_t distance_bits;
+  uint64_t n_positions;
+  uint64_t n_words;
+  uint32_t reserved[4];
+};
+
+static_assert(sizeof(Header) == 64);
+
+}; // namespace tablebase_format
+
+struct TbGenerateStats {
+  uint64_t positions = 0;
+  // positions solved; the other ones are symmetric images of them
+  uint64_t solved = 0;
+  // results of the empty board and their counts over all positions
+  TbEntry start;
+  uint64_t wins = 0, losses = 0, draws = 0;
+  double time_ms = 0;
+};
+
+// Perfect play for small boards. `generate` solves every position by
+// retrograde analysis: moves only add marks, so the positions after `k`
+// moves depend only on those after `k + 1`, and the layers are solved from
+// the last one back to the empty board, each split over the threads. Only
+// the smallest position of every set of symmetric images is solved; its
+// value is written to all of them, so probing needs no symmetry. A table
+// is opened by mapping the file into memory, and probes only touch the
+// pages of their entries; they may run from any number of threads.
+class Tablebase {
+public:
+  Tablebase() = default;
+  Tablebase(const Tablebase &) = delete;
+  Tablebase &operator=(const Tablebase &) = delete;
+  ~Tablebase() { close(); }
+
+  static bool supports(const State::Opts &opts) {
+    return TbIndex::supports(opts);
+  }
+  // Writes the table of `opts` to `path`; false with `error` set if the
+  // options are not supported or the file cannot be written.
+  static bool generate(const State::Opts &opts, int n_threads,
+                       const std::string &path, TbGenerateStats &stats,
+                       std::string &error);
+
+  // False if the file is missing or not a valid table.
+  bool open(const std::string &path);
+  void close();
+  bool is_open() const { return m_header != nullptr; }
+  const State::Opts &get_opts() const { return m_index.get_opts(); }
+  // True if the table is open and made for these options.
+  bool covers(const State::Opts &opts) const;
+
+  // UNKNOWN where the table does not cover the options.
+  TbEntry probe(const State &state) const;
+  TbEntry probe(const Board &board) const;
+  TbEntry probe(uint64_t x_bits, uint64_t o_bits) const;
+  // A move keeping the value: the fastest win, a draw or the slowest loss;
+  // false if the table does not cover the position or the game is over.
+  bool get_best_move(const Board &board, Point &move, TbEntry &entry) const;
+
+private:
+  void *m_data = nullptr;
+  size_t m_size = 0;
+  const tablebase_format::Header *m_header = nullptr;
+  const uint64_t *m_words = nullptr;
+  TbIndex m_index;
+  int m_entry_bits = 0;
+  // cell masks of all lines
+  std::vector<uint64_t> m_lines;
+};
+
+}; // namespace ttt::my_player
@@ -0,0 +1,135 @@
+#pragma once
+
+// The threat kernel of `ThreatMap`, written once over a vector type and
+// instantiated by every translation unit which needs it with the
+// instruction set that unit is compiled for. Internal to threat_map*.cpp.
+
+#include <cstdint>
+
+namespace ttt::my_player {
+
+// Rows of bits with `pad = win_len - 1` guard rows before the board and
+// `stride - rows + pad + 4` after it: the guard rows hold no marks and block
+// every window. The planes of rows `y_begin .. y_end - 1` are computed, both
+// multiples of 4 and at most `stride`.
+struct ThreatKernelArgs {
+  int win_len;
+  int y_begin, y_end;
+  // per sign: own marks and cells the sign cannot use (marks of the other
+  // sign and the bits right of the board); row `r` at index `r + pad`
+  const uint64_t *own[2];
+  const uint64_t *blocked[2];
+  // empty cells of the board, row `r` at index `r`, `stride + 4` rows
+  const uint64_t *empty;
+  // scratch rows of windows, per window type, `stride + 2 * pad + 4` rows
+  uint64_t *windows[3];
+  // output planes of `stride` rows each (see `ThreatMap::get_plane`)
+  uint64_t *planes;
+  int stride;
+};
+
+// The AVX2 kernel; false if the build does not include it.
+bool has_avx2_threat_kernel();
+void run_avx2_threat_kernel(const ThreatKernelArgs &args);
+
+namespace {
+
+template <class Ops> struct ThreatKernel {
+  using V = typename Ops::V;
+
+  // Bit-sliced counter of up to 31 planes.
+  struct Counter {
+    V bits[5];
+
+    Counter() {
+      for (V &bit : bits)
+        bit = Ops::zero();
+    }
+    void add(V plane) {
+      for (V &bit : bits) {
+        const V carry = Ops::and_(bit, plane);
+        bit = Ops::xor_(bit, plane);
+        plane = carry;
+      }
+    }
+    // Lanes where the count is `k`.
+    V equals(int k) const {
+      if (k < 0)
+        return Ops::zero();
+      V result = Ops::ones();
+      for (int b = 0; b < 5; ++b)
+        result = (k >> b) & 1 ? Ops::and_(result, bits[b])
+                              : Ops::andnot(bits[b], result);
+      return result;
+    }
+  };
+
+  static void run(const ThreatKernelArgs &args) {
+    static const int directions[4][2] = {{1, 0}, {0, 1}, {1, 1}, {-1, 1}};
+    const int len = args.win_len, pad = len - 1;
+    // windows with this many marks make each type
+    const int marks[3] = {len - 1, len - 2, len - 3};
+
+    for (int si = 0; si < 2; ++si) {
+      const uint64_t *own = args.own[si], *blocked = args.blocked[si];
+      for (int dir = 0; dir < 4; ++dir) {
+        const int dx = directions[dir][0], dy = directions[dir][1];
+
+        // windows by their first cell, for the first rows of the windows
+        // through the cells; windows leaving the board meet guard bits or
+        // rows
+        for (int y = args.y_begin - pad; y < args.y_end; y += Ops::LANES) {
+          Counter count;
+          V any_blocked = Ops::zero();
+          for (int i = 0; i < len; ++i) {
+            const int row = y + i * dy + pad;
+            V o = Ops::load(own + row), b = Ops::load(blocked + row);
+            if (dx > 0) {
+              o = Ops::shr(o, i);
+              b = Ops::shr(b, i);
+            } else if (dx < 0) {
+              // cells left of the board are blocked too
+              o = Ops::shl(o, i);
+              b = Ops::or_(Ops::shl(b, i),
+                           Ops::set1((uint64_t(1) << i) - 1));
+            }
+            any_blocked = Ops::or_(any_blocked, b);
+            count.add(o);
+          }
+          for (int t = 0; t < 3; ++t)
+            Ops::store(args.windows[t] + y + pad,
+                       Ops::andnot(any_blocked, count.equals(marks[t])));
+        }
+
+        // cells collect the windows through them
+        uint64_t *planes = args.planes + (si * 4 + dir) * 4 * args.stride;
+        for (int y = args.y_begin; y < args.y_end; y += Ops::LANES) {
+          V line = Ops::zero(), four = Ops::zero(), double_four = Ops::zero(),
+            three = Ops::zero();
+          for (int i = 0; i < len; ++i) {
+            const int row = y - i * dy + pad;
+            auto collect = [&](const uint64_t *windows) {
+              const V w = Ops::load(windows + row);
+              return dx > 0 ? Ops::shl(w, i) : dx < 0 ? Ops::shr(w, i) : w;
+            };
+            line = Ops::or_(line, collect(args.windows[0]));
+            const V w = collect(args.windows[1]);
+            double_four = Ops::or_(double_four, Ops::and_(four, w));
+            four = Ops::or_(four, w);
+            three = Ops::or_(three, collect(args.windows[2]));
+          }
+          const V empty = Ops::load(args.empty + y);
+          Ops::store(planes + y, Ops::and_(line, empty));
+          Ops::store(planes + args.stride + y, Ops::and_(four, empty));
+          Ops::store(planes + 2 * args.stride + y,
+                     Ops::and_(double_four, empty));
+          Ops::store(planes + 3 * args.stride + y, Ops::and_(three, empty));
+        }
+      }
+    }
+  }
+};
+
+}; // namespace
+
+}; // namespace ttt::my_player
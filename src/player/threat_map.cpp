@@ -0,0 +1,186 @@
+#include "threat_map.hpp"
+#include "threat_kernel.hpp"
+
+#include <algorithm>
+
+namespace ttt::my_player {
+
+namespace {
+
+struct ScalarOps {
+  using V = uint64_t;
+  static const int LANES = 1;
+
+  static V load(const uint64_t *p) { return *p; }
+  static void store(uint64_t *p, V v) { *p = v; }
+  static V zero() { return 0; }
+  static V ones() { return ~uint64_t(0); }
+  static V set1(uint64_t x) { return x; }
+  static V and_(V a, V b) { return a & b; }
+  static V or_(V a, V b) { return a | b; }
+  static V xor_(V a, V b) { return a ^ b; }
+  // ~a & b
+  static V andnot(V a, V b) { return ~a & b; }
+  static V shl(V v, int n) { return v << n; }
+  static V shr(V v, int n) { return v >> n; }
+};
+
+const int MAX_WIN_LEN = 31;
+
+}; // namespace
+
+SimdLevel detect_simd_level() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  if (has_avx2_threat_kernel() && __builtin_cpu_supports("avx2"))
+    return SimdLevel::AVX2;
+#endif
+  return SimdLevel::SCALAR;
+}
+
+const char *to_string(SimdLevel level) {
+  return level == SimdLevel::AVX2 ? "avx2" : "scalar";
+}
+
+bool ThreatMap::supports(const State::Opts &opts) {
+  return opts.rows > 0 && opts.cols > 0 && opts.win_len >= 2 &&
+         opts.win_len <= MAX_WIN_LEN && opts.cols + opts.win_len - 1 <= 64;
+}
+
+void ThreatMap::compute(const Bitboard &board) {
+  static const SimdLevel level = detect_simd_level();
+  compute(board, level);
+}
+
+void ThreatMap::compute(const Bitboard &board, SimdLevel level) {
+  m_opts = board.get_opts();
+  m_level = level;
+  const int rows = m_opts.rows, cols = m_opts.cols;
+  const int pad = m_opts.win_len - 1;
+  m_stride = (rows + 3) / 4 * 4;
+  m_row_mask = cols == 64 ? ~uint64_t(0) : (uint64_t(1) << cols) - 1;
+
+  m_padded = m_stride + 2 * pad + 4;
+  m_rows.assign(4 * m_padded + m_stride + 4 + 3 * m_padded, 0);
+  for (int si = 0; si < 2; ++si)
+    std::fill_n(blocked(si), m_padded, ~uint64_t(0));
+  for (int y = 0; y < rows; ++y)
+    read_row(board, y);
+
+  m_planes.assign(size_t(2) * N_THREAT_DIRECTIONS * N_THREAT_TYPES * m_stride,
+                  0);
+  run_kernel(0, m_stride);
+}
+
+void ThreatMap::update(const Bitboard &board, int idx) {
+  const int y = idx / m_opts.cols, pad = m_opts.win_len - 1;
+  read_row(board, y);
+  // the kernel does rows by four
+  const int y_begin = std::max(0, y - pad) / 4 * 4;
+  const int y_end = std::min(m_stride, (y + pad + 4) / 4 * 4);
+  run_kernel(y_begin, y_end);
+}
+
+// Reads row `y` of the board from the cell order of the bitboard.
+void ThreatMap::read_row(const Bitboard &board, int y) {
+  const int cols = m_opts.cols, pad = m_opts.win_len - 1;
+  uint64_t bits[2];
+  for (int si = 0; si < 2; ++si) {
+    const std::vector<uint64_t> &words =
+        board.get_bits(si ? Sign::O : Sign::X);
+    const int first = y * cols, word = first >> 6, shift = first & 63;
+    uint64_t row = words[word] >> shift;
+    if (shift > 0 && shift + cols > 64)
+      row |= words[word + 1] << (64 - shift);
+    bits[si] = row & m_row_mask;
+  }
+  for (int si = 0; si < 2; ++si) {
+    own(si)[y + pad] = bits[si];
+    blocked(si)[y + pad] = bits[1 - si] | ~m_row_mask;
+  }
+  empty()[y] = ~(bits[0] | bits[1]) & m_row_mask;
+}
+
+void ThreatMap::run_kernel(int y_begin, int y_end) {
+  ThreatKernelArgs args;
+  args.win_len = m_opts.win_len;
+  args.y_begin = y_begin;
+  args.y_end = y_end;
+  for (int si = 0; si < 2; ++si) {
+    args.own[si] = own(si);
+    args.blocked[si] = blocked(si);
+  }
+  args.empty = empty();
+  for (int t = 0; t < 3; ++t)
+    args.windows[t] = windows(t);
+  args.planes = m_planes.data();
+  args.stride = m_stride;
+  if (m_level == SimdLevel::AVX2 && has_avx2_threat_kernel())
+    run_avx2_threat_kernel(args);
+  else
+    ThreatKernel<ScalarOps>::run(args);
+}
+
+const uint64_t *ThreatMap::get_plane(Sign sign, int dir,
+                                     ThreatBit type) const {
+  int t = 0;
+  while ((1 << t) != type)
+    ++t;
+  return m_planes.data() +
+         ((sign_index(sign) * N_THREAT_DIRECTIONS + dir) * N_THREAT_TYPES + t) *
+             m_stride;
+}
+
+uint16_t ThreatMap::get_mask(int idx, Sign sign) const {
+  const int x = idx % m_opts.cols, y = idx / m_opts.cols;
+  const uint64_t *planes =
+      m_planes.data() + sign_index(sign) * N_THREAT_DIRECTIONS *
+                            N_THREAT_TYPES * m_stride;
+  uint16_t mask = 0;
+  for (int p = 0; p < N_THREAT_DIRECTIONS * N_THREAT_TYPES; ++p)
+    mask |= ((planes[p * m_stride + y] >> x) & 1) << p;
+  return mask;
+}
+
+uint16_t reference_threat_mask(const State &state, int x, int y, Sign sign) {
+  static const int directions[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+  const State::Opts &opts = state.get_opts();
+  const int len = opts.win_len;
+  if (state.get_value(x, y) != Sign::NONE)
+    return 0;
+  auto on_board = [&](int cx, int cy) {
+    return cx >= 0 && cx < opts.cols && cy >= 0 && cy < opts.rows;
+  };
+  uint16_t mask = 0;
+  for (int dir = 0; dir < N_THREAT_DIRECTIONS; ++dir) {
+    const int dx = directions[dir][0], dy = directions[dir][1];
+    int n_fours = 0;
+    // windows starting `back` cells before the cell
+    for (int back = 0; back < len; ++back) {
+      int marks = 0;
+      bool open = true;
+      for (int i = 0; i < len && open; ++i) {
+        const int cx = x + (i - back) * dx, cy = y + (i - back) * dy;
+        if (!on_board(cx, cy)) {
+          open = false;
+        } else {
+          const Sign s = state.get_value(cx, cy);
+          open = s != opp_sign(sign);
+          marks += s == sign;
+        }
+      }
+      if (!open)
+        continue;
+      if (marks == len - 1)
+        mask |= THREAT_LINE << (4 * dir);
+      if (marks == len - 2 && ++n_fours == 1)
+        mask |= THREAT_FOUR << (4 * dir);
+      if (marks == len - 2 && n_fours == 2)
+        mask |= THREAT_DOUBLE_FOUR << (4 * dir);
+      if (marks == len - 3)
+        mask |= THREAT_THREE << (4 * dir);
+    }
+  }
+  return mask;
+}
+
+}; // namespace ttt::my_player
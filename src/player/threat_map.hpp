@@ -0,0 +1,96 @@
+#pragma once
+
+#include "bitboard.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace ttt::my_player {
+
+// What a mark on an empty cell makes in one direction. A window is a run of
+// `win_len` cells on the board; it counts for a sign while it holds no mark
+// of the other one, so broken shapes count like solid ones.
+enum ThreatBit : uint8_t {
+  // a window with `win_len - 1` marks: the cell completes a line
+  THREAT_LINE = 1,
+  // a window with `win_len - 2` marks: the mark makes a four
+  THREAT_FOUR = 2,
+  // two such windows: the four has two cells to complete it (an open or
+  // double four)
+  THREAT_DOUBLE_FOUR = 4,
+  // a window with `win_len - 3` marks: the mark makes a three
+  THREAT_THREE = 8,
+};
+
+const int N_THREAT_TYPES = 4;
+// directions (1, 0), (0, 1), (1, 1), (1, -1), as in `Board`
+const int N_THREAT_DIRECTIONS = 4;
+
+// Instruction sets of the threat kernel.
+enum class SimdLevel { SCALAR, AVX2 };
+
+// The best level the running CPU supports (and the build includes).
+SimdLevel detect_simd_level();
+const char *to_string(SimdLevel level);
+
+// Threat masks of every cell for both signs in all four directions,
+// computed for the whole board at once from rows of bits. Windows are
+// counted by bit-sliced adders over shifted copies of the rows, so one pass
+// costs a few hundred word operations per row however many stones there
+// are; the AVX2 kernel does four rows per instruction. The kernel is picked
+// at run time, so one binary runs on any x86-64 CPU.
+class ThreatMap {
+public:
+  ThreatMap() = default;
+
+  // Rows of up to 64 bits with room for the window guard bits, and windows of
+  // up to 31 cells.
+  static bool supports(const State::Opts &opts);
+
+  // Recomputes all masks; the options must be supported.
+  void compute(const Bitboard &board);
+  void compute(const Bitboard &board, SimdLevel level);
+  // Recomputes the masks a mark placed or removed at `idx` changes, those of
+  // the rows within `win_len - 1` of it; `board` is the board of the last
+  // `compute` with that one change.
+  void update(const Bitboard &board, int idx);
+  SimdLevel get_level() const { return m_level; }
+  const State::Opts &get_opts() const { return m_opts; }
+
+  // Bits `THREAT_*` of direction `dir` at bits `4 * dir`; 0 for occupied
+  // cells.
+  uint16_t get_mask(int idx, Sign sign) const;
+  // The cells with a threat type in a direction, one row of bits per board
+  // row (bit x is cell x).
+  const uint64_t *get_plane(Sign sign, int dir, ThreatBit type) const;
+  // Marks of `sign` in row `y`, bit x is cell x.
+  uint64_t get_row(Sign sign, int y) const {
+    return own(sign_index(sign))[y + m_opts.win_len - 1];
+  }
+
+private:
+  void read_row(const Bitboard &board, int y);
+  void run_kernel(int y_begin, int y_end);
+
+  // kernel input rows (see `ThreatKernelArgs`), parts of `m_rows`
+  const uint64_t *own(int si) const { return m_rows.data() + si * m_padded; }
+  uint64_t *own(int si) { return m_rows.data() + si * m_padded; }
+  uint64_t *blocked(int si) { return own(2 + si); }
+  uint64_t *empty() { return own(4); }
+  uint64_t *windows(int t) { return empty() + m_stride + 4 + t * m_padded; }
+
+  State::Opts m_opts = {};
+  SimdLevel m_level = SimdLevel::SCALAR;
+  int m_stride = 0;
+  // rows of `own` and `blocked` with the guard rows
+  int m_padded = 0;
+  uint64_t m_row_mask = 0;
+  std::vector<uint64_t> m_rows;
+  std::vector<uint64_t> m_planes;
+};
+
+// Mask of the cell as `ThreatMap::get_mask` gives it, by reading the state
+// cell by cell; slow, for tests.
+uint16_t reference_threat_mask(const State &state, int x, int y, Sign sign);
+
+}; // namespace ttt::my_player
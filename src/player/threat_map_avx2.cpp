@@ -0,0 +1,58 @@
+// Built with -mavx2 where the compiler targets x86-64; only called after
+// `detect_simd_level` found AVX2 on the CPU.
+#include "threat_kernel.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace ttt::my_player {
+
+#if defined(__AVX2__)
+
+namespace {
+
+// Four rows per vector.
+struct Avx2Ops {
+  using V = __m256i;
+  static const int LANES = 4;
+
+  static V load(const uint64_t *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  }
+  static void store(uint64_t *p, V v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+  }
+  static V zero() { return _mm256_setzero_si256(); }
+  static V ones() { return _mm256_set1_epi64x(-1); }
+  static V set1(uint64_t x) { return _mm256_set1_epi64x(int64_t(x)); }
+  static V and_(V a, V b) { return _mm256_and_si256(a, b); }
+  static V or_(V a, V b) { return _mm256_or_si256(a, b); }
+  static V xor_(V a, V b) { return _mm256_xor_si256(a, b); }
+  // ~a & b
+  static V andnot(V a, V b) { return _mm256_andnot_si256(a, b); }
+  static V shl(V v, int n) {
+    return _mm256_sll_epi64(v, _mm_cvtsi32_si128(n));
+  }
+  static V shr(V v, int n) {
+    return _mm256_srl_epi64(v, _mm_cvtsi32_si128(n));
+  }
+};
+
+}; // namespace
+
+bool has_avx2_threat_kernel() { return true; }
+
+void run_avx2_threat_kernel(const ThreatKernelArgs &args) {
+  ThreatKernel<Avx2Ops>::run(args);
+}
+
+#else
+
+bool has_avx2_threat_kernel() { return false; }
+
+void run_avx2_threat_kernel(const ThreatKernelArgs &args) {}
+
+#endif
+
+}; // namespace ttt::my_player
@@ -0,0 +1,196 @@
+#include "threat_solver.hpp"
+
+#include <algorithm>
+
+namespace ttt::my_player {
+
+using Clock = std::chrono::steady_clock;
+
+ThreatSolver::ThreatSolver(const ThreatSolverOpts &opts) : m_opts(opts) {}
+
+ThreatSolution ThreatSolver::solve_vcf(const State &state, Sign attacker) {
+  Board board(state);
+  return solve(board, attacker, false);
+}
+
+ThreatSolution ThreatSolver::solve_vct(const State &state, Sign attacker) {
+  Board board(state);
+  return solve(board, attacker, true);
+}
+
+ThreatSolution ThreatSolver::solve_vcf(Board &board, Sign attacker) {
+  return solve(board, attacker, false);
+}
+
+ThreatSolution ThreatSolver::solve_vct(Board &board, Sign attacker) {
+  return solve(board, attacker, true);
+}
+
+ThreatSolution ThreatSolver::solve(Board &board, Sign attacker, bool vct) {
+  if (m_cache.size() > m_opts.max_cache_entries)
+    m_cache.clear();
+  m_board = &board;
+  m_attacker = attacker;
+  m_vct = vct;
+  m_aborted = false;
+  m_nodes = 0;
+  m_deadline = Clock::now() + std::chrono::milliseconds(m_opts.time_ms);
+  // two plies per attacker move and one more for checking a three
+  if (int(m_buffers.size()) < 2 * m_opts.max_depth + 4)
+    m_buffers.resize(2 * m_opts.max_depth + 4);
+
+  ThreatSolution solution;
+  // iterative deepening finds the shortest sequence first
+  for (int depth = 1; depth <= m_opts.max_depth; ++depth) {
+    int move = -1;
+    if (attack(depth, 0, move)) {
+      solution.result = ThreatResult::WIN;
+      solution.move = board.point(move);
+      break;
+    }
+    if (m_aborted) {
+      solution.result = ThreatResult::UNKNOWN;
+      break;
+    }
+  }
+  solution.nodes = m_nodes;
+  m_board = nullptr;
+  return solution;
+}
+
+bool ThreatSolver::out_of_budget() {
+  if (m_aborted)
+    return true;
+  ++m_nodes;
+  if (m_nodes > m_opts.max_nodes ||
+      ((m_nodes & 255) == 0 && Clock::now() >= m_deadline))
+    m_aborted = true;
+  return m_aborted;
+}
+
+uint64_t ThreatSolver::cache_key() const {
+  uint64_t key = m_board->get_hash();
+  if (m_attacker == Sign::O)
+    key ^= 0x6a09e667f3bcc908ULL;
+  if (m_vct)
+    key ^= 0xbb67ae8584caa73bULL;
+  return key;
+}
+
+bool ThreatSolver::attack(int depth, int ply, int &move) {
+  if (out_of_budget())
+    return false;
+  Board &b = *m_board;
+  const Sign att = m_attacker, def = opp_sign(att);
+  const int n_cells = b.get_n_cells(), len = b.get_win_len();
+
+  // a line right away; a line of X still lets O draw with a line of its own
+  for (int idx = 0; idx < n_cells; ++idx) {
+    if (!b.is_candidate(idx) || !b.completes_line(idx, att))
+      continue;
+    b.place(idx, att);
+    const bool won = att == Sign::O || !b.has_line_threat(Sign::O);
+    b.undo();
+    if (won) {
+      move = idx;
+      return true;
+    }
+  }
+  if (depth <= 0 || b.is_full())
+    return false;
+
+  const uint64_t key = cache_key();
+  auto it = m_cache.find(key);
+  if (it != m_cache.end()) {
+    if (it->second.win) {
+      move = it->second.move;
+      return true;
+    }
+    if (it->second.depth >= depth)
+      return false;
+  }
+
+  // fours first, then threes; a line threat of the defender must be blocked
+  auto &moves = m_buffers[ply];
+  moves.clear();
+  const bool must_block = b.has_line_threat(def);
+  for (int pass = 0; pass < (m_vct && len >= 4 ? 2 : 1); ++pass) {
+    for (int idx = 0; idx < n_cells; ++idx) {
+      if (!b.is_candidate(idx))
+        continue;
+      if (must_block && !b.completes_line(idx, def))
+        continue;
+      const bool four = b.has_window(idx, att, len - 2);
+      if (pass == 0 ? four : !four && b.has_window(idx, att, len - 3))
+        moves.push_back(idx);
+    }
+  }
+
+  for (size_t i = 0; i < moves.size(); ++i) {
+    const int idx = moves[i];
+    b.place(idx, att);
+    const bool won = defend(depth - 1, ply + 1, idx);
+    b.undo();
+    if (m_aborted)
+      return false;
+    if (won) {
+      m_cache[key] = {int16_t(idx), int8_t(depth), true};
+      move = idx;
+      return true;
+    }
+  }
+  m_cache[key] = {-1, int8_t(depth), false};
+  return false;
+}
+
+bool ThreatSolver::defend(int depth, int ply, int last_move) {
+  if (out_of_budget())
+    return false;
+  Board &b = *m_board;
+  const Sign att = m_attacker, def = opp_sign(att);
+  const int n_cells = b.get_n_cells(), len = b.get_win_len();
+
+  // a line of the defender wins (or at least draws) the game
+  if (b.has_line_threat(def) || b.is_full())
+    return false;
+
+  auto &replies = m_buffers[ply];
+  replies.clear();
+  b.collect_window_cells(last_move, att, len - 1, replies);
+  // a four of O answers a four of X too: O draws with a line of its own
+  // after the line of X
+  bool own_fours = att == Sign::X;
+  if (replies.empty()) {
+    if (!m_vct)
+      return false;
+    // a three is a threat only if the attacker wins by fours when ignored
+    int vcf_move = -1;
+    m_vct = false;
+    const bool real = attack(depth, ply + 1, vcf_move);
+    m_vct = true;
+    if (!real)
+      return false;
+    replies.push_back(vcf_move);
+    b.collect_window_cells(last_move, att, len - 2, replies);
+    own_fours = true;
+  }
+  if (own_fours)
+    for (int idx = 0; idx < n_cells; ++idx)
+      if (b.is_candidate(idx) && b.has_window(idx, def, len - 2))
+        replies.push_back(idx);
+  std::sort(replies.begin(), replies.end());
+  replies.erase(std::unique(replies.begin(), replies.end()), replies.end());
+
+  // the attack wins only if every reply loses
+  for (int idx : replies) {
+    b.place(idx, def);
+    int move = -1;
+    const bool won = attack(depth, ply + 1, move);
+    b.undo();
+    if (!won)
+      return false;
+  }
+  return true;
+}
+
+}; // namespace ttt::my_player
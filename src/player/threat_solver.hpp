@@ -0,0 +1,84 @@
+#pragma once
+
+#include "board.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ttt::my_player {
+
+struct ThreatSolverOpts {
+  // attacker moves in one forcing sequence
+  int max_depth = 10;
+  long long max_nodes = 50000;
+  int time_ms = 5;
+  // proof cache is cleared when it grows beyond this
+  size_t max_cache_entries = 1 << 18;
+};
+
+enum class ThreatResult {
+  WIN,     // the attacker wins by the sequence
+  NO_WIN,  // no forcing win within the depth
+  UNKNOWN, // node or time budget exhausted
+};
+
+struct ThreatSolution {
+  ThreatResult result = ThreatResult::NO_WIN;
+  Point move = {-1, -1};
+  long long nodes = 0;
+};
+
+// Threat-space search. The attacker only plays moves which make a four (a
+// window one mark short of a line; VCF, victory by continuous fours) or also
+// a three (two marks short; VCT, victory by continuous threats), the defender
+// only blocks those windows or answers with an own four. This is far
+// narrower than a full-width search, so forced wins many moves deep are found
+// within milliseconds. Proven wins and failures are kept in a cache which is
+// valid for the board options of one game.
+class ThreatSolver {
+public:
+  ThreatSolver(const ThreatSolverOpts &opts = ThreatSolverOpts());
+
+  const ThreatSolverOpts &get_opts() const { return m_opts; }
+  void set_opts(const ThreatSolverOpts &opts) { m_opts = opts; }
+
+  // The attacker does not have to be the side to move: solving for the
+  // opponent tells whether it threatens a forced win.
+  ThreatSolution solve_vcf(const State &state, Sign attacker);
+  ThreatSolution solve_vct(const State &state, Sign attacker);
+  ThreatSolution solve_vcf(Board &board, Sign attacker);
+  ThreatSolution solve_vct(Board &board, Sign attacker);
+
+  void clear_cache() { m_cache.clear(); }
+  size_t get_cache_size() const { return m_cache.size(); }
+
+private:
+  struct CacheEntry {
+    int16_t move;
+    int8_t depth;
+    bool win;
+  };
+
+  ThreatSolution solve(Board &board, Sign attacker, bool vct);
+  bool attack(int depth, int ply, int &move);
+  bool defend(int depth, int ply, int last_move);
+  bool out_of_budget();
+  uint64_t cache_key() const;
+
+  ThreatSolverOpts m_opts;
+  std::unordered_map<uint64_t, CacheEntry> m_cache;
+
+  // state of the current solve
+  Board *m_board = nullptr;
+  Sign m_attacker = Sign::NONE;
+  bool m_vct = false;
+  bool m_aborted = false;
+  long long m_nodes = 0;
+  std::chrono::steady_clock::time_point m_deadline;
+  // moves of every ply, allocated before the solve
+  std::vector<std::vector<int>> m_buffers;
+};
+
+}; // namespace ttt::my_player
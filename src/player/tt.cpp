@@ -0,0 +1,441 @@
+#include "tt.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace ttt::my_player {
+
+namespace {
+
+const char SNAPSHOT_MAGIC[8] = {'T', 'T', 'T', 'T', 'T', 'A', 'B', '\0'};
+const uint32_t SNAPSHOT_VERSION = 1;
+
+// followed by the words of all buckets
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t generation;
+  uint64_t n_buckets;
+};
+
+const char SHARED_MAGIC[8] = {'T', 'T', 'T', 'T', 'S', 'H', 'M', '\0'};
+// bump on any change of the header, the bucket layout or the entry packing
+const uint32_t SHARED_VERSION = 1;
+const uint32_t SHARED_READY = 1;
+const size_t HUGE_PAGE_SIZE = size_t(2) << 20;
+const int SHARED_WAIT_MS = 1000;
+
+// Start of a shared segment, followed by the buckets. The first three
+// fields keep their place in every version, so that any process can wait
+// for a segment and tell its version.
+struct alignas(64) SharedHeader {
+  char magic[8];
+  uint32_t version;
+  // `SHARED_READY` once the creator has filled the header
+  std::atomic<uint32_t> state;
+  uint32_t bucket_bytes;
+  uint32_t bucket_size;
+  uint32_t n_generations;
+  std::atomic<uint32_t> generation;
+  uint64_t n_buckets;
+  std::atomic<uint32_t> n_attached;
+};
+
+static_assert(sizeof(SharedHeader) == 64);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+size_t fit_buckets(size_t size_mb, size_t bucket_bytes) {
+  size_t n_buckets = 1;
+  while (n_buckets * 2 * bucket_bytes <= size_mb * 1024 * 1024)
+    n_buckets *= 2;
+  return n_buckets;
+}
+
+std::string get_errno_text() { return std::strerror(errno); }
+
+}; // namespace
+
+struct TranspositionTable::SharedSegment {
+  void *data = nullptr;
+  size_t size = 0;
+
+  SharedHeader *get_header() const {
+    return static_cast<SharedHeader *>(data);
+  }
+  ~SharedSegment() {
+    get_header()->n_attached.fetch_sub(1, std::memory_order_relaxed);
+    munmap(data, size);
+  }
+};
+
+TranspositionTable::TranspositionTable() = default;
+
+TranspositionTable::TranspositionTable(TranspositionTable &&other) {
+  *this = std::move(other);
+}
+
+TranspositionTable &TranspositionTable::operator=(TranspositionTable &&other) {
+  if (this != &other) {
+    m_buckets = std::exchange(other.m_buckets, nullptr);
+    m_owned = std::move(other.m_owned);
+    m_segment = std::move(other.m_segment);
+    m_n_buckets = std::exchange(other.m_n_buckets, 0);
+    m_generation = other.m_generation;
+  }
+  return *this;
+}
+
+TranspositionTable::~TranspositionTable() = default;
+
+void TranspositionTable::resize(size_t size_mb) {
+  const size_t n_buckets = fit_buckets(size_mb, sizeof(Bucket));
+  if (m_segment)
+    detach();
+  if (n_buckets != m_n_buckets) {
+    m_owned.reset(new Bucket[n_buckets]);
+    m_buckets = m_owned.get();
+    m_n_buckets = n_buckets;
+    clear();
+  }
+}
+
+void TranspositionTable::new_generation() {
+  if (m_segment) {
+    const uint32_t generation = m_segment->get_header()->generation.fetch_add(
+        1, std::memory_order_relaxed);
+    m_generation = uint8_t((generation + 1) % N_GENERATIONS);
+  } else {
+    m_generation = (m_generation + 1) % N_GENERATIONS;
+  }
+}
+
+void TranspositionTable::clear() {
+  for (size_t b = 0; b < m_n_buckets; ++b)
+    for (auto &word : m_buckets[b].words)
+      word.store(0, std::memory_order_relaxed);
+}
+
+uint64_t TranspositionTable::pack(const TTEntry &entry) {
+  return uint64_t(uint32_t(entry.score)) |
+         uint64_t(uint16_t(entry.move)) << 32 |
+         uint64_t(uint8_t(entry.depth)) << 48 |
+         uint64_t(entry.bound) << 56 | uint64_t(entry.generation) << 58;
+}
+
+TTEntry TranspositionTable::unpack(uint64_t key, uint64_t data) {
+  TTEntry entry;
+  entry.key = key;
+  entry.score = int32_t(uint32_t(data));
+  entry.move = int16_t(uint16_t(data >> 32));
+  entry.depth = int8_t(uint8_t(data >> 48));
+  entry.bound = Bound((data >> 56) & 3);
+  entry.generation = uint8_t(data >> 58);
+  return entry;
+}
+
+bool TranspositionTable::read(const Bucket &bucket, int i, uint64_t &key,
+                              TTEntry &entry) {
+  const uint64_t stored = bucket.words[2 * i].load(std::memory_order_relaxed);
+  const uint64_t data = bucket.words[2 * i + 1].load(std::memory_order_relaxed);
+  if (data == 0)
+    return false;
+  key = stored ^ data;
+  entry = unpack(key, data);
+  return entry.bound != Bound::NONE;
+}
+
+double TranspositionTable::get_fill() const {
+  const size_t n_buckets =
+      std::min<size_t>(m_n_buckets, FILL_SAMPLE / BUCKET_SIZE);
+  if (n_buckets == 0)
+    return 0;
+  int used = 0;
+  for (size_t b = 0; b < n_buckets; ++b) {
+    for (int i = 0; i < BUCKET_SIZE; ++i) {
+      uint64_t key;
+      TTEntry entry;
+      if (read(m_buckets[b], i, key, entry) &&
+          entry.generation == m_generation)
+        ++used;
+    }
+  }
+  return double(used) / (n_buckets * BUCKET_SIZE);
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry &entry) const {
+  if (m_n_buckets == 0)
+    return false;
+  const Bucket &bucket = m_buckets[key & (m_n_buckets - 1)];
+  for (int i = 0; i < BUCKET_SIZE; ++i) {
+    uint64_t slot_key;
+    if (read(bucket, i, slot_key, entry) && slot_key == key)
+      return true;
+  }
+  return false;
+}
+
+void TranspositionTable::store(uint64_t key, int depth, int score, Bound bound,
+                               int move) {
+  if (m_n_buckets == 0)
+    return;
+  Bucket &bucket = m_buckets[key & (m_n_buckets - 1)];
+  int slot = 0, slot_value = 1 << 30;
+  TTEntry old;
+  bool same = false;
+  for (int i = 0; i < BUCKET_SIZE; ++i) {
+    uint64_t slot_key;
+    TTEntry entry;
+    if (!read(bucket, i, slot_key, entry)) {
+      if (slot_value > -(1 << 30)) {
+        slot = i;
+        slot_value = -(1 << 30);
+      }
+      continue;
+    }
+    if (slot_key == key) {
+      slot = i;
+      old = entry;
+      same = true;
+      break;
+    }
+    const int age =
+        (N_GENERATIONS + m_generation - entry.generation) % N_GENERATIONS;
+    const int value = entry.depth - 4 * age;
+    if (value < slot_value) {
+      slot = i;
+      slot_value = value;
+    }
+  }
+  if (same) {
+    // a shallower bound of the current search does not replace an exact one
+    if (old.generation == m_generation && old.depth > depth &&
+        bound != Bound::EXACT)
+      return;
+    if (move < 0)
+      move = old.move;
+  }
+
+  TTEntry entry;
+  entry.score = score;
+  entry.move = move;
+  entry.depth = depth;
+  entry.bound = bound;
+  entry.generation = m_generation;
+  const uint64_t data = pack(entry);
+  bucket.words[2 * slot].store(key ^ data, std::memory_order_relaxed);
+  bucket.words[2 * slot + 1].store(data, std::memory_order_relaxed);
+}
+
+bool TranspositionTable::save(const std::string &path) const {
+  SnapshotHeader header = {};
+  std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  header.version = SNAPSHOT_VERSION;
+  header.generation = m_generation;
+  header.n_buckets = m_n_buckets;
+
+  // written aside and renamed, so readers never see half a snapshot; the
+  // name is unique to the thread, as several contexts may save to one path
+  const std::string tmp_path =
+      path + ".tmp." + std::to_string(getpid()) + "." +
+      std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    uint64_t words[2 * BUCKET_SIZE];
+    for (size_t b = 0; b < m_n_buckets && out; ++b) {
+      for (int i = 0; i < 2 * BUCKET_SIZE; ++i)
+        words[i] = m_buckets[b].words[i].load(std::memory_order_relaxed);
+      out.write(reinterpret_cast<const char *>(words), sizeof(words));
+    }
+    out.close();
+    if (!out) {
+      std::remove(tmp_path.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool TranspositionTable::load(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  SnapshotHeader header;
+  if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+      header.version != SNAPSHOT_VERSION || header.n_buckets != m_n_buckets ||
+      header.generation >= N_GENERATIONS)
+    return false;
+  std::vector<uint64_t> words(2 * BUCKET_SIZE * m_n_buckets);
+  if (!in.read(reinterpret_cast<char *>(words.data()),
+               words.size() * sizeof(uint64_t)))
+    return false;
+  const uint64_t *word = words.data();
+  for (size_t b = 0; b < m_n_buckets; ++b)
+    for (auto &slot : m_buckets[b].words)
+      slot.store(*word++, std::memory_order_relaxed);
+  m_generation = uint8_t(header.generation);
+  if (m_segment)
+    m_segment->get_header()->generation.store(m_generation,
+                                              std::memory_order_relaxed);
+  return true;
+}
+
+bool TranspositionTable::attach_shared(const std::string &name,
+                                       size_t size_mb, bool huge_pages,
+                                       std::string &error) {
+  detach();
+  m_owned.reset();
+  m_buckets = nullptr;
+  m_n_buckets = 0;
+
+  bool created = true;
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0 && errno == EEXIST) {
+    created = false;
+    fd = shm_open(name.c_str(), O_RDWR, 0);
+  }
+  if (fd < 0) {
+    error = "cannot open shared memory " + name + ": " + get_errno_text();
+    return false;
+  }
+
+  const size_t n_buckets = fit_buckets(size_mb, sizeof(Bucket));
+  size_t size = 0;
+  if (created) {
+    size = sizeof(SharedHeader) + n_buckets * sizeof(Bucket);
+    if (huge_pages)
+      size = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    // reserved up front, so that a full /dev/shm fails here and not with
+    // SIGBUS in the middle of a search
+    const int code = ftruncate(fd, off_t(size)) != 0
+                         ? errno
+                         : posix_fallocate(fd, 0, off_t(size));
+    if (code != 0) {
+      error = "cannot reserve " + std::to_string(size >> 20) +
+              " MB of shared memory " + name + ": " + std::strerror(code);
+      close(fd);
+      shm_unlink(name.c_str());
+      return false;
+    }
+  } else {
+    // the creator may not have sized the segment yet
+    struct stat st;
+    for (int ms = 0; ms < SHARED_WAIT_MS; ++ms) {
+      if (fstat(fd, &st) != 0 || size_t(st.st_size) >= sizeof(SharedHeader))
+        break;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    size = size_t(st.st_size);
+    if (size < sizeof(SharedHeader)) {
+      error = "shared memory " + name + " is not a transposition table";
+      close(fd);
+      return false;
+    }
+  }
+
+  void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    error = "cannot map shared memory " + name + ": " + get_errno_text();
+    if (created)
+      shm_unlink(name.c_str());
+    return false;
+  }
+  // a hint: shared memory takes huge pages only where
+  // /sys/kernel/mm/transparent_hugepage/shmem_enabled allows it
+  if (huge_pages)
+    madvise(data, size, MADV_HUGEPAGE);
+
+  SharedHeader *header;
+  if (created) {
+    // fresh pages are zero, that is empty entries
+    header = new (data) SharedHeader();
+    std::memcpy(header->magic, SHARED_MAGIC, sizeof(SHARED_MAGIC));
+    header->version = SHARED_VERSION;
+    header->bucket_bytes = sizeof(Bucket);
+    header->bucket_size = BUCKET_SIZE;
+    header->n_generations = N_GENERATIONS;
+    header->n_buckets = n_buckets;
+    header->n_attached.store(1, std::memory_order_relaxed);
+    header->state.store(SHARED_READY, std::memory_order_release);
+  } else {
+    header = static_cast<SharedHeader *>(data);
+    for (int ms = 0; ms < SHARED_WAIT_MS; ++ms) {
+      if (header->state.load(std::memory_order_acquire) == SHARED_READY)
+        break;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const size_t shared_buckets = header->n_buckets;
+    std::string problem;
+    if (header->state.load(std::memory_order_acquire) != SHARED_READY) {
+      problem = "shared memory " + name + " was not initialized in time";
+    } else if (std::memcmp(header->magic, SHARED_MAGIC,
+                           sizeof(SHARED_MAGIC)) != 0) {
+      problem = "shared memory " + name + " is not a transposition table";
+    } else if (header->version != SHARED_VERSION) {
+      problem = "shared memory " + name + " has layout version " +
+                std::to_string(header->version) + ", expected " +
+                std::to_string(SHARED_VERSION);
+    } else if (header->bucket_bytes != sizeof(Bucket) ||
+               header->bucket_size != BUCKET_SIZE ||
+               header->n_generations != N_GENERATIONS) {
+      problem = "shared memory " + name + " was made by another build";
+    } else if (shared_buckets == 0 ||
+               (shared_buckets & (shared_buckets - 1)) != 0 ||
+               shared_buckets >
+                   (size - sizeof(SharedHeader)) / sizeof(Bucket)) {
+      problem = "shared memory " + name + " is truncated";
+    }
+    if (!problem.empty()) {
+      error = problem;
+      munmap(data, size);
+      return false;
+    }
+    header->n_attached.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  m_segment = std::make_unique<SharedSegment>();
+  m_segment->data = data;
+  m_segment->size = size;
+  m_buckets = reinterpret_cast<Bucket *>(static_cast<char *>(data) +
+                                         sizeof(SharedHeader));
+  m_n_buckets = header->n_buckets;
+  m_generation = uint8_t(header->generation.load(std::memory_order_relaxed) %
+                         N_GENERATIONS);
+  return true;
+}
+
+void TranspositionTable::detach() {
+  if (!m_segment)
+    return;
+  m_segment.reset();
+  m_buckets = nullptr;
+  m_n_buckets = 0;
+}
+
+int TranspositionTable::get_attached() const {
+  return m_segment ? int(m_segment->get_header()->n_attached.load(
+                         std::memory_order_relaxed))
+                   : 0;
+}
+
+bool TranspositionTable::remove_shared(const std::string &name) {
+  return shm_unlink(name.c_str()) == 0;
+}
+
+}; // namespace ttt::my_player
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace ttt::my_player {
+
+enum class Bound : uint8_t { NONE, EXACT, LOWER, UPPER };
+
+struct TTEntry {
+  uint64_t key = 0;
+  int32_t score = 0;
+  int16_t move = -1;
+  int8_t depth = -1;
+  Bound bound = Bound::NONE;
+  // search generation which stored the entry
+  uint8_t generation = 0;
+};
+
+// Position hash -> search result, shared by all threads of a search without
+// locks. Entries are grouped in buckets of one cache line. An entry is two
+// words, the key XOR-ed with the packed data and the data itself; a torn
+// write by another thread fails the XOR check and reads as a miss. A store
+// goes to the slot of the same position, else to the slot with the lowest
+// depth, where entries of older generations count as shallower. Keys cover
+// the board options, so one table serves games of any size and survives from
+// game to game.
+//
+// The buckets may also live in a named POSIX shared-memory segment, so that
+// bot processes on one host share their results (see `attach_shared`). The
+// segment starts with a header of the layout version and the table size;
+// a process creating it fills the header and marks it ready last, and a
+// process attaching to it waits for that and rejects other layouts. The
+// generation is then kept in the header and advanced by every process.
+class TranspositionTable {
+public:
+  static const int BUCKET_SIZE = 4;
+  // generations wrap around at this value
+  static const int N_GENERATIONS = 64;
+  static const int FILL_SAMPLE = 1000;
+
+  TranspositionTable();
+  TranspositionTable(TranspositionTable &&);
+  TranspositionTable &operator=(TranspositionTable &&);
+  ~TranspositionTable();
+
+  // Allocates the largest power-of-two number of buckets fitting `size_mb`;
+  // a shared table is detached first.
+  void resize(size_t size_mb);
+  void clear();
+  // Number of entries.
+  size_t get_size() const { return m_n_buckets * BUCKET_SIZE; }
+
+  // Starts a new search; entries of earlier searches age. Searches of all
+  // processes sharing a table advance the same generation.
+  void new_generation();
+  uint8_t get_generation() const { return m_generation; }
+  // Share of the entries stored in the current generation, sampled from the
+  // first `FILL_SAMPLE` entries, like a chess engine's hashfull.
+  double get_fill() const;
+
+  bool probe(uint64_t key, TTEntry &entry) const;
+  void store(uint64_t key, int depth, int score, Bound bound, int move);
+
+  // Snapshot of the entries and the generation, to warm-start the table of
+  // a later process. `load` fails, leaving the table as it was, if the file
+  // is missing, corrupt or made for another table size. Entries written by
+  // other threads while saving may be torn; they read as misses.
+  bool save(const std::string &path) const;
+  bool load(const std::string &path);
+
+  // Maps the shared-memory segment `name` (as for `shm_open`, e.g.
+  // "/ttt_tt") in place of the buckets, creating it with `size_mb` if it
+  // does not exist; an existing segment keeps its own size. With
+  // `huge_pages` the segment is rounded up to 2 MB and advised to use
+  // transparent huge pages where the kernel allows it for shared memory.
+  // False with `error` set, leaving the table detached and empty, if the
+  // segment cannot be created or mapped, was made by another layout version
+  // or its creator did not finish it in time. Entries stay in the segment
+  // after all processes detach, until `remove_shared`.
+  bool attach_shared(const std::string &name, size_t size_mb,
+                     bool huge_pages, std::string &error);
+  // Unmaps the shared segment; the table is then empty.
+  void detach();
+  bool is_shared() const { return m_segment != nullptr; }
+  // Processes (or tables) attached to the shared segment, 0 if the table is
+  // private. Processes killed while attached stay counted.
+  int get_attached() const;
+  // Removes the segment name; processes attached to it keep their mapping.
+  static bool remove_shared(const std::string &name);
+
+private:
+  struct alignas(64) Bucket {
+    std::atomic<uint64_t> words[2 * BUCKET_SIZE];
+  };
+
+  static uint64_t pack(const TTEntry &entry);
+  static TTEntry unpack(uint64_t key, uint64_t data);
+  // Reads slot `i` of the bucket; false if it is empty or torn.
+  static bool read(const Bucket &bucket, int i, uint64_t &key, TTEntry &entry);
+
+  struct SharedSegment;
+
+  // either `m_owned` or the buckets of `m_segment`
+  Bucket *m_buckets = nullptr;
+  std::unique_ptr<Bucket[]> m_owned;
+  std::unique_ptr<SharedSegment> m_segment;
+  size_t m_n_buckets = 0;
+  uint8_t m_generation = 0;
+};
+
+}; // namespace ttt::my_player
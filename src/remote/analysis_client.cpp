@@ -0,0 +1,61 @@
+#include "analysis_client.hpp"
+
+#include "dto_utils.hpp"
+#include "zmq_utils.hpp"
+
+namespace ttt::remote {
+
+AnalysisClient::AnalysisClient(const char *addr) : m_addr(addr) { connect(); }
+
+void AnalysisClient::connect() {
+  m_sock = zmq::socket_t(m_ctx, zmq::socket_type::req);
+  // pending requests of a reset socket must not block the exit
+  m_sock.set(zmq::sockopt::linger, 0);
+  try {
+    m_sock.connect(m_addr);
+    m_error = nullptr;
+  } catch (zmq::error_t) {
+    m_error = "cannot connect to addr";
+  }
+}
+
+bool AnalysisClient::is_connected() const { return m_error == nullptr; }
+
+const char *AnalysisClient::get_error_msg() const { return m_error; }
+
+bool AnalysisClient::analyze(const std::vector<AnalysisPosition> &positions,
+                             ttt_dto::AnalysisResponse &response,
+                             int timelimit_ms, std::string &error) {
+  if (!is_connected()) {
+    error = m_error;
+    return false;
+  }
+  ttt_dto::AnalysisRequest request;
+  for (const auto &position : positions)
+    *request.add_positions() =
+        translate_position(position.opts, position.moves);
+  if (!send_dto(m_sock, request)) {
+    error = "cannot serialize request";
+    return false;
+  }
+  if (!wait_for_input(m_sock, timelimit_ms)) {
+    error = "no answer in time";
+    connect();
+    return false;
+  }
+  if (!recv_dto(m_sock, response)) {
+    error = "malformed answer";
+    return false;
+  }
+  if (response.has_error()) {
+    error = response.error();
+    return false;
+  }
+  if (response.results_size() != int(positions.size())) {
+    error = "answer for another number of positions";
+    return false;
+  }
+  return true;
+}
+
+}; // namespace ttt::remote
@@ -0,0 +1,46 @@
+#pragma once
+#include "core/game.hpp"
+#include "dto.pb.h"
+
+#include <string>
+#include <vector>
+#include <zmq.hpp>
+
+namespace ttt::remote {
+
+using game::Point;
+using game::State;
+
+// A position for the analysis service: the board and the moves from the
+// start, X first.
+struct AnalysisPosition {
+  State::Opts opts;
+  std::vector<Point> moves;
+};
+
+// Client of `AnalysisServer`; needs only this library, not the engines.
+class AnalysisClient {
+  zmq::context_t m_ctx;
+  zmq::socket_t m_sock;
+  std::string m_addr;
+  const char *m_error = nullptr;
+
+public:
+  explicit AnalysisClient(const char *addr);
+
+  bool is_connected() const;
+  const char *get_error_msg() const;
+
+  // Sends one batch and waits for its answer, one result per position in
+  // the same order. False with `error` set if the server did not answer in
+  // time or the answer is malformed; the connection is then reset, since a
+  // REQ socket cannot send again before it gets its reply.
+  bool analyze(const std::vector<AnalysisPosition> &positions,
+               ttt_dto::AnalysisResponse &response, int timelimit_ms,
+               std::string &error);
+
+private:
+  void connect();
+};
+
+}; // namespace ttt::remote
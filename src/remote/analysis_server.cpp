@@ -0,0 +1,98 @@
+#include "analysis_server.hpp"
+
+#include "dto_utils.hpp"
+#include "zmq_utils.hpp"
+
+namespace ttt::remote {
+
+AnalysisServer::AnalysisServer(zmq::context_t &ctx,
+                               const my_player::AnalysisOpts &opts)
+    : m_sock(ctx, zmq::socket_type::rep), m_pool(opts) {}
+
+bool AnalysisServer::bind(const char *addr) {
+  try {
+    m_sock.bind(addr);
+  } catch (zmq::error_t) {
+    m_error = "cannot bind address";
+    return false;
+  }
+  return true;
+}
+
+bool AnalysisServer::is_running() const { return m_error == nullptr; }
+
+const char *AnalysisServer::get_error_msg() const { return m_error; }
+
+static void translate_stats(const my_player::AnalysisStats &stats,
+                            ttt_dto::AnalysisStats &result) {
+  result.set_positions(stats.positions);
+  result.set_batches(stats.batches);
+  result.set_cache_hits(stats.cache_hits);
+  result.set_positions_per_s(stats.get_pps());
+  result.set_p50_ms(stats.p50_ms);
+  result.set_p90_ms(stats.p90_ms);
+  result.set_p99_ms(stats.p99_ms);
+  result.set_max_ms(stats.max_ms);
+}
+
+static void translate_result(const my_player::AnalysisResult &analysis,
+                             ttt_dto::AnalysisResult &result) {
+  result.set_ended(analysis.ended);
+  if (!analysis.ended)
+    *result.mutable_best() = translate_move(analysis.best);
+  result.set_score(analysis.score);
+  result.set_depth(analysis.depth);
+  for (const Point &move : analysis.pv)
+    *result.add_pv() = translate_move(move);
+  result.set_nodes(analysis.nodes);
+  result.set_time_ms(analysis.time_ms);
+  result.set_cached(analysis.cached);
+  for (const auto &line : analysis.lines) {
+    ttt_dto::AnalysisLine &dto_line = *result.add_lines();
+    *dto_line.mutable_move() = translate_move(line.move);
+    dto_line.set_score(line.score);
+    dto_line.set_depth(line.depth);
+    for (const Point &move : line.pv)
+      *dto_line.add_pv() = translate_move(move);
+  }
+}
+
+bool AnalysisServer::handle_request(int timelimit_ms, int &n_positions) {
+  n_positions = 0;
+  if (!wait_for_input(m_sock, timelimit_ms))
+    return false;
+  ttt_dto::AnalysisRequest request;
+  ttt_dto::AnalysisResponse response;
+  if (!recv_dto(m_sock, request)) {
+    // a REP socket must answer before the next request
+    response.set_error("malformed request");
+    send_dto(m_sock, response);
+    return true;
+  }
+
+  // the positions which replay go to the pool, the others get their error
+  n_positions = request.positions_size();
+  std::vector<State> batch;
+  std::vector<int> batch_index(n_positions, -1);
+  for (int i = 0; i < n_positions; ++i) {
+    ttt_dto::AnalysisResult *result = response.add_results();
+    std::string error;
+    auto state = translate_position(request.positions(i), error);
+    if (!state) {
+      result->set_error(error);
+      continue;
+    }
+    batch_index[i] = int(batch.size());
+    batch.push_back(*state);
+  }
+  const auto analysis = m_pool.analyze(batch);
+  for (int i = 0; i < n_positions; ++i)
+    if (batch_index[i] >= 0)
+      translate_result(analysis[batch_index[i]],
+                       *response.mutable_results(i));
+  translate_stats(m_pool.get_stats(), *response.mutable_stats());
+  send_dto(m_sock, response);
+  return true;
+}
+
+}; // namespace ttt::remote
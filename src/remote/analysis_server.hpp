@@ -0,0 +1,33 @@
+#pragma once
+#include "player/analysis.hpp"
+
+#include <zmq.hpp>
+
+namespace ttt::remote {
+
+// Engine analysis over a REP socket: every `AnalysisRequest` is a batch of
+// positions, analysed by the workers of an `AnalysisPool` and answered with
+// one `AnalysisResponse` in the order of the request. Positions which
+// cannot be replayed get an error result of their own; the others are
+// still analysed. The pool caches results by position hash, so repeated
+// positions from any client are answered at once.
+class AnalysisServer {
+  zmq::socket_t m_sock;
+  my_player::AnalysisPool m_pool;
+  const char *m_error = nullptr;
+
+public:
+  AnalysisServer(zmq::context_t &ctx, const my_player::AnalysisOpts &opts);
+
+  bool bind(const char *addr);
+  bool is_running() const;
+  const char *get_error_msg() const;
+
+  // Answers one request; false if none came within the time limit.
+  // `n_positions` is the size of the batch answered.
+  bool handle_request(int timelimit_ms, int &n_positions);
+
+  const my_player::AnalysisPool &get_pool() const { return m_pool; }
+};
+
+}; // namespace ttt::remote
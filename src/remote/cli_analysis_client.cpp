@@ -0,0 +1,156 @@
+#include "analysis_client.hpp"
+#include "cli_utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using ttt::remote::AnalysisClient;
+using ttt::remote::AnalysisPosition;
+
+using Clock = std::chrono::steady_clock;
+
+static const char *get_arg(mycli::cli_t &cli, mycli::parsed_args &args,
+                           const char *name) {
+  const char *const *kw = args.get_keyword(name, 0);
+  return kw ? *kw : cli.get_default(name);
+}
+
+// "rows cols win_len [x,y ...]"
+static bool parse_position(const std::string &line, AnalysisPosition &pos) {
+  std::istringstream in(line);
+  if (!(in >> pos.opts.rows >> pos.opts.cols >> pos.opts.win_len))
+    return false;
+  pos.opts.max_moves = 0;
+  pos.moves.clear();
+  std::string move;
+  while (in >> move) {
+    ttt::game::Point point;
+    if (std::sscanf(move.c_str(), "%d,%d", &point.x, &point.y) != 2)
+      return false;
+    pos.moves.push_back(point);
+  }
+  return true;
+}
+
+static void print_result(long long no, const ttt_dto::AnalysisResult &result) {
+  std::cout << no << ": ";
+  if (result.has_error()) {
+    std::cout << "error: " << result.error() << '\n';
+    return;
+  }
+  if (result.ended()) {
+    std::cout << "game over\n";
+    return;
+  }
+  std::cout << "best " << result.best().x() << "," << result.best().y()
+            << " score " << result.score() << " depth " << result.depth()
+            << " nodes " << result.nodes() << (result.cached() ? " cached" : "")
+            << " pv";
+  for (const auto &move : result.pv())
+    std::cout << ' ' << move.x() << "," << move.y();
+  std::cout << '\n';
+  for (int i = 0; i < result.lines_size(); ++i) {
+    const auto &line = result.lines(i);
+    std::cout << "  " << i + 1 << ". " << line.move().x() << ","
+              << line.move().y() << " score " << line.score() << " depth "
+              << line.depth() << " pv";
+    for (const auto &move : line.pv())
+      std::cout << ' ' << move.x() << "," << move.y();
+    std::cout << '\n';
+  }
+}
+
+int main(int argc, char *argv[]) {
+  mycli::cli_t cli{{
+      {"address", 'a', 1, "service address", "tcp://localhost:5556"},
+      {"batch", 'b', 1, "positions per request", "64"},
+      {"timeout", 't', 1, "time limit of a request, ms", "600000"},
+      {"help", 'h', 0, "show this message"},
+  }};
+  const char *usage = "usage: cli_analysis_client [opts] < positions";
+  auto args = cli.parse(argc - 1, argv + 1);
+  if (!args.error.empty()) {
+    std::cerr << "error: " << args.error << "\n";
+    std::cerr << usage << '\n';
+    cli.print_opts(std::cerr, 80);
+    return 1;
+  }
+  if (args.has_flag("help")) {
+    std::cout << "cli_analysis_client: sends the positions of standard "
+                 "input, one per line as 'rows cols win_len x,y ...' with "
+                 "the moves from the start, to the analysis service.\n"
+              << usage << '\n';
+    cli.print_opts(std::cout, 80);
+    return 0;
+  }
+  const int batch_size = std::max(1, atoi(get_arg(cli, args, "batch")));
+  const int timeout = atoi(get_arg(cli, args, "timeout"));
+
+  AnalysisClient client(get_arg(cli, args, "address"));
+  if (!client.is_connected()) {
+    std::cerr << "error: " << client.get_error_msg() << '\n';
+    return 1;
+  }
+  const auto start = Clock::now();
+  std::vector<double> latencies;
+  long long n_positions = 0;
+  ttt_dto::AnalysisResponse response;
+  std::vector<AnalysisPosition> batch;
+  std::string line;
+  bool more = true;
+  while (more) {
+    more = bool(std::getline(std::cin, line));
+    if (more && !line.empty()) {
+      AnalysisPosition position;
+      if (!parse_position(line, position)) {
+        std::cerr << "error: bad position '" << line << "'\n";
+        return 1;
+      }
+      batch.push_back(position);
+    }
+    if (batch.empty() || (more && int(batch.size()) < batch_size))
+      continue;
+    const auto sent = Clock::now();
+    std::string error;
+    if (!client.analyze(batch, response, timeout, error)) {
+      std::cerr << "error: " << error << '\n';
+      return 1;
+    }
+    latencies.push_back(
+        std::chrono::duration<double, std::milli>(Clock::now() - sent)
+            .count());
+    for (const auto &result : response.results())
+      print_result(n_positions++, result);
+    batch.clear();
+  }
+
+  const double total_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&](double p) {
+    return latencies.empty()
+               ? 0
+               : latencies[std::min(latencies.size() - 1,
+                                    size_t(p * latencies.size()))];
+  };
+  std::cout << n_positions << " positions in " << latencies.size()
+            << " requests, "
+            << (total_ms > 0 ? long(n_positions / total_ms * 1000) : 0)
+            << " positions/s; request latency p50 " << percentile(0.5)
+            << " ms, p90 " << percentile(0.9) << " ms, p99 "
+            << percentile(0.99) << " ms\n";
+  if (response.has_stats()) {
+    const auto &stats = response.stats();
+    std::cout << "service: " << stats.positions() << " positions, "
+              << long(stats.positions_per_s()) << " positions/s, "
+              << stats.cache_hits() << " cache hits, position latency p50 "
+              << stats.p50_ms() << " ms, p90 " << stats.p90_ms()
+              << " ms, p99 " << stats.p99_ms() << " ms\n";
+  }
+  return 0;
+}
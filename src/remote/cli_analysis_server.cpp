@@ -0,0 +1,101 @@
+#include "analysis_server.hpp"
+#include "cli_utils.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+using ttt::my_player::AnalysisOpts;
+using ttt::my_player::AnalysisStats;
+using ttt::my_player::TranspositionTable;
+using ttt::remote::AnalysisServer;
+
+static const char *get_arg(mycli::cli_t &cli, mycli::parsed_args &args,
+                           const char *name) {
+  const char *const *kw = args.get_keyword(name, 0);
+  return kw ? *kw : cli.get_default(name);
+}
+
+int main(int argc, char *argv[]) {
+  mycli::cli_t cli{{
+      {"address", 'a', 1, "service address", "tcp://localhost:5556"},
+      {"workers", 'w', 1, "positions analysed at once, 0 for all cores",
+       "0"},
+      {"time", 't', 1, "search time per position, ms", "100"},
+      {"depth", 'd', 1, "search depth limit", "64"},
+      {"tt", 'm', 1, "table memory per worker, MB", "16"},
+      {"tt-shm", 's', 1,
+       "shared-memory table of all workers and processes, e.g. /ttt_tt"},
+      {"huge-pages", 'g', 0, "back the shared table with huge pages"},
+      {"cache", 'c', 1, "results cached by position hash", "65536"},
+      {"lines", 'l', 1, "best moves ranked per position (multi-PV)", "1"},
+      {"eval-cache", 'e', 1, "shared evaluation cache, MB (0: none)", "0"},
+      {"report", 'r', 1, "print statistics every this many batches", "1"},
+      {"help", 'h', 0, "show this message"},
+  }};
+  const char *usage = "usage: cli_analysis_server [opts]";
+  auto args = cli.parse(argc - 1, argv + 1);
+  if (!args.error.empty()) {
+    std::cerr << "error: " << args.error << "\n";
+    std::cerr << usage << '\n';
+    cli.print_opts(std::cerr, 80);
+    return 1;
+  }
+  if (args.has_flag("help")) {
+    std::cout << "cli_analysis_server: answers batches of positions with "
+                 "the best moves, scores and principal variations.\n"
+              << usage << '\n';
+    cli.print_opts(std::cout, 80);
+    return 0;
+  }
+
+  AnalysisOpts opts;
+  opts.n_workers = atoi(get_arg(cli, args, "workers"));
+  opts.search.time_ms = atoi(get_arg(cli, args, "time"));
+  opts.search.max_depth = atoi(get_arg(cli, args, "depth"));
+  opts.search.tt_size_mb = atoi(get_arg(cli, args, "tt"));
+  if (const char *name = get_arg(cli, args, "tt-shm"))
+    opts.search.tt_shm_name = name;
+  opts.search.tt_huge_pages = args.has_flag("huge-pages");
+  opts.search.eval_cache_mb = atoi(get_arg(cli, args, "eval-cache"));
+  opts.cache_entries = atoi(get_arg(cli, args, "cache"));
+  opts.multi_pv = atoi(get_arg(cli, args, "lines"));
+  const int report = std::max(1, atoi(get_arg(cli, args, "report")));
+  const char *addr = get_arg(cli, args, "address");
+  if (!opts.search.tt_shm_name.empty()) {
+    // workers attach on their own; failing here beats silent private tables
+    TranspositionTable tt;
+    std::string error;
+    if (!tt.attach_shared(opts.search.tt_shm_name, opts.search.tt_size_mb,
+                          opts.search.tt_huge_pages, error)) {
+      std::cerr << "error: " << error << '\n';
+      return 1;
+    }
+  }
+
+  zmq::context_t ctx;
+  AnalysisServer server(ctx, opts);
+  if (!server.bind(addr)) {
+    std::cerr << "cannot bind " << addr << ": " << server.get_error_msg()
+              << '\n';
+    return 1;
+  }
+  std::cout << "serving " << addr << " with "
+            << server.get_pool().get_n_workers() << " workers\n";
+  long long n_batches = 0;
+  while (server.is_running()) {
+    int n_positions;
+    if (!server.handle_request(1000, n_positions))
+      continue;
+    if (++n_batches % report != 0)
+      continue;
+    const AnalysisStats stats = server.get_pool().get_stats();
+    std::cout << "batch " << n_batches << " (" << n_positions
+              << " positions): " << stats.positions << " positions, "
+              << long(stats.get_pps()) << " positions/s, cache hits "
+              << int(100 * stats.get_cache_hit_rate()) << "%, latency p50 "
+              << stats.p50_ms << " ms, p90 " << stats.p90_ms << " ms, p99 "
+              << stats.p99_ms << " ms" << std::endl;
+  }
+  std::cerr << "server error: " << server.get_error_msg() << '\n';
+  return 1;
+}
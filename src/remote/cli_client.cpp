@@ -3,16 +3,17 @@
 #include "core/event.hpp"
 #include "core/game.hpp"
 #include "player/my_observer.hpp"
-#include "player/my_player.hpp"
+#include "player/registry.hpp"
 
 #include <chrono>
 #include <cstdlib>
 #include <iostream>
+#include <string>
 #include <thread>
 
 using ttt::game::EventType;
 using ttt::my_player::ConsoleWriter;
-using ttt::my_player::MyPlayer;
+using ttt::my_player::PlayerRegistry;
 using ttt::remote::Client;
 using ttt::remote::ClientContext;
 
@@ -31,7 +32,7 @@ class FieldPrinter : public ttt::game::IObserver {
 };
 
 struct ClientBuilder {
-  const char *address, *password;
+  const char *address = nullptr, *password = nullptr;
   ttt::game::IPlayer *player = nullptr;
   ttt::game::IObserver *observer = nullptr;
 
@@ -40,7 +41,6 @@ struct ClientBuilder {
     address = cli.get_default("address");
     if ((kw = args.get_keyword("address", 0)))
       address = *kw;
-    const char *password = nullptr;
     if ((kw = args.get_keyword("password", 0)))
       password = *kw;
     else
@@ -63,6 +63,8 @@ int main(int argc, char *argv[]) {
   mycli::cli_t cli{{
       {"address", 'a', 1, "game server address", "tcp://localhost:5555"},
       {"password", 'p', 1, "game server password"},
+      {"engine", 'e', 1, "player engine[:key=value,...], see below",
+       "random"},
       {"observer", 'o', 0, "connect with observer"},
       {"no-player", 'N', 0, "connect without player"},
       {"retry", 'r', 0, "retry if connection fails"},
@@ -81,6 +83,7 @@ int main(int argc, char *argv[]) {
                  "to remote game.\n"
               << usage << '\n';
     cli.print_opts(std::cout, 80);
+    PlayerRegistry::get().print_help(std::cout);
     return 0;
   }
   const char *name = args.get_positional(0);
@@ -89,7 +92,14 @@ int main(int argc, char *argv[]) {
     return 1;
   }
   bool retry = args.has_flag("retry");
-  MyPlayer p1(name);
+  const char *const *engine = args.get_keyword("engine", 0);
+  std::string error;
+  auto p1 = PlayerRegistry::get().create(
+      engine ? *engine : cli.get_default("engine"), name, error);
+  if (!p1) {
+    std::cerr << "error: " << error << "\n";
+    return 1;
+  }
   ttt::game::ComposedObserver obs;
   FieldPrinter printer;
   ConsoleWriter writer;
@@ -100,7 +110,7 @@ int main(int argc, char *argv[]) {
     builder.observer = &obs;
   }
   if (!args.has_flag("no-player")) {
-    builder.player = &p1;
+    builder.player = p1.get();
   }
 
   ClientContext ctx;
@@ -9,6 +9,7 @@ namespace ttt::remote {
 
 using game::Event;
 using game::EventType;
+using game::MoveResult;
 
 Client::Client() : Client("not connected yet") {}
 
@@ -57,6 +58,7 @@ bool Client::handle_one_update(int timelimit_ms) {
       disconnect("bad message", true);
       return true;
     }
+    const auto opts = translate_opts(update.new_game().options());
     if (m_player) {
       const auto sign = translate_sign(update.new_game().sign());
       if (sign == Sign::NONE) {
@@ -64,9 +66,9 @@ bool Client::handle_one_update(int timelimit_ms) {
         disconnect("bad message", true);
         return true;
       }
-      m_player->set_sign(translate_sign(update.new_game().sign()));
+      m_player->on_game_start(opts, sign);
+      m_player->set_sign(sign);
     }
-    const auto opts = translate_opts(update.new_game().options());
     m_state.reset(new State(opts));
     send_ready();
     return true;
@@ -83,6 +85,21 @@ bool Client::handle_one_update(int timelimit_ms) {
                             event.data.move.y);
     }
     m_obs.handle_event(*m_state, event);
+    if (m_player) {
+      switch (event.type) {
+      case EventType::WIN:
+        m_player->on_game_end(*m_state, MoveResult::WIN);
+        break;
+      case EventType::DRAW:
+        m_player->on_game_end(*m_state, MoveResult::DRAW);
+        break;
+      case EventType::DQ:
+        m_player->on_game_end(*m_state, event.data.dq.reason);
+        break;
+      default:
+        break;
+      }
+    }
     send_ready();
     return true;
   }
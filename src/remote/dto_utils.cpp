@@ -128,4 +128,58 @@ ttt_dto::Sign translate_sign(const Sign &sign) {
   }
   return  ttt_dto::Sign::NONE;
 }
+std::unique_ptr<State> translate_position(const ttt_dto::Position &position,
+                                          std::string &error) {
+  if (!position.has_options()) {
+    error = "position without options";
+    return nullptr;
+  }
+  State::Opts opts = translate_opts(position.options());
+  // the engines keep a row of the board in a machine word or two
+  if (opts.rows < 1 || opts.cols < 1 || opts.rows > 64 || opts.cols > 64 ||
+      opts.win_len < 2 || opts.max_moves < 0) {
+    error = "invalid board options";
+    return nullptr;
+  }
+  auto state = std::make_unique<State>(opts);
+  for (int i = 0; i < position.moves_size(); ++i) {
+    const ttt_dto::Move &move = position.moves(i);
+    if (state->get_status() == game::Status::ENDED) {
+      error = "move " + std::to_string(i) + " after the end of the game";
+      return nullptr;
+    }
+    const MoveResult result =
+        state->process_move(state->get_current_player(), move.x(), move.y());
+    if (is_dq(result) || result == MoveResult::ERROR) {
+      error = "illegal move " + std::to_string(i) + " (" +
+              std::to_string(move.x()) + ", " + std::to_string(move.y()) + ")";
+      return nullptr;
+    }
+  }
+  return state;
+}
+
+ttt_dto::Position translate_position(const State::Opts &opts,
+                                     const std::vector<Point> &moves) {
+  ttt_dto::Position result;
+  *result.mutable_options() = translate_opts(opts);
+  for (const Point &move : moves)
+    *result.add_moves() = translate_move(move);
+  return result;
+}
+
+Point translate_move(const ttt_dto::Move &move) {
+  Point result;
+  result.x = move.x();
+  result.y = move.y();
+  return result;
+}
+
+ttt_dto::Move translate_move(const Point &move) {
+  ttt_dto::Move result;
+  result.set_x(move.x);
+  result.set_y(move.y);
+  return result;
+}
+
 }; // namespace ttt::remote
@@ -1,9 +1,14 @@
 #include "core/game.hpp"
 #include "dto.pb.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace ttt::remote {
 
 using game::Event;
+using game::Point;
 using game::Sign;
 using game::State;
 
@@ -16,4 +21,14 @@ ttt_dto::GameOptions translate_opts(const State::Opts &opts);
 Sign translate_sign(const ttt_dto::Sign &sign);
 ttt_dto::Sign translate_sign(const Sign &sign);
 
+// Replays the moves of a position; null with `error` set if the options are
+// not a valid board or a move is illegal or comes after the end of the game.
+std::unique_ptr<State> translate_position(const ttt_dto::Position &position,
+                                          std::string &error);
+ttt_dto::Position translate_position(const State::Opts &opts,
+                                     const std::vector<Point> &moves);
+
+Point translate_move(const ttt_dto::Move &move);
+ttt_dto::Move translate_move(const Point &move);
+
 }; // namespace ttt::remote
@@ -94,6 +94,12 @@ void RemotePlayer::set_sign(Sign sign) {
   }
 }
 
+// The remote side learns about the game from the new game update sent by
+// `set_sign` (which follows this hook) and the end from the game events.
+void RemotePlayer::on_game_start(const State::Opts &opts, Sign sign) {
+  m_opts = opts;
+}
+
 Point RemotePlayer::make_move(const State &) {
   ttt_dto::Update msg;
   msg.set_move_request(true);
@@ -39,6 +39,7 @@ public:
   void set_fallback(IFallbackServerAction *fallback);
 
   void set_sign(Sign sign) override;
+  void on_game_start(const State::Opts &opts, Sign sign) override;
   Point make_move(const State &) override;
   const char *get_name() const override;
   void handle_event(const State &game, const game::Event &event) override;
@@ -0,0 +1,96 @@
+#include "player/book_builder.hpp"
+#include "remote/cli_utils.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using ttt::my_player::BookBuilder;
+using ttt::my_player::BookBuildOpts;
+using ttt::my_player::OpeningBook;
+using ttt::my_player::SearchOpts;
+
+static int get_int(mycli::cli_t &cli, mycli::parsed_args &args,
+                   const char *name) {
+  const char *const *kw = args.get_keyword(name, 0);
+  return atoi(kw ? *kw : cli.get_default(name));
+}
+
+int main(int argc, char *argv[]) {
+  mycli::cli_t cli{{
+      {"mode", 'm', 1, "'search' or 'selfplay'", "search"},
+      {"rows", 'r', 1, "board rows", "15"},
+      {"cols", 'c', 1, "board columns", "15"},
+      {"win", 'w', 1, "line length to win", "5"},
+      {"plies", 'p', 1, "moves into the game covered by the book", "8"},
+      {"candidates", 'C', 1, "searched moves per position", "6"},
+      {"width", 'W', 1, "best moves expanded per position", "2"},
+      {"multipv", 'M', 0, "rank candidates by one multi-PV search"},
+      {"games", 'g', 1, "self-play games", "100"},
+      {"random", 'R', 1, "random opening moves of self-play games", "2"},
+      {"time", 't', 1, "search time per move (ms)", "200"},
+      {"threads", 'j', 1, "builder threads, 0 for all cores", "0"},
+      {"help", 'h', 0, "show this message"},
+  }};
+  const char *usage = "usage: book_builder [opts] {book_file}";
+  auto args = cli.parse(argc - 1, argv + 1);
+  if (!args.error.empty()) {
+    std::cerr << "error: " << args.error << "\n";
+    std::cerr << usage << '\n';
+    cli.print_opts(std::cerr, 80);
+    return 1;
+  }
+  if (args.has_flag("help")) {
+    std::cout << "book_builder: builds an opening book for SearchPlayer "
+                 "from deep searches or self-play.\n"
+              << usage << '\n';
+    cli.print_opts(std::cout, 80);
+    return 0;
+  }
+  const char *path = args.get_positional(0);
+  if (path == nullptr) {
+    std::cerr << "error: book file is required, see --help\n";
+    return 1;
+  }
+
+  const int rows = get_int(cli, args, "rows"), cols = get_int(cli, args, "cols");
+  BookBuilder builder({rows, cols, get_int(cli, args, "win"), rows * cols});
+  BookBuildOpts opts;
+  opts.plies = get_int(cli, args, "plies");
+  opts.candidates = get_int(cli, args, "candidates");
+  opts.width = get_int(cli, args, "width");
+  opts.multi_pv = args.has_flag("multipv");
+  opts.games = get_int(cli, args, "games");
+  opts.random_plies = get_int(cli, args, "random");
+  opts.n_threads = get_int(cli, args, "threads");
+  SearchOpts search_opts;
+  search_opts.time_ms = get_int(cli, args, "time");
+
+  const auto start = std::chrono::steady_clock::now();
+  const char *const *mode = args.get_keyword("mode", 0);
+  if (mode && std::string(*mode) == "selfplay") {
+    build_book_by_self_play(builder, search_opts, opts, &std::cout);
+  } else if (!mode || std::string(*mode) == "search") {
+    build_book_by_search(builder, search_opts, opts, &std::cout);
+  } else {
+    std::cerr << "error: unknown mode '" << *mode << "'\n";
+    return 1;
+  }
+  if (!builder.write(path)) {
+    std::cerr << "error: cannot write '" << path << "'\n";
+    return 1;
+  }
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+
+  OpeningBook book;
+  if (!book.open(path)) {
+    std::cerr << "error: cannot read back '" << path << "'\n";
+    return 1;
+  }
+  std::cout << "wrote " << book.get_n_positions() << " positions to " << path
+            << " in " << seconds << " s\n";
+  return 0;
+}
@@ -0,0 +1,72 @@
+#include "player/nnue_trainer.hpp"
+#include "remote/cli_utils.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+using ttt::my_player::NnueNetwork;
+using ttt::my_player::NnueTrainOpts;
+
+static const char *get_arg(mycli::cli_t &cli, mycli::parsed_args &args,
+                           const char *name) {
+  const char *const *kw = args.get_keyword(name, 0);
+  return kw ? *kw : cli.get_default(name);
+}
+
+int main(int argc, char *argv[]) {
+  mycli::cli_t cli{{
+      {"rows", 'r', 1, "board rows", "15"},
+      {"cols", 'c', 1, "board columns", "15"},
+      {"win", 'w', 1, "line length to win", "5"},
+      {"hidden", 'H', 1, "accumulator size per side", "32"},
+      {"positions", 'p', 1, "training positions", "200000"},
+      {"epochs", 'e', 1, "passes over the positions", "4"},
+      {"rate", 'l', 1, "learning rate of the first epoch", "0.05"},
+      {"result", 'R', 1, "weight of game results in the targets", "0.25"},
+      {"threads", 'j', 1, "threads generating positions, 0 for all", "0"},
+      {"seed", 's', 1, "random seed", "1"},
+      {"help", 'h', 0, "show this message"},
+  }};
+  const char *usage = "usage: nnue_trainer [opts] {network_file}";
+  auto args = cli.parse(argc - 1, argv + 1);
+  if (!args.error.empty()) {
+    std::cerr << "error: " << args.error << "\n";
+    std::cerr << usage << '\n';
+    cli.print_opts(std::cerr, 80);
+    return 1;
+  }
+  if (args.has_flag("help")) {
+    std::cout << "nnue_trainer: trains a network for Evaluator::NNUE on "
+                 "positions of randomized games.\n"
+              << usage << '\n';
+    cli.print_opts(std::cout, 80);
+    return 0;
+  }
+  const char *path = args.get_positional(0);
+  if (path == nullptr) {
+    std::cerr << "error: network file is required, see --help\n";
+    return 1;
+  }
+
+  const int rows = atoi(get_arg(cli, args, "rows"));
+  const int cols = atoi(get_arg(cli, args, "cols"));
+  NnueTrainOpts opts;
+  opts.n_hidden = atoi(get_arg(cli, args, "hidden"));
+  opts.positions = atoi(get_arg(cli, args, "positions"));
+  opts.epochs = atoi(get_arg(cli, args, "epochs"));
+  opts.learning_rate = atof(get_arg(cli, args, "rate"));
+  opts.result_weight = atof(get_arg(cli, args, "result"));
+  opts.n_threads = atoi(get_arg(cli, args, "threads"));
+  opts.seed = strtoull(get_arg(cli, args, "seed"), nullptr, 10);
+
+  const NnueNetwork network = ttt::my_player::train_nnue(
+      {rows, cols, atoi(get_arg(cli, args, "win")), rows * cols}, opts,
+      &std::cout);
+  if (!network.save(path)) {
+    std::cerr << "error: cannot write '" << path << "'\n";
+    return 1;
+  }
+  std::cout << "wrote " << network.get_n_hidden() << " x 2 network to "
+            << path << '\n';
+  return 0;
+}
@@ -0,0 +1,75 @@
+#include "player/pn_solver.hpp"
+#include "remote/cli_utils.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+using ttt::my_player::PnSolution;
+using ttt::my_player::PnSolver;
+using ttt::my_player::PnSolverOpts;
+
+static const char *get_arg(mycli::cli_t &cli, mycli::parsed_args &args,
+                           const char *name) {
+  const char *const *kw = args.get_keyword(name, 0);
+  return kw ? *kw : cli.get_default(name);
+}
+
+int main(int argc, char *argv[]) {
+  mycli::cli_t cli{{
+      {"rows", 'r', 1, "board rows", "3"},
+      {"cols", 'c', 1, "board columns", "3"},
+      {"win", 'w', 1, "line length to win", "3"},
+      {"time", 't', 1, "time limit, ms", "60000"},
+      {"nodes", 'n', 1, "node limit", "1000000000"},
+      {"tt", 'm', 1, "table memory, MB", "1024"},
+      {"help", 'h', 0, "show this message"},
+  }};
+  const char *usage = "usage: pn_solver [opts] [x,y ...]";
+  auto args = cli.parse(argc - 1, argv + 1);
+  if (!args.error.empty()) {
+    std::cerr << "error: " << args.error << "\n";
+    std::cerr << usage << '\n';
+    cli.print_opts(std::cerr, 80);
+    return 1;
+  }
+  if (args.has_flag("help")) {
+    std::cout << "pn_solver: solves the position after the given moves "
+                 "(X first) by proof-number search.\n"
+              << usage << '\n';
+    cli.print_opts(std::cout, 80);
+    return 0;
+  }
+
+  ttt::game::State::Opts opts = {atoi(get_arg(cli, args, "rows")),
+                                 atoi(get_arg(cli, args, "cols")),
+                                 atoi(get_arg(cli, args, "win")), 0};
+  ttt::game::State state(opts);
+  for (int i = 0; args.get_positional(i); ++i) {
+    const char *move = args.get_positional(i);
+    int x, y;
+    if (std::sscanf(move, "%d,%d", &x, &y) != 2 ||
+        state.process_move(state.get_current_player(), x, y) !=
+            ttt::game::MoveResult::OK) {
+      std::cerr << "error: bad move '" << move << "'\n";
+      return 1;
+    }
+  }
+
+  PnSolverOpts solver_opts;
+  solver_opts.time_ms = atoi(get_arg(cli, args, "time"));
+  solver_opts.max_nodes = atoll(get_arg(cli, args, "nodes"));
+  solver_opts.tt_size_mb = atoi(get_arg(cli, args, "tt"));
+  PnSolver solver(solver_opts);
+  const PnSolution solution = solver.solve(state);
+  const auto stats = solver.get_stats();
+  std::cout << (state.get_current_player() == ttt::game::Sign::X ? "X" : "O")
+            << " to move: " << to_string(solution.result);
+  if (solution.move.x >= 0)
+    std::cout << ", best move " << solution.move.x << "," << solution.move.y;
+  std::cout << "\nnodes " << solution.nodes << " in " << solution.time_ms
+            << " ms, table " << stats.tt_entries << " entries, "
+            << stats.gc_runs << " collections (" << stats.gc_removed
+            << " entries removed)\n";
+  return solution.result == ttt::my_player::PnResult::UNKNOWN ? 2 : 0;
+}
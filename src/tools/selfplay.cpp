@@ -0,0 +1,75 @@
+#include "player/registry.hpp"
+#include "player/selfplay.hpp"
+#include "remote/cli_utils.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+using ttt::my_player::SelfPlayOpts;
+using ttt::my_player::SelfPlayStats;
+
+static const char *get_arg(mycli::cli_t &cli, mycli::parsed_args &args,
+                           const char *name) {
+  const char *const *kw = args.get_keyword(name, 0);
+  return kw ? *kw : cli.get_default(name);
+}
+
+int main(int argc, char *argv[]) {
+  mycli::cli_t cli{{
+      {"x", 'x', 1, "player of X", "search:time=10"},
+      {"o", 'o', 1, "player of O", "search:time=10"},
+      {"games", 'g', 1, "games to play", "100"},
+      {"threads", 'j', 1, "parallel games, 0 for all cores", "0"},
+      {"random", 'R', 1, "random opening moves of every game", "4"},
+      {"shard", 'S', 1, "games per shard file", "10000"},
+      {"rows", 'r', 1, "board rows", "15"},
+      {"cols", 'c', 1, "board columns", "15"},
+      {"win", 'w', 1, "line length to win", "5"},
+      {"seed", 's', 1, "seed of the openings", "1"},
+      {"interval", 'i', 1, "seconds between progress lines", "5"},
+      {"help", 'h', 0, "show this message"},
+  }};
+  const char *usage = "usage: selfplay [opts] {output_prefix}";
+  auto args = cli.parse(argc - 1, argv + 1);
+  if (!args.error.empty()) {
+    std::cerr << "error: " << args.error << "\n";
+    std::cerr << usage << '\n';
+    cli.print_opts(std::cerr, 80);
+    return 1;
+  }
+  if (args.has_flag("help")) {
+    std::cout << "selfplay: plays games on all cores and writes their "
+                 "positions, scores and results to dataset shards.\n"
+              << usage << '\n';
+    cli.print_opts(std::cout, 80);
+    ttt::my_player::PlayerRegistry::get().print_help(std::cout);
+    return 0;
+  }
+  const char *prefix = args.get_positional(0);
+  if (prefix == nullptr) {
+    std::cerr << "error: output prefix is required, see --help\n";
+    return 1;
+  }
+
+  SelfPlayOpts opts;
+  opts.player_x = get_arg(cli, args, "x");
+  opts.player_o = get_arg(cli, args, "o");
+  opts.board = {atoi(get_arg(cli, args, "rows")),
+                atoi(get_arg(cli, args, "cols")),
+                atoi(get_arg(cli, args, "win")), 0};
+  opts.games = atoi(get_arg(cli, args, "games"));
+  opts.n_threads = atoi(get_arg(cli, args, "threads"));
+  opts.random_plies = atoi(get_arg(cli, args, "random"));
+  opts.shard_games = atoi(get_arg(cli, args, "shard"));
+  opts.seed = strtoull(get_arg(cli, args, "seed"), nullptr, 10);
+  opts.log_interval = atof(get_arg(cli, args, "interval"));
+
+  SelfPlayStats stats;
+  std::string error;
+  if (!ttt::my_player::run_self_play(opts, prefix, stats, error,
+                                     &std::cout)) {
+    std::cerr << "error: " << error << '\n';
+    return 1;
+  }
+  return 0;
+}
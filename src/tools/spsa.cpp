@@ -0,0 +1,126 @@
+#include "player/registry.hpp"
+#include "player/spsa.hpp"
+#include "remote/cli_utils.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+using ttt::my_player::SpsaOpts;
+using ttt::my_player::SpsaParam;
+
+static const char *get_arg(mycli::cli_t &cli, mycli::parsed_args &args,
+                           const char *name) {
+  const char *const *kw = args.get_keyword(name, 0);
+  return kw ? *kw : cli.get_default(name);
+}
+
+// `name,value,min,max,c,a[,int]`
+static bool parse_param(const std::string &text, SpsaParam &param) {
+  std::istringstream in(text);
+  std::string item;
+  std::vector<std::string> items;
+  while (std::getline(in, item, ','))
+    items.push_back(item);
+  if (items.size() < 6 || items.size() > 7 || items[0].empty())
+    return false;
+  if (items.size() == 7 && items[6] != "int")
+    return false;
+  param.name = items[0];
+  double *values[] = {&param.value, &param.min, &param.max, &param.c,
+                      &param.a};
+  for (int i = 0; i < 5; ++i) {
+    char *end;
+    *values[i] = strtod(items[i + 1].c_str(), &end);
+    if (items[i + 1].empty() || *end != '\0')
+      return false;
+  }
+  param.integer = items.size() == 7;
+  return param.min <= param.value && param.value <= param.max;
+}
+
+int main(int argc, char *argv[]) {
+  mycli::cli_t cli{{
+      {"engine", 'e', 1, "spec the tuned parameters are added to",
+       "search:time=10"},
+      {"param", 'p', 1,
+       "tuned parameter name,value,min,max,c,a[,int], may repeat"},
+      {"iterations", 'n', 1, "iterations to run", "100"},
+      {"games", 'g', 1, "games per iteration", "100"},
+      {"threads", 'j', 1, "parallel games, 0 for all cores", "0"},
+      {"rows", 'r', 1, "board rows", "15"},
+      {"cols", 'c', 1, "board columns", "15"},
+      {"win", 'w', 1, "line length to win", "5"},
+      {"alpha", 'A', 1, "decay of the steps", "0.602"},
+      {"gamma", 'G', 1, "decay of the perturbations", "0.101"},
+      {"stability", 'S', 1, "offset of the step decay", "10"},
+      {"seed", 's', 1, "seed of the perturbations", "1"},
+      {"checkpoint", 'C', 1, "file written after every iteration"},
+      {"resume", 'R', 0, "continue from the checkpoint if it exists"},
+      {"help", 'h', 0, "show this message"},
+  }};
+  const char *usage = "usage: spsa [opts] --param name,value,min,max,c,a ...";
+  auto args = cli.parse(argc - 1, argv + 1);
+  if (!args.error.empty()) {
+    std::cerr << "error: " << args.error << "\n";
+    std::cerr << usage << '\n';
+    cli.print_opts(std::cerr, 80);
+    return 1;
+  }
+  if (args.has_flag("help")) {
+    std::cout << "spsa: tunes numeric player parameters by matches between "
+                 "perturbed players.\n"
+              << usage << '\n';
+    cli.print_opts(std::cout, 80);
+    ttt::my_player::PlayerRegistry::get().print_help(std::cout);
+    return 0;
+  }
+
+  SpsaOpts opts;
+  opts.engine = get_arg(cli, args, "engine");
+  for (int i = 0;; ++i) {
+    const char *const *kw = args.get_keyword("param", i);
+    if (kw == nullptr)
+      break;
+    SpsaParam param;
+    if (!parse_param(*kw, param)) {
+      std::cerr << "error: bad parameter '" << *kw << "', see --help\n";
+      return 1;
+    }
+    opts.params.push_back(param);
+  }
+  if (opts.params.empty()) {
+    std::cerr << "error: no parameters to tune, see --help\n";
+    return 1;
+  }
+  opts.iterations = atoi(get_arg(cli, args, "iterations"));
+  opts.match.games = atoi(get_arg(cli, args, "games"));
+  opts.match.n_threads = atoi(get_arg(cli, args, "threads"));
+  opts.match.board = {atoi(get_arg(cli, args, "rows")),
+                      atoi(get_arg(cli, args, "cols")),
+                      atoi(get_arg(cli, args, "win")), 0};
+  opts.alpha = atof(get_arg(cli, args, "alpha"));
+  opts.gamma = atof(get_arg(cli, args, "gamma"));
+  opts.big_a = atof(get_arg(cli, args, "stability"));
+  opts.seed = strtoull(get_arg(cli, args, "seed"), nullptr, 10);
+  if (const char *path = get_arg(cli, args, "checkpoint"))
+    opts.checkpoint_path = path;
+
+  ttt::my_player::SpsaTuner tuner(opts);
+  if (args.has_flag("resume")) {
+    if (opts.checkpoint_path.empty()) {
+      std::cerr << "error: --resume needs --checkpoint\n";
+      return 1;
+    }
+    if (tuner.load_checkpoint(opts.checkpoint_path))
+      std::cout << "resumed at iteration " << tuner.get_iteration() << ": "
+                << tuner.get_spec() << std::endl;
+  }
+  std::string error;
+  if (!tuner.run(error, &std::cout)) {
+    std::cerr << "error: " << error << '\n';
+    return 1;
+  }
+  std::cout << "tuned: " << tuner.get_spec() << '\n';
+  return 0;
+}
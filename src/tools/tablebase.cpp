@@ -0,0 +1,103 @@
+#include "player/board.hpp"
+#include "player/tablebase.hpp"
+#include "remote/cli_utils.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+using ttt::my_player::Board;
+using ttt::my_player::Tablebase;
+using ttt::my_player::TbEntry;
+using ttt::my_player::TbGenerateStats;
+
+static const char *get_arg(mycli::cli_t &cli, mycli::parsed_args &args,
+                           const char *name) {
+  const char *const *kw = args.get_keyword(name, 0);
+  return kw ? *kw : cli.get_default(name);
+}
+
+int main(int argc, char *argv[]) {
+  mycli::cli_t cli{{
+      {"rows", 'r', 1, "board rows", "3"},
+      {"cols", 'c', 1, "board columns", "3"},
+      {"win", 'w', 1, "line length to win", "3"},
+      {"moves", 'm', 1, "moves per game, 0 for all cells", "0"},
+      {"file", 'f', 1, "tablebase file", "tablebase.bin"},
+      {"generate", 'g', 0, "generate the file first"},
+      {"threads", 't', 1, "generator threads, 0 for all", "0"},
+      {"help", 'h', 0, "show this message"},
+  }};
+  const char *usage = "usage: tablebase [opts] [x,y ...]";
+  auto args = cli.parse(argc - 1, argv + 1);
+  if (!args.error.empty()) {
+    std::cerr << "error: " << args.error << "\n";
+    std::cerr << usage << '\n';
+    cli.print_opts(std::cerr, 80);
+    return 1;
+  }
+  if (args.has_flag("help")) {
+    std::cout << "tablebase: generates the table of all positions of a "
+                 "small board and probes\nthe position after the given "
+                 "moves (X first).\n"
+              << usage << '\n';
+    cli.print_opts(std::cout, 80);
+    return 0;
+  }
+
+  const std::string path = get_arg(cli, args, "file");
+  ttt::game::State::Opts opts = {atoi(get_arg(cli, args, "rows")),
+                                 atoi(get_arg(cli, args, "cols")),
+                                 atoi(get_arg(cli, args, "win")),
+                                 atoi(get_arg(cli, args, "moves"))};
+  if (args.has_flag("generate")) {
+    int n_threads = atoi(get_arg(cli, args, "threads"));
+    if (n_threads <= 0)
+      n_threads = std::max(1u, std::thread::hardware_concurrency());
+    TbGenerateStats stats;
+    std::string error;
+    if (!Tablebase::generate(opts, n_threads, path, stats, error)) {
+      std::cerr << "error: " << error << '\n';
+      return 1;
+    }
+    std::cout << "positions " << stats.positions << ", solved "
+              << stats.solved << " (the rest by symmetry) in "
+              << stats.time_ms << " ms with " << n_threads
+              << " threads\nwins " << stats.wins << ", losses "
+              << stats.losses << ", draws " << stats.draws
+              << "\nempty board: " << to_string(stats.start.result)
+              << " in " << stats.start.distance << '\n';
+  }
+
+  Tablebase tablebase;
+  if (!tablebase.open(path)) {
+    std::cerr << "error: cannot open tablebase '" << path << "'\n";
+    return 1;
+  }
+  if (!args.has_flag("generate"))
+    opts = tablebase.get_opts();
+  ttt::game::State state(opts);
+  for (int i = 0; args.get_positional(i); ++i) {
+    const char *move = args.get_positional(i);
+    int x, y;
+    if (std::sscanf(move, "%d,%d", &x, &y) != 2 ||
+        state.process_move(state.get_current_player(), x, y) !=
+            ttt::game::MoveResult::OK) {
+      std::cerr << "error: bad move '" << move << "'\n";
+      return 1;
+    }
+  }
+
+  ttt::my_player::Point move;
+  TbEntry entry;
+  const bool has_move = tablebase.get_best_move(Board(state), move, entry);
+  std::cout << (state.get_current_player() == ttt::game::Sign::X ? "X" : "O")
+            << " to move: " << to_string(entry.result);
+  if (entry.distance > 0)
+    std::cout << " in " << entry.distance;
+  if (has_move)
+    std::cout << ", best move " << move.x << "," << move.y;
+  std::cout << '\n';
+  return entry.result == ttt::my_player::TbResult::UNKNOWN ? 2 : 0;
+}
@@ -0,0 +1,124 @@
+#include "player/registry.hpp"
+#include "player/rng.hpp"
+#include "remote/cli_utils.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using ttt::game::Game;
+using ttt::game::MoveResult;
+using ttt::game::Sign;
+using ttt::game::State;
+using ttt::my_player::PlayerRegistry;
+
+static const char *get_arg(mycli::cli_t &cli, mycli::parsed_args &args,
+                           const char *name) {
+  const char *const *kw = args.get_keyword(name, 0);
+  return kw ? *kw : cli.get_default(name);
+}
+
+// Points of X in `n_games` games between the specs: 1 a win, 0.5 a draw.
+static double play_match(const std::string &spec_x, const std::string &spec_o,
+                         const State::Opts &opts, int n_games) {
+  std::string error;
+  auto &registry = PlayerRegistry::get();
+  auto x = registry.create(spec_x, spec_x.c_str(), error);
+  auto o = registry.create(spec_o, spec_o.c_str(), error);
+  Game game(opts);
+  game.add_player(Sign::X, x.get());
+  game.add_player(Sign::O, o.get());
+  double points = 0;
+  for (int i = 0; i < n_games; ++i) {
+    MoveResult result;
+    while ((result = game.process()) == MoveResult::OK)
+      ;
+    if (result == MoveResult::DRAW)
+      points += 0.5;
+    else if (game.get_state().get_winner() == Sign::X)
+      points += 1;
+    game.reset();
+  }
+  return points;
+}
+
+int main(int argc, char *argv[]) {
+  mycli::cli_t cli{{
+      {"games", 'g', 1, "games of every pair with each sign", "10"},
+      {"rows", 'r', 1, "board rows", "15"},
+      {"cols", 'c', 1, "board columns", "15"},
+      {"win", 'w', 1, "line length to win", "5"},
+      {"seed", 's', 1, "master seed of the players", "0"},
+      {"help", 'h', 0, "show this message"},
+  }};
+  const char *usage = "usage: tournament [opts] {player} {player} ...";
+  auto args = cli.parse(argc - 1, argv + 1);
+  auto &registry = PlayerRegistry::get();
+  if (!args.error.empty()) {
+    std::cerr << "error: " << args.error << "\n";
+    std::cerr << usage << '\n';
+    cli.print_opts(std::cerr, 80);
+    return 1;
+  }
+  if (args.has_flag("help")) {
+    std::cout << "tournament: round robin of players given as registry "
+                 "specs.\n"
+              << usage << '\n';
+    cli.print_opts(std::cout, 80);
+    registry.print_help(std::cout);
+    return 0;
+  }
+  std::vector<std::string> specs;
+  for (int i = 0; args.get_positional(i) != nullptr; ++i)
+    specs.push_back(args.get_positional(i));
+  if (specs.size() < 2) {
+    std::cerr << "error: at least two players are required, see --help\n";
+    return 1;
+  }
+  // fail before any game is played
+  for (auto &spec : specs) {
+    std::string error;
+    if (!registry.create(spec, spec.c_str(), error)) {
+      std::cerr << "error: " << error << '\n';
+      return 1;
+    }
+  }
+
+  const int n_games = atoi(get_arg(cli, args, "games"));
+  const int rows = atoi(get_arg(cli, args, "rows"));
+  const int cols = atoi(get_arg(cli, args, "cols"));
+  const State::Opts opts = {rows, cols, atoi(get_arg(cli, args, "win")), 0};
+  ttt::my_player::set_master_seed(strtoull(get_arg(cli, args, "seed"),
+                                           nullptr, 10));
+
+  // points[i][j]: points of player i against player j
+  const size_t n = specs.size();
+  std::vector<std::vector<double>> points(n, std::vector<double>(n, 0));
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = i + 1; j < n; ++j) {
+      const double as_x = play_match(specs[i], specs[j], opts, n_games);
+      const double as_o = play_match(specs[j], specs[i], opts, n_games);
+      points[i][j] = as_x + n_games - as_o;
+      points[j][i] = 2 * n_games - points[i][j];
+      std::cout << specs[i] << " - " << specs[j] << ": " << points[i][j]
+                << " : " << points[j][i] << std::endl;
+    }
+
+  std::cout << "\n";
+  for (size_t i = 0; i < n; ++i) {
+    double total = 0;
+    std::cout << std::setw(3) << i + 1 << ' ';
+    for (size_t j = 0; j < n; ++j) {
+      if (i == j)
+        std::cout << std::setw(6) << '-';
+      else
+        std::cout << std::setw(6) << points[i][j];
+      total += points[i][j];
+    }
+    std::cout << std::setw(8) << total << "  " << specs[i] << '\n';
+  }
+  return 0;
+}
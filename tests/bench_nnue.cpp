@@ -0,0 +1,155 @@
+#include "player/nnue_trainer.hpp"
+#include "player/search.hpp"
+#include "test_stats.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+using ttt::game::Sign;
+using ttt::game::State;
+using ttt::my_player::Evaluator;
+using ttt::my_player::NnueAccumulator;
+using ttt::my_player::NnueNetwork;
+using ttt::my_player::PatternEvaluator;
+using ttt::my_player::SearchOpts;
+using ttt::my_player::SearchPlayer;
+
+using Clock = std::chrono::steady_clock;
+
+// Evaluations per second of `eval`, each after setting and clearing a cell
+// of the move sequence, as in a search.
+template <class Eval>
+static double bench_evals(Eval &eval, const std::vector<int> &moves) {
+  const int n_rounds = 200;
+  const auto start = Clock::now();
+  long long n_evals = 0, checksum = 0;
+  for (int round = 0; round < n_rounds; ++round) {
+    for (size_t i = 0; i < moves.size(); ++i) {
+      const Sign sign = i % 2 == 0 ? Sign::X : Sign::O;
+      eval.set(moves[i], sign);
+      checksum += eval.evaluate(sign);
+      ++n_evals;
+    }
+    for (size_t i = moves.size(); i-- > 0;)
+      eval.set(moves[i], Sign::NONE);
+  }
+  const double seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  // keeps the loop from being optimized away
+  if (checksum == 42)
+    std::cout << "";
+  return n_evals / seconds;
+}
+
+int main(int argc, char *argv[]) {
+  std::cout << "Benchmarking NNUE evaluation\n";
+  const int n_games = argc >= 2 ? atoi(argv[1]) : 2;
+  const int n_positions = argc >= 3 ? atoi(argv[2]) : 20000;
+  const State::Opts opts = {15, 15, 5, 225};
+  const int n_cells = opts.rows * opts.cols;
+  // a network from nnue_trainer, or a quickly trained one
+  const bool trained_here = argc < 4;
+  const std::string path = trained_here ? "bench_nnue.bin" : argv[3];
+
+  NnueNetwork network;
+  if (trained_here) {
+    ttt::my_player::NnueTrainOpts train_opts;
+    train_opts.positions = n_positions;
+    train_opts.epochs = 2;
+    train_opts.n_threads = 2;
+    const NnueNetwork trained =
+        ttt::my_player::train_nnue(opts, train_opts, &std::cout);
+    if (!trained.save(path)) {
+      std::cerr << "cannot write " << path << '\n';
+      return 1;
+    }
+    if (!network.load(path)) {
+      std::cerr << "cannot load " << path << '\n';
+      return 1;
+    }
+    assert(network.get_output_weights() == trained.get_output_weights());
+  } else if (!network.load(path)) {
+    std::cerr << "cannot load " << path << '\n';
+    return 1;
+  }
+  assert(network.supports(opts) && !network.supports({10, 10, 5, 100}));
+
+  // weights which take an accumulator of a full board beyond int16_t are
+  // refused, the largest ones allowed for the board are not
+  const State::Opts large_opts = {16, 16, 5, 0};
+  NnueNetwork large(large_opts, 16);
+  for (int limit : {NnueNetwork::QA, NnueNetwork::get_weight_limit(256)}) {
+    for (int f = 0; f < large.get_n_features(); ++f)
+      std::fill_n(large.get_feature_weights(f), large.get_n_hidden(), limit);
+    std::fill(large.get_biases().begin(), large.get_biases().end(),
+              NnueNetwork::BIAS_LIMIT);
+    const bool saved = large.save("bench_nnue_large.bin");
+    assert(saved);
+    NnueNetwork loaded;
+    const bool was_loaded = loaded.load("bench_nnue_large.bin");
+    assert(was_loaded == (limit < NnueNetwork::QA));
+  }
+  std::remove("bench_nnue_large.bin");
+  std::cout << "accumulator bounds: ok\n";
+
+  // incremental updates match a fresh accumulator and the scalar output
+  std::vector<Sign> cells(n_cells, Sign::NONE);
+  NnueAccumulator acc(network);
+  ttt::my_player::Rng rng;
+  for (int step = 0; step < 2000; ++step) {
+    const int cell = rng.below(n_cells);
+    const Sign sign = Sign(rng.below(3));
+    cells[cell] = sign;
+    acc.set(cell, sign);
+  }
+  NnueAccumulator fresh(network);
+  for (int cell = 0; cell < n_cells; ++cell)
+    fresh.set(cell, cells[cell]);
+  for (Sign side : {Sign::X, Sign::O}) {
+    assert(acc.evaluate(side) == fresh.evaluate(side));
+    assert(acc.evaluate(side) == acc.evaluate_scalar(side));
+  }
+  std::cout << "incremental updates: ok\n";
+
+  // a spiral of moves around the center, as in the middle game
+  std::vector<int> moves;
+  for (int r = 0; r < 4; ++r)
+    for (int dy = -r; dy <= r; ++dy)
+      for (int dx = -r; dx <= r; ++dx)
+        if (std::max(std::abs(dx), std::abs(dy)) == r)
+          moves.push_back(7 + dx + (7 + dy) * opts.cols);
+  PatternEvaluator patterns(opts);
+  NnueAccumulator nnue(network);
+  const double pattern_rate = bench_evals(patterns, moves);
+  const double nnue_rate = bench_evals(nnue, moves);
+  std::cout << "patterns: " << long(pattern_rate) << " evals/s\n"
+            << "nnue (" << network.get_n_hidden() << " x 2): "
+            << long(nnue_rate) << " evals/s\n";
+
+  // strength of the same search with either evaluation
+  SearchOpts search_opts;
+  search_opts.time_ms = 20;
+  SearchPlayer handcrafted("Patterns", search_opts);
+  search_opts.evaluator = Evaluator::NNUE;
+  search_opts.nnue_path = path;
+  SearchPlayer learned("NNUE", search_opts);
+  // else the engine silently evaluates patterns too
+  if (!learned.get_engine().get_network().is_loaded()) {
+    std::cerr << "the search did not load " << path << '\n';
+    return 1;
+  }
+  auto as_x = ttt::test::run_game_tests(learned, handcrafted, n_games);
+  ttt::test::print_test_results(as_x, "NNUE", "Patterns");
+  auto as_o = ttt::test::run_game_tests(handcrafted, learned, n_games);
+  ttt::test::print_test_results(as_o, "Patterns", "NNUE");
+  std::cout << "NNUE vs patterns: " << as_x.x_wins + as_o.o_wins << " wins, "
+            << as_x.o_wins + as_o.x_wins << " losses, "
+            << as_x.draws + as_o.draws << " draws\n";
+
+  if (trained_here)
+    std::remove(path.c_str());
+  return 0;
+}
@@ -0,0 +1,103 @@
+#include "core/game.hpp"
+#include "core/static_game.hpp"
+#include "player/my_observer.hpp"
+#include "player/my_player.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace ttt::game;
+
+// Cheapest legal player: the loop overhead dominates its self-play.
+class ScanPlayer : public IPlayer {
+  int m_last = 0;
+
+public:
+  void set_sign(Sign sign) override { m_last = 0; }
+  const char *get_name() const override { return "ScanPlayer"; }
+  Point make_move(const State &state) override {
+    const int cols = state.get_opts().cols;
+    const int n_cells = cols * state.get_opts().rows;
+    if (state.get_move_no() == 0)
+      m_last = 0;
+    for (; m_last < n_cells; ++m_last)
+      if (state.get_value(m_last % cols, m_last / cols) == Sign::NONE)
+        break;
+    return Point{m_last % cols, m_last / cols};
+  }
+};
+
+// Observer which only counts moves, so observer dispatch is measured too.
+class MoveCounter : public IObserver {
+public:
+  long n_moves = 0;
+  void handle_event(const State &state, const Event &event) override {
+    if (event.type == EventType::MOVE)
+      ++n_moves;
+  }
+};
+
+template <class GameLoop> static double time_games(GameLoop &&loop) {
+  auto start = std::chrono::steady_clock::now();
+  loop();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Both loops play fresh copies of `player` from the same master seed, so they
+// play the same games.
+template <class Player>
+static void bench(const char *title, const Player &player, int n_games,
+                  unsigned seed) {
+  State::Opts opts;
+  opts.rows = opts.cols = 15;
+  opts.win_len = 5;
+  opts.max_moves = 0;
+
+  MoveCounter dyn_counter, static_counter;
+
+  ttt::my_player::set_master_seed(seed);
+  Player p1 = player, p2 = player;
+  Game dyn_game(opts);
+  dyn_game.add_player(Sign::X, &p1);
+  dyn_game.add_player(Sign::O, &p2);
+  dyn_game.add_observer(&dyn_counter);
+  const double dyn_ms = time_games([&] {
+    for (int i = 0; i < n_games; ++i) {
+      while (dyn_game.process() == MoveResult::OK)
+        ;
+      dyn_game.reset();
+    }
+  });
+
+  Player q1 = player, q2 = player;
+  StaticGame static_game(opts, q1, q2, static_counter);
+  const double static_ms = time_games([&] {
+    for (int i = 0; i < n_games; ++i) {
+      while (static_game.process() == MoveResult::OK)
+        ;
+      static_game.reset();
+    }
+  });
+
+  std::cout << title << ": " << n_games << " games\n"
+            << " - Game:       " << dyn_ms << " ms, "
+            << dyn_counter.n_moves / dyn_ms * 1000 << " moves/s\n"
+            << " - StaticGame: " << static_ms << " ms, "
+            << static_counter.n_moves / static_ms * 1000 << " moves/s\n"
+            << " - speedup: " << dyn_ms / static_ms << "x\n";
+  if (dyn_counter.n_moves != static_counter.n_moves)
+    std::cout << " ! move counts differ: " << dyn_counter.n_moves << " vs "
+              << static_counter.n_moves << "\n";
+}
+
+int main(int argc, char *argv[]) {
+  unsigned seed = argc >= 2 ? atoi(argv[1]) : 1;
+  int n_games = argc >= 3 ? atoi(argv[2]) : 2000;
+
+  bench("ScanPlayer self-play", ScanPlayer(), n_games, seed);
+  bench("MyPlayer self-play", ttt::my_player::MyPlayer("MyPlayer"), n_games,
+        seed);
+  return 0;
+}
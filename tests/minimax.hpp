@@ -0,0 +1,55 @@
+#pragma once
+
+#include "core/game.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+namespace ttt::test {
+
+// Key of a small position: the cells in base 3 and whether the next move
+// is the last one.
+inline uint64_t position_code(const game::State &state) {
+  uint64_t code = 0;
+  const auto &opts = state.get_opts();
+  for (int y = 0; y < opts.rows; ++y)
+    for (int x = 0; x < opts.cols; ++x)
+      code = code * 3 + int(state.get_value(x, y));
+  return code * 2 + (state.get_status() == game::Status::LAST_MOVE);
+}
+
+// Plain minimax over `State` as the ground truth: 1 if the side to move
+// wins, 0 for a draw, -1 for a loss.
+class Minimax {
+  std::unordered_map<uint64_t, int> m_memo;
+
+public:
+  // Value of playing (x, y).
+  int move_value(const game::State &state, int x, int y) {
+    game::State next = state;
+    const game::Sign side = state.get_current_player();
+    const game::MoveResult result = next.process_move(side, x, y);
+    if (result == game::MoveResult::OK)
+      return -value(next);
+    if (result == game::MoveResult::DRAW)
+      return 0;
+    return next.get_winner() == side ? 1 : -1;
+  }
+
+  int value(const game::State &state) {
+    const uint64_t key = position_code(state);
+    auto it = m_memo.find(key);
+    if (it != m_memo.end())
+      return it->second;
+    const auto &opts = state.get_opts();
+    int best = -1;
+    for (int y = 0; y < opts.rows && best < 1; ++y)
+      for (int x = 0; x < opts.cols && best < 1; ++x)
+        if (state.get_value(x, y) == game::Sign::NONE)
+          best = std::max(best, move_value(state, x, y));
+    return m_memo[key] = best;
+  }
+};
+
+} // namespace ttt::test
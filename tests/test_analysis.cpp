@@ -0,0 +1,106 @@
+#include "player/analysis.hpp"
+#include "player/rng.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using ttt::game::Sign;
+using ttt::game::State;
+using ttt::my_player::AnalysisPool;
+using ttt::my_player::AnalysisResult;
+using ttt::my_player::AnalysisStats;
+
+static State random_position(const State::Opts &opts, int n_moves,
+                             ttt::my_player::Rng &rng) {
+  State state(opts);
+  while (state.get_move_no() < n_moves) {
+    const int x = opts.cols / 2 - 3 + int(rng.below(7));
+    const int y = opts.rows / 2 - 3 + int(rng.below(7));
+    if (state.get_value(x, y) != Sign::NONE)
+      continue;
+    if (state.process_move(state.get_current_player(), x, y) !=
+        ttt::game::MoveResult::OK)
+      return State(opts);
+  }
+  return state;
+}
+
+// The moves of the variation are legal from the position.
+static void check_result(const State &position, const AnalysisResult &result) {
+  assert(!result.ended && !result.pv.empty());
+  assert(result.pv[0].x == result.best.x && result.pv[0].y == result.best.y);
+  State state = position;
+  for (const auto &move : result.pv) {
+    assert(state.get_value(move.x, move.y) == Sign::NONE);
+    state.process_move(state.get_current_player(), move.x, move.y);
+  }
+}
+
+static void print_stats(const AnalysisStats &stats) {
+  std::cout << stats.positions << " positions in " << stats.batches
+            << " batches, " << stats.get_pps() << " positions/s, cache hits "
+            << stats.get_cache_hit_rate() << ", latency p50 " << stats.p50_ms
+            << " ms, p90 " << stats.p90_ms << " ms, p99 " << stats.p99_ms
+            << " ms\n";
+}
+
+int main(int argc, char *argv[]) {
+  std::cout << "Testing the analysis pool\n";
+  const int n_positions = argc >= 2 ? atoi(argv[1]) : 12;
+  ttt::my_player::Rng rng(1);
+
+  ttt::my_player::AnalysisOpts opts;
+  opts.search.time_ms = 20;
+  opts.n_workers = 3;
+  AnalysisPool pool(opts);
+
+  const State::Opts board = {15, 15, 5, 0};
+  std::vector<State> batch;
+  for (int i = 0; i < n_positions; ++i)
+    batch.push_back(random_position(board, 2 + int(rng.below(12)), rng));
+  // a repeat, a position won by O and an immediate win
+  batch.push_back(batch[0]);
+  State won(board);
+  for (int i = 0; i < 5; ++i) {
+    won.process_move(Sign::X, 2 * i, 0);
+    won.process_move(Sign::O, i, 5);
+  }
+  assert(won.get_status() == ttt::game::Status::ENDED);
+  batch.push_back(won);
+  State four(board);
+  for (int i = 0; i < 4; ++i) {
+    four.process_move(Sign::X, 3 + i, 7);
+    four.process_move(Sign::O, 3 + 2 * i, 9);
+  }
+  batch.push_back(four);
+
+  const std::vector<AnalysisResult> results = pool.analyze(batch);
+  assert(results.size() == batch.size());
+  for (int i = 0; i < n_positions; ++i) {
+    check_result(batch[i], results[i]);
+    assert(!results[i].cached);
+  }
+  const AnalysisResult &repeat = results[n_positions];
+  assert(repeat.cached && repeat.best.x == results[0].best.x &&
+         repeat.best.y == results[0].best.y);
+  assert(results[n_positions + 1].ended);
+  const AnalysisResult &win = results[n_positions + 2];
+  check_result(four, win);
+  assert((win.best.x == 2 || win.best.x == 7) && win.best.y == 7);
+  assert(win.score >= ttt::my_player::WIN_SCORE - ttt::my_player::MAX_PLY);
+  std::cout << "first batch: ok\n";
+  print_stats(pool.get_stats());
+
+  // the same positions again come from the cache
+  const std::vector<AnalysisResult> again = pool.analyze(batch);
+  for (size_t i = 0; i < batch.size(); ++i)
+    assert(again[i].cached && again[i].best.x == results[i].best.x &&
+           again[i].best.y == results[i].best.y);
+  const AnalysisStats stats = pool.get_stats();
+  assert(stats.batches == 2 && stats.positions == 2 * long(batch.size()));
+  assert(stats.cache_hits == long(batch.size()) + 1);
+  std::cout << "second batch: ok\n";
+  print_stats(stats);
+  return 0;
+}
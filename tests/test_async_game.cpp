@@ -0,0 +1,108 @@
+#include "core/async_game.hpp"
+#include "player/my_player.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace ttt::game;
+
+// Async player which parks every move request until the batch is flushed,
+// like a player waiting for network input or a batched evaluator.
+class BatchedPlayer : public IAsyncPlayer {
+  struct Request {
+    const State *state;
+    AsyncResult<Point> *result;
+  };
+
+  Scheduler &m_scheduler;
+  ttt::my_player::MyPlayer m_policy;
+  std::vector<Request> m_pending;
+
+public:
+  BatchedPlayer(Scheduler &scheduler)
+      : m_scheduler(scheduler), m_policy("Batched") {}
+
+  void set_sign(Sign sign) override {}
+  const char *get_name() const override { return m_policy.get_name(); }
+
+  Task<Point> make_move(const State &state) override {
+    AsyncResult<Point> result(m_scheduler);
+    m_pending.push_back({&state, &result});
+    co_return co_await result;
+  }
+
+  int flush() {
+    auto batch = std::move(m_pending);
+    m_pending.clear();
+    for (auto &req : batch)
+      req.result->set(m_policy.make_move(*req.state));
+    return batch.size();
+  }
+};
+
+int main(int argc, char *argv[]) {
+  if (argc >= 2) {
+    ttt::my_player::set_master_seed(atoi(argv[1]));
+  }
+  const int n_games = argc >= 3 ? atoi(argv[2]) : 2000;
+
+  State::Opts opts;
+  opts.rows = opts.cols = 15;
+  opts.win_len = 5;
+  opts.max_moves = 0;
+
+  Scheduler scheduler;
+  ttt::my_player::MyPlayer blocking("MyPlayer");
+  BlockingPlayerAdapter adapter(blocking);
+  BatchedPlayer batched(scheduler);
+
+  std::vector<std::unique_ptr<AsyncGame>> games;
+  for (int i = 0; i < n_games; ++i) {
+    games.emplace_back(new AsyncGame(opts));
+    games.back()->add_player(Sign::X, &adapter);
+    games.back()->add_player(Sign::O, &batched);
+    scheduler.spawn(games.back()->play(&scheduler));
+  }
+
+  int n_batches = 0, max_batch = 0;
+  do {
+    scheduler.run();
+    const int batch = batched.flush();
+    if (batch > 0)
+      ++n_batches;
+    if (batch > max_batch)
+      max_batch = batch;
+  } while (scheduler.has_ready());
+  assert(scheduler.all_done());
+
+  int x_wins = 0, o_wins = 0, draws = 0, errors = 0;
+  for (int i = 0; i < n_games; ++i) {
+    const MoveResult res = scheduler.get_tasks()[i].get();
+    const Sign winner = games[i]->get_state().get_winner();
+    if (res == MoveResult::DRAW)
+      ++draws;
+    else if (res == MoveResult::WIN && winner == Sign::X)
+      ++x_wins;
+    else if (res == MoveResult::WIN && winner == Sign::O)
+      ++o_wins;
+    else
+      ++errors;
+  }
+
+  std::cout << "games: " << n_games << "\n"
+            << "X wins: " << x_wins << "\n"
+            << "O wins: " << o_wins << "\n"
+            << "draws:  " << draws << "\n"
+            << "errors: " << errors << "\n"
+            << "batches: " << n_batches << ", max batch: " << max_batch
+            << "\n";
+
+  assert(errors == 0);
+  assert(x_wins + o_wins + draws == n_games);
+  // every O move of every running game waits in the same batch
+  assert(max_batch == n_games);
+  return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+#include "player/eval_cache.hpp"
+#include "player/match.hpp"
+#include "player/rng.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using ttt::my_player::EvalCache;
+using ttt::my_player::EvalCacheStats;
+
+static void print_stats(const char *name, const EvalCacheStats &stats) {
+  std::cout << name << ": " << stats.probes << " probes, hit rate "
+            << stats.get_hit_rate() << ", " << stats.stores << " stores, "
+            << stats.evictions << " evictions\n";
+}
+
+static void test_probe_store() {
+  EvalCache cache(1);
+  int value = 0;
+  const bool empty_hit = cache.probe(12345, value);
+  assert(!empty_hit);
+  cache.store(12345, -300);
+  const bool hit = cache.probe(12345, value);
+  assert(hit && value == -300);
+  cache.store(12345, 77);
+  const bool new_hit = cache.probe(12345, value);
+  assert(new_hit && value == 77);
+  const EvalCacheStats stats = cache.get_stats();
+  assert(stats.probes == 3 && stats.hits == 2 && stats.stores == 2);
+  assert(stats.evictions == 0);
+  cache.clear();
+  const bool cleared_hit = cache.probe(12345, value);
+  assert(!cleared_hit);
+  std::cout << "probe and store: ok\n";
+}
+
+// Keys of one bucket differ in the tag bits only.
+static void test_clock_replacement() {
+  EvalCache cache(1);
+  auto key = [](int i) { return uint64_t(i) << 33 | 5; };
+  for (int i = 1; i <= EvalCache::BUCKET_SIZE; ++i)
+    cache.store(key(i), i);
+  int value;
+  // probes mark the entries as used
+  for (int i = 1; i <= 3; ++i) {
+    const bool hit = cache.probe(key(i), value);
+    assert(hit && value == i);
+  }
+  // the new keys replace the ones not used since they were stored
+  for (int i = 8; i <= 11; ++i)
+    cache.store(key(i), i);
+  for (int i = 1; i <= 11; ++i) {
+    const bool hit = cache.probe(key(i), value);
+    assert(hit == (i <= 3 || i >= 8));
+  }
+  assert(cache.get_stats().evictions == 4);
+  std::cout << "clock replacement: ok\n";
+}
+
+static int expected_value(uint64_t key) { return int32_t(key >> 17); }
+
+// Threads probe and store overlapping keys; every hit holds the value of its
+// own key.
+static void test_threads(int n_threads, int n_ops) {
+  EvalCache cache(1);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < n_threads; ++t)
+    threads.emplace_back([&cache, t, n_ops] {
+      ttt::my_player::Rng rng(t + 1);
+      for (int i = 0; i < n_ops; ++i) {
+        const uint64_t key = (rng.below(50000) + 1) * 0x9e3779b97f4a7c15ULL;
+        int value;
+        if (cache.probe(key, value))
+          assert(value == expected_value(key));
+        else
+          cache.store(key, expected_value(key));
+      }
+    });
+  for (auto &thread : threads)
+    thread.join();
+  print_stats("threads", cache.get_stats());
+  std::cout << "threads: ok\n";
+}
+
+int main(int argc, char *argv[]) {
+  std::cout << "Testing the evaluation cache\n";
+  const int n_games = argc >= 2 ? atoi(argv[1]) : 4;
+  test_probe_store();
+  test_clock_replacement();
+  test_threads(4, 200000);
+
+  assert(EvalCache::get_shared(4) == EvalCache::get_shared(4));
+  assert(EvalCache::get_shared(4) != EvalCache::get_shared(8));
+
+  // parallel games of two engines share the process-wide cache
+  auto cache = EvalCache::get_shared(4);
+  ttt::my_player::MatchOpts opts;
+  opts.games = n_games;
+  opts.n_threads = 2;
+  ttt::my_player::MatchResult result;
+  std::string error;
+  const char *spec = "search:time=5,eval_cache=4";
+  if (!ttt::my_player::run_match(spec, spec, opts, result, error)) {
+    std::cerr << "error: " << error << '\n';
+    return 1;
+  }
+  const EvalCacheStats stats = cache->get_stats();
+  print_stats("parallel games", stats);
+  assert(result.get_games() == n_games && stats.hits > 0);
+  std::cout << "parallel games: ok\n";
+  return 0;
+}
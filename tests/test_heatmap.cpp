@@ -0,0 +1,129 @@
+#include "player/heatmap.hpp"
+#include "player/rng.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using ttt::game::Sign;
+using ttt::game::State;
+using ttt::my_player::Bitboard;
+using ttt::my_player::MoveHeatmap;
+using ttt::my_player::opp_sign;
+
+using Clock = std::chrono::steady_clock;
+
+static void assert_same(const MoveHeatmap &a, const MoveHeatmap &b) {
+  for (Sign side : {Sign::X, Sign::O})
+    assert(a.get_scores(side) == b.get_scores(side));
+}
+
+// Plays random games near the stones, checking the updated map against a
+// full one and the best cells against the lines on the board.
+static void test_board(const State::Opts &opts, int n_games,
+                       ttt::my_player::Rng &rng) {
+  assert(MoveHeatmap::supports(opts));
+  long long n_moves = 0;
+  for (int game = 0; game < n_games; ++game) {
+    Bitboard board(opts);
+    MoveHeatmap heatmap;
+    heatmap.compute(board);
+    while (!board.is_full()) {
+      const Sign side = board.get_current_player();
+      const int best = heatmap.get_best(side);
+      assert(best >= 0 && board.is_empty(best));
+      bool can_win = false, must_block = false;
+      for (int idx = 0; idx < board.get_n_cells(); ++idx)
+        if (board.is_empty(idx)) {
+          can_win |= board.makes_line(idx, side);
+          must_block |= board.makes_line(idx, opp_sign(side));
+        } else {
+          assert(heatmap.get_score(idx, side) == -1);
+        }
+      if (can_win)
+        assert(board.makes_line(best, side));
+      else if (must_block)
+        assert(board.makes_line(best, opp_sign(side)));
+      if (can_win || must_block)
+        break;
+
+      const std::vector<int> &frontier = board.get_frontier();
+      int idx = best;
+      if (rng.below(2) == 0 && !frontier.empty()) {
+        idx = frontier[rng.below(frontier.size())];
+        if (!board.is_empty(idx))
+          idx = best;
+      }
+      board.place(idx, side);
+      heatmap.update(board, idx);
+      ++n_moves;
+
+      MoveHeatmap full;
+      full.compute(board);
+      assert_same(heatmap, full);
+    }
+  }
+  std::cout << opts.rows << "x" << opts.cols << ", " << opts.win_len
+            << " in a row: " << n_moves << " updates: ok\n";
+}
+
+// Lines in two directions through one cell add up beyond int16_t; the score
+// saturates instead of wrapping around.
+static void test_double_line() {
+  Bitboard board({15, 15, 5, 0});
+  for (int i = 3; i < 7; ++i) {
+    board.place(board.index(i, 7), Sign::X);
+    board.place(board.index(7, i), Sign::X);
+  }
+  MoveHeatmap heatmap;
+  heatmap.compute(board);
+  const int cross = board.index(7, 7);
+  assert(heatmap.get_score(cross, Sign::X) == 32767);
+  assert(heatmap.get_score(cross, Sign::O) > 0);
+  assert(heatmap.get_best(Sign::X) == cross);
+  assert(heatmap.get_best(Sign::O) == cross);
+  std::cout << "double line: ok\n";
+}
+
+int main(int argc, char *argv[]) {
+  std::cout << "Testing the move heatmap\n";
+  const int n_games = argc >= 2 ? atoi(argv[1]) : 10;
+  ttt::my_player::Rng rng(1);
+
+  test_double_line();
+  test_board({15, 15, 5, 0}, n_games, rng);
+  test_board({3, 3, 3, 0}, n_games, rng);
+  test_board({7, 9, 4, 0}, n_games, rng);
+  test_board({6, 40, 5, 0}, n_games, rng);
+  test_board({21, 10, 6, 0}, n_games, rng);
+
+  // the cost of a whole board and of an update in a middle game
+  Bitboard board({15, 15, 5, 0});
+  MoveHeatmap heatmap;
+  heatmap.compute(board);
+  for (int i = 0; i < 40; ++i) {
+    const std::vector<int> &frontier = board.get_frontier();
+    int idx = frontier.empty() ? board.index(7, 7)
+                               : frontier[rng.below(frontier.size())];
+    while (!board.is_empty(idx))
+      idx = rng.below(board.get_n_cells());
+    board.place(idx, board.get_current_player());
+  }
+  const int n_runs = 2000;
+  auto start = Clock::now();
+  for (int i = 0; i < n_runs; ++i)
+    heatmap.compute(board);
+  const double full_us =
+      std::chrono::duration<double, std::micro>(Clock::now() - start).count() /
+      n_runs;
+  start = Clock::now();
+  for (int i = 0; i < n_runs; ++i)
+    heatmap.update(board, board.index(i % 15, 7));
+  const double update_us =
+      std::chrono::duration<double, std::micro>(Clock::now() - start).count() /
+      n_runs;
+  std::cout << "15x15 board: " << full_us << " us per map, " << update_us
+            << " us per update\n";
+  return 0;
+}
@@ -0,0 +1,99 @@
+#include "player/bitboard.hpp"
+#include "player/mcts.hpp"
+#include "player/my_player.hpp"
+#include "player/rng.hpp"
+#include "test_stats.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using ttt::game::Sign;
+using ttt::game::State;
+using ttt::my_player::Bitboard;
+using ttt::my_player::MctsPlayer;
+
+// Longest run of `sign` through the cell of the grid, counting the cell.
+static int reference_run(const std::vector<Sign> &cells,
+                         const State::Opts &opts, int cx, int cy, Sign sign) {
+  static const int directions[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+  int longest = 0;
+  for (auto &dir : directions) {
+    int count = 1;
+    for (int side = -1; side <= 1; side += 2) {
+      int x = cx + side * dir[0], y = cy + side * dir[1];
+      while (x >= 0 && x < opts.cols && y >= 0 && y < opts.rows &&
+             cells[x + y * opts.cols] == sign) {
+        ++count;
+        x += side * dir[0];
+        y += side * dir[1];
+      }
+    }
+    longest = std::max(longest, count);
+  }
+  return longest;
+}
+
+// Line words of the bitboard agree with walking the cells, also on boards
+// too large for them. Marks are placed at random, lines or not.
+static void test_lines(const State::Opts &opts, int n_positions,
+                       ttt::my_player::Rng &rng) {
+  for (int n = 0; n < n_positions; ++n) {
+    std::vector<Sign> cells(opts.rows * opts.cols, Sign::NONE);
+    Bitboard board(opts);
+    const int n_marks = int(rng.below(opts.rows * opts.cols * 2 / 3));
+    for (int i = 0; i < n_marks; ++i) {
+      const int x = int(rng.below(opts.cols)), y = int(rng.below(opts.rows));
+      if (cells[x + y * opts.cols] != Sign::NONE)
+        continue;
+      const Sign sign = i % 2 ? Sign::O : Sign::X;
+      cells[x + y * opts.cols] = sign;
+      board.place(board.index(x, y), sign);
+    }
+    for (int y = 0; y < opts.rows; ++y)
+      for (int x = 0; x < opts.cols; ++x)
+        for (Sign sign : {Sign::X, Sign::O})
+          assert(board.makes_line(board.index(x, y), sign) ==
+                 (reference_run(cells, opts, x, y, sign) >= opts.win_len));
+  }
+  std::cout << "lines " << opts.rows << "x" << opts.cols << "/"
+            << opts.win_len << ": ok\n";
+}
+
+int main(int argc, char *argv[]) {
+  std::cout << "Testing MctsPlayer vs MyPlayer\n";
+  if (argc >= 2) {
+    ttt::my_player::set_master_seed(atoi(argv[1]));
+  }
+  const int n_games = argc >= 3 ? atoi(argv[2]) : 3;
+  ttt::my_player::Rng rng(1);
+  test_lines({5, 5, 4, 0}, 200, rng);
+  test_lines({15, 15, 5, 0}, 50, rng);
+  test_lines({9, 20, 5, 0}, 50, rng);
+  test_lines({64, 64, 5, 0}, 5, rng);
+  test_lines({70, 3, 3, 0}, 20, rng);
+
+  // two threads exercise the shared tree even on a single core
+  ttt::my_player::MctsOpts opts;
+  opts.time_ms = 20;
+  opts.n_threads = 2;
+  opts.arena_nodes = 1 << 16;
+  MctsPlayer mcts("MctsPlayer", opts);
+  ttt::my_player::MyPlayer random("MyPlayer");
+
+  auto as_x = ttt::test::run_game_tests(mcts, random, n_games);
+  ttt::test::print_test_results(as_x, "MctsPlayer", "MyPlayer");
+  auto as_o = ttt::test::run_game_tests(random, mcts, n_games);
+  ttt::test::print_test_results(as_o, "MyPlayer", "MctsPlayer");
+
+  auto &info = mcts.get_last_info();
+  std::cout << "MctsPlayer last move:\n - iterations per second: "
+            << long(info.get_ips()) << "\n - threads: " << info.n_threads
+            << "\n - tree nodes: " << info.nodes
+            << "\n - reused nodes: " << info.reused_nodes << "\n\n";
+
+  assert(as_x.x_wins == n_games);
+  assert(as_o.o_wins == n_games);
+  return 0;
+}
@@ -0,0 +1,154 @@
+#include "player/analysis.hpp"
+#include "player/my_player.hpp"
+#include "player/rng.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+
+using ttt::game::MoveResult;
+using ttt::game::Sign;
+using ttt::game::State;
+using ttt::game::Status;
+using ttt::my_player::IMultiPvPlayer;
+using ttt::my_player::RankedLine;
+using ttt::my_player::SearchContext;
+using ttt::my_player::SearchEngine;
+using ttt::my_player::SearchOpts;
+using ttt::my_player::WIN_SCORE;
+
+static int to_value(int score) {
+  const int threshold = WIN_SCORE - 2 * ttt::my_player::MAX_PLY;
+  return score >= threshold ? 1 : score <= -threshold ? -1 : 0;
+}
+
+// Distinct legal moves, best first, each starting its line.
+static void check_lines(const State &state,
+                        const std::vector<RankedLine> &lines) {
+  std::set<std::pair<int, int>> moves;
+  for (size_t i = 0; i < lines.size(); ++i) {
+    const RankedLine &line = lines[i];
+    assert(state.get_value(line.move.x, line.move.y) == Sign::NONE);
+    assert(moves.insert({line.move.x, line.move.y}).second);
+    assert(i == 0 || lines[i - 1].score >= line.score);
+    assert(!line.pv.empty() && line.pv[0].x == line.move.x &&
+           line.pv[0].y == line.move.y);
+    State next = state;
+    for (const auto &move : line.pv) {
+      assert(next.get_value(move.x, move.y) == Sign::NONE);
+      next.process_move(next.get_current_player(), move.x, move.y);
+    }
+  }
+}
+
+// Small boards are searched to the end, so every line must agree with a
+// single search of the position after its move.
+static void test_small(const State::Opts &board, int n_positions,
+                       ttt::my_player::Rng &rng) {
+  SearchOpts opts;
+  opts.time_ms = 100000;
+  opts.tt_size_mb = 1;
+  opts.use_threat_solver = false;
+  SearchEngine engine(opts);
+  int n_checked = 0;
+  for (int n = 0; n < n_positions;) {
+    State state(board);
+    const int n_moves = 1 + int(rng.below(board.rows * board.cols / 2));
+    bool playing = true;
+    for (int i = 0; i < n_moves && playing; ++i) {
+      int x, y;
+      do {
+        x = int(rng.below(board.cols));
+        y = int(rng.below(board.rows));
+      } while (state.get_value(x, y) != Sign::NONE);
+      playing = state.process_move(state.get_current_player(), x, y) ==
+                    MoveResult::OK &&
+                state.get_status() == Status::ACTIVE;
+    }
+    if (!playing)
+      continue;
+    ++n;
+
+    // every candidate gets a line
+    SearchContext ctx;
+    const auto lines =
+        engine.get_top_lines(ctx, state, board.rows * board.cols);
+    check_lines(state, lines);
+    SearchContext single_ctx;
+    engine.make_move(single_ctx, state);
+    assert(to_value(lines[0].score) ==
+           to_value(single_ctx.last_info.score));
+    for (const auto &line : lines) {
+      State next = state;
+      if (next.process_move(state.get_current_player(), line.move.x,
+                            line.move.y) != MoveResult::OK ||
+          next.get_status() != Status::ACTIVE)
+        continue;
+      SearchContext child_ctx;
+      engine.make_move(child_ctx, next);
+      assert(to_value(line.score) == -to_value(child_ctx.last_info.score));
+      ++n_checked;
+    }
+  }
+  std::cout << board.rows << "x" << board.cols << ", " << board.win_len
+            << " in a row: " << n_positions << " positions, " << n_checked
+            << " lines: ok" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  std::cout << "Testing multi-PV search\n";
+  ttt::my_player::Rng rng(1);
+  test_small({3, 3, 3, 0}, 40, rng);
+  test_small({3, 4, 3, 0}, 20, rng);
+
+  // on a big board the lines share the table: K lines cost far less than K
+  // searches of the same depth
+  SearchOpts opts;
+  opts.time_ms = 100000;
+  opts.max_depth = 4;
+  opts.use_threat_solver = false;
+  State state({15, 15, 5, 0});
+  const int moves[][2] = {{7, 7}, {8, 8}, {8, 7}, {6, 7}, {7, 8}, {9, 9}};
+  for (const auto &move : moves)
+    state.process_move(state.get_current_player(), move[0], move[1]);
+  const int n_lines = 4;
+  SearchEngine engine(opts);
+  SearchContext multi_ctx;
+  const auto lines = engine.get_top_lines(multi_ctx, state, n_lines);
+  check_lines(state, lines);
+  assert(int(lines.size()) == n_lines);
+  assert(multi_ctx.last_info.depth == opts.max_depth);
+  const long long multi_nodes = multi_ctx.last_info.nodes;
+  SearchContext single_ctx;
+  engine.make_move(single_ctx, state);
+  const long long single_nodes = single_ctx.last_info.nodes;
+  std::cout << n_lines << " lines: " << multi_nodes << " nodes, one line: "
+            << single_nodes << " nodes\n";
+  assert(multi_nodes < n_lines * single_nodes);
+
+  // through the player API, and players which cannot rank moves
+  ttt::my_player::SearchPlayer search("SearchPlayer", opts);
+  auto *multi_pv = dynamic_cast<IMultiPvPlayer *>(&search);
+  assert(multi_pv);
+  assert(int(multi_pv->get_top_lines(state, 2).size()) == 2);
+  ttt::my_player::MyPlayer random("MyPlayer");
+  auto *random_pv = dynamic_cast<IMultiPvPlayer *>(&random);
+  assert(!random_pv || random_pv->get_top_lines(state, 2).empty());
+  std::cout << "player API: ok\n";
+
+  // and through the analysis pool
+  ttt::my_player::AnalysisOpts analysis_opts;
+  analysis_opts.search = opts;
+  analysis_opts.n_workers = 1;
+  analysis_opts.multi_pv = 3;
+  ttt::my_player::AnalysisPool pool(analysis_opts);
+  const auto result = pool.analyze(state);
+  check_lines(state, result.lines);
+  assert(int(result.lines.size()) == 3);
+  assert(result.best.x == result.lines[0].move.x &&
+         result.best.y == result.lines[0].move.y);
+  assert(result.score == result.lines[0].score);
+  std::cout << "analysis pool: ok\n";
+  return 0;
+}
@@ -10,7 +10,7 @@
 int main(int argc, char *argv[]) {
   std::cout << "Hello!\n";
   if (argc >= 2) {
-    std::srand(atoi(argv[1]));
+    ttt::my_player::set_master_seed(atoi(argv[1]));
   }
 
   ttt::game::State::Opts opts;
@@ -0,0 +1,112 @@
+#include "player/book_builder.hpp"
+#include "player/search.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+using ttt::game::Point;
+using ttt::game::Sign;
+using ttt::game::State;
+using ttt::my_player::Board;
+using ttt::my_player::BookBuilder;
+using ttt::my_player::OpeningBook;
+
+int main() {
+  std::cout << "Testing OpeningBook\n";
+  const State::Opts opts = {15, 15, 5, 225};
+  const std::string path = "test_opening_book.bin";
+
+  // a tiny book: the first three moves, two candidates expanded each
+  BookBuilder builder(opts);
+  ttt::my_player::BookBuildOpts build_opts;
+  build_opts.plies = 3;
+  build_opts.candidates = 3;
+  build_opts.width = 2;
+  build_opts.n_threads = 2;
+  ttt::my_player::SearchOpts search_opts;
+  search_opts.time_ms = 5;
+  build_book_by_search(builder, search_opts, build_opts, &std::cout);
+  // and a hand-made entry for a position with no symmetries, added through
+  // one of its rotations
+  Board rotated(opts);
+  for (Point p : {Point{9, 6}, Point{10, 7}, Point{8, 8}}) {
+    const Point r = ttt::my_player::apply_symmetry(opts, 5, p);
+    rotated.place(rotated.index(r.x, r.y));
+  }
+  const Point best = ttt::my_player::apply_symmetry(opts, 5, {11, 5});
+  const Point second = ttt::my_player::apply_symmetry(opts, 5, {7, 9});
+  builder.add_search_result(rotated, rotated.index(best.x, best.y), 300, 6);
+  builder.add_search_result(rotated, rotated.index(second.x, second.y), 20,
+                            6);
+  const bool written = builder.write(path);
+  assert(written);
+
+  OpeningBook book;
+  const bool opened = book.open(path);
+  assert(opened);
+  std::cout << "positions: " << book.get_n_positions() << '\n';
+  assert(book.get_n_positions() >= 3);
+
+  // the empty board has only the center
+  Board empty(opts);
+  auto moves = book.probe(empty);
+  assert(moves.size() == 1 && moves[0].move.x == 7 && moves[0].move.y == 7);
+
+  // symmetric positions share the entry, with the moves mirrored
+  Board position(opts), mirrored(opts);
+  for (Point p : {Point{9, 6}, Point{10, 7}, Point{8, 8}}) {
+    position.place(position.index(p.x, p.y));
+    mirrored.place(mirrored.index(14 - p.x, p.y));
+  }
+  auto direct = book.probe(position), flipped = book.probe(mirrored);
+  assert(direct.size() == 2 && flipped.size() == 2);
+  assert(direct[0].move.x == 11 && direct[0].move.y == 5);
+  assert(direct[1].move.x == 7 && direct[1].move.y == 9);
+  for (size_t i = 0; i < direct.size(); ++i) {
+    assert(flipped[i].move.x == 14 - direct[i].move.x);
+    assert(flipped[i].move.y == direct[i].move.y);
+    assert(flipped[i].score == direct[i].score);
+  }
+  std::cout << "symmetric lookup: ok\n";
+
+  // other options miss the book
+  assert(book.probe(Board(State::Opts{10, 10, 5, 100})).empty());
+
+  // players take book moves without searching
+  search_opts.book_path = path;
+  ttt::my_player::SearchPlayer player("SearchPlayer", search_opts);
+  State state(opts);
+  state.process_move(Sign::X, 7, 7);
+  const Point reply = book.probe(Board(state))[0].move;
+  const Point move = player.make_move(state);
+  assert(player.get_last_info().book);
+  assert(move.x == reply.x && move.y == reply.y);
+  std::cout << "book move: (" << move.x << ", " << move.y << ")\n";
+
+  book.close();
+
+  // entries pointing past the moves are ignored instead of read
+  {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    ttt::my_player::book_format::Header header;
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    const uint32_t first_move = header.n_moves;
+    for (uint32_t i = 0; i < header.n_entries; ++i) {
+      file.seekp(sizeof(header) +
+                 i * sizeof(ttt::my_player::book_format::Entry) + 8);
+      file.write(reinterpret_cast<const char *>(&first_move),
+                 sizeof(first_move));
+    }
+    assert(file.good());
+  }
+  OpeningBook corrupt;
+  const bool opened_corrupt = corrupt.open(path);
+  assert(opened_corrupt);
+  assert(corrupt.probe(empty).empty() && corrupt.probe(position).empty());
+  std::cout << "corrupt entries: ok\n";
+  corrupt.close();
+  std::remove(path.c_str());
+  return 0;
+}
@@ -0,0 +1,71 @@
+#include "player/patterns.hpp"
+#include "player/rng.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using ttt::game::Sign;
+using ttt::game::State;
+using ttt::my_player::PatternEvaluator;
+using ttt::my_player::Shape;
+
+// Reference evaluation without SIMD.
+static int sum_scores(const PatternEvaluator &eval, int n_cells, Sign side) {
+  int sum = 0;
+  for (int idx = 0; idx < n_cells; ++idx)
+    sum += eval.get_cell_score(idx, side) -
+           eval.get_cell_score(idx, side == Sign::X ? Sign::O : Sign::X);
+  return sum;
+}
+
+int main(int argc, char *argv[]) {
+  std::cout << "Testing PatternEvaluator\n";
+  ttt::my_player::Rng rng(argc >= 2 ? atoi(argv[1]) : 0);
+  const State::Opts opts = {15, 15, 5, 225};
+  const int n_cells = opts.rows * opts.cols;
+  auto idx = [&](int x, int y) { return x + y * opts.cols; };
+  PatternEvaluator eval(opts);
+
+  // _XXX_ in a row: (4, 7) and (8, 7) make open fours
+  for (int x = 5; x <= 7; ++x)
+    eval.set(idx(x, 7), Sign::X);
+  assert(eval.get_shape(idx(4, 7), 0, Sign::X) == Shape::OPEN_FOUR);
+  assert(eval.get_shape(idx(8, 7), 0, Sign::X) == Shape::OPEN_FOUR);
+  assert(eval.get_shape(idx(3, 7), 0, Sign::X) == Shape::FOUR);
+  assert(eval.get_shape(idx(4, 7), 0, Sign::O) == Shape::ONE);
+  // blocking one end leaves a four
+  eval.set(idx(4, 7), Sign::O);
+  assert(eval.get_shape(idx(8, 7), 0, Sign::X) == Shape::FOUR);
+  assert(eval.get_shape(idx(9, 7), 0, Sign::X) == Shape::FOUR);
+  assert(eval.get_shape(idx(10, 7), 0, Sign::X) == Shape::THREE);
+  eval.set(idx(8, 7), Sign::X);
+  assert(eval.get_shape(idx(9, 7), 0, Sign::X) == Shape::FIVE);
+  // the edge blocks like a mark of the opponent
+  eval.set(idx(0, 0), Sign::O);
+  eval.set(idx(0, 1), Sign::O);
+  eval.set(idx(0, 2), Sign::O);
+  assert(eval.get_shape(idx(0, 3), 1, Sign::O) == Shape::FOUR);
+  std::cout << "shapes: ok\n";
+
+  // incremental updates match a fresh evaluator and the scalar sum
+  std::vector<Sign> cells(n_cells, Sign::NONE);
+  PatternEvaluator random_eval(opts);
+  for (int step = 0; step < 2000; ++step) {
+    const int cell = rng.below(n_cells);
+    const Sign sign = Sign(rng.below(3));
+    cells[cell] = sign;
+    random_eval.set(cell, sign);
+  }
+  PatternEvaluator fresh(opts);
+  for (int cell = 0; cell < n_cells; ++cell)
+    fresh.set(cell, cells[cell]);
+  for (Sign side : {Sign::X, Sign::O}) {
+    const int value = random_eval.evaluate(side);
+    assert(value == fresh.evaluate(side));
+    assert(value == sum_scores(random_eval, n_cells, side));
+  }
+  std::cout << "incremental updates: ok\n";
+  return 0;
+}
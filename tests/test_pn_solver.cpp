@@ -0,0 +1,133 @@
+#include "player/pn_solver.hpp"
+#include "player/rng.hpp"
+#include "player/search.hpp"
+#include "minimax.hpp"
+#include "test_stats.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using ttt::game::MoveResult;
+using ttt::game::Point;
+using ttt::game::Sign;
+using ttt::game::State;
+using ttt::game::Status;
+using ttt::my_player::PnResult;
+using ttt::my_player::PnSolution;
+using ttt::my_player::PnSolver;
+using ttt::test::Minimax;
+
+static int to_value(PnResult result) {
+  return result == PnResult::WIN ? 1 : result == PnResult::LOSS ? -1 : 0;
+}
+
+// Random positions still in play after at least `min_moves` moves, solved
+// both ways; fewer marks make the minimax slow.
+static void test_positions(const State::Opts &opts, int min_moves,
+                           int n_positions, ttt::my_player::Rng &rng) {
+  Minimax minimax;
+  ttt::my_player::PnSolverOpts opts_no_limit;
+  opts_no_limit.time_ms = 100000;
+  PnSolver solver(opts_no_limit);
+  int counts[3] = {0, 0, 0};
+  for (int n = 0; n < n_positions;) {
+    State state(opts);
+    const int n_moves =
+        min_moves + int(rng.below(opts.rows * opts.cols / 2));
+    bool playing = true;
+    for (int i = 0; i < n_moves && playing; ++i) {
+      int x, y;
+      do {
+        x = int(rng.below(opts.cols));
+        y = int(rng.below(opts.rows));
+      } while (state.get_value(x, y) != Sign::NONE);
+      playing = state.process_move(state.get_current_player(), x, y) ==
+                MoveResult::OK;
+    }
+    if (!playing)
+      continue;
+    ++n;
+
+    const int expected = minimax.value(state);
+    const PnSolution solution = solver.solve(state);
+    assert(solution.result != PnResult::UNKNOWN);
+    assert(to_value(solution.result) == expected);
+    // the best move keeps the value
+    assert(minimax.move_value(state, solution.move.x, solution.move.y) ==
+           expected);
+    ++counts[expected + 1];
+  }
+  std::cout << opts.rows << "x" << opts.cols << ", " << opts.win_len
+            << " in a row: " << counts[2] << " wins, " << counts[1]
+            << " draws, " << counts[0] << " losses: ok" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  std::cout << "Testing the proof-number solver\n";
+  const int n_positions = argc >= 2 ? atoi(argv[1]) : 40;
+  ttt::my_player::Rng rng(1);
+
+  PnSolver solver;
+  PnSolution empty = solver.solve(State({3, 3, 3, 0}));
+  assert(empty.result == PnResult::DRAW);
+  std::cout << "3x3 from the start: " << to_string(empty.result) << " ("
+            << empty.nodes << " nodes)" << std::endl;
+
+  // after a line of X only a line of O draws, anything else loses
+  State drawn({4, 4, 3, 0}), lost({4, 4, 3, 0});
+  for (auto [x, y] : {Point{0, 0}, Point{0, 2}, Point{1, 0}, Point{1, 2},
+                      Point{2, 0}})
+    drawn.process_move(drawn.get_current_player(), x, y);
+  for (auto [x, y] : {Point{0, 0}, Point{0, 3}, Point{1, 0}, Point{3, 3},
+                      Point{2, 0}})
+    lost.process_move(lost.get_current_player(), x, y);
+  assert(drawn.get_status() == Status::LAST_MOVE &&
+         lost.get_status() == Status::LAST_MOVE);
+  const PnSolution draw_reply = solver.solve(drawn);
+  assert(draw_reply.result == PnResult::DRAW);
+  assert(draw_reply.move.x == 2 && draw_reply.move.y == 2);
+  const PnSolution lost_reply = solver.solve(lost);
+  assert(lost_reply.result == PnResult::LOSS);
+  assert(lost.get_value(lost_reply.move.x, lost_reply.move.y) == Sign::NONE);
+  ttt::my_player::SearchEngine engine{ttt::my_player::SearchOpts()};
+  ttt::my_player::SearchContext ctx;
+  const auto lines = engine.get_top_lines(ctx, drawn, 3);
+  assert(lines.size() == 3 && lines[0].score == 0 && lines[1].score < 0);
+  assert(lines[0].move.x == 2 && lines[0].move.y == 2);
+  const Point move = engine.make_move(ctx, drawn);
+  assert(move.x == 2 && move.y == 2);
+  std::cout << "last move: ok\n";
+
+  test_positions({3, 3, 3, 0}, 1, n_positions, rng);
+  test_positions({3, 4, 3, 0}, 2, n_positions, rng);
+  test_positions({4, 4, 3, 0}, 4, n_positions, rng);
+  test_positions({4, 4, 4, 0}, 6, n_positions, rng);
+
+  // a table far too small for the proof still gives exact results
+  ttt::my_player::PnSolverOpts small;
+  small.tt_size_mb = 0;
+  PnSolver collected(small);
+  const PnSolution again = collected.solve(State({4, 4, 3, 0}));
+  assert(again.result == PnResult::DRAW);
+  assert(collected.get_stats().gc_runs > 0);
+  std::cout << "garbage collection: " << collected.get_stats().gc_runs
+            << " runs: ok\n";
+
+  // the player is exact where the solver finishes
+  ttt::my_player::set_master_seed(1);
+  ttt::my_player::PnPlayerOpts opts;
+  opts.solver.time_ms = 20;
+  opts.search.time_ms = 20;
+  ttt::my_player::PnPlayer solver_player("PnPlayer", opts);
+  ttt::my_player::SearchOpts search_opts;
+  search_opts.time_ms = 20;
+  ttt::my_player::SearchPlayer search("SearchPlayer", search_opts);
+  auto as_x = ttt::test::run_game_tests(solver_player, search, 2, 4, 3);
+  ttt::test::print_test_results(as_x, "PnPlayer", "SearchPlayer");
+  auto as_o = ttt::test::run_game_tests(search, solver_player, 2, 4, 3);
+  ttt::test::print_test_results(as_o, "SearchPlayer", "PnPlayer");
+  // 4x4 with 3 in a row is a draw: the solver never loses it
+  assert(as_x.o_wins == 0 && as_o.x_wins == 0);
+  return 0;
+}
@@ -0,0 +1,70 @@
+#include "player/registry.hpp"
+#include "player/search.hpp"
+#include "test_stats.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using ttt::my_player::PlayerParams;
+using ttt::my_player::PlayerRegistry;
+
+// Plays the players given as specs against each other:
+//   test_registry [seed] [n_games] [player_x] [player_o]
+int main(int argc, char *argv[]) {
+  std::cout << "Testing PlayerRegistry\n";
+  if (argc >= 2) {
+    ttt::my_player::set_master_seed(atoi(argv[1]));
+  }
+  const int n_games = argc >= 3 ? atoi(argv[2]) : 2;
+  const char *spec_x = argc >= 4 ? argv[3] : "search:time=10,threads=1";
+  const char *spec_o = argc >= 5 ? argv[4] : "random";
+
+  PlayerParams params;
+  std::string error;
+  // the getters mark keys as read, which `get_errors` depends on
+  const bool parsed =
+      params.parse("time=20,eval=nnue,verbose=on,,ratio=0.5", error);
+  const int time_ms = params.get_int("time", 0);
+  const int depth = params.get_int("depth", 7);
+  const std::string eval = params.get_string("eval", "");
+  const bool verbose = params.get_bool("verbose", false);
+  const double ratio = params.get_double("ratio", 0);
+  assert(parsed && time_ms == 20 && depth == 7 && eval == "nnue" && verbose &&
+         ratio == 0.5);
+  assert(params.get_errors().empty());
+  const int bad_int = params.get_int("eval", 3);
+  assert(bad_int == 3 && params.get_errors().size() == 1);
+  const bool parsed_no_value = PlayerParams().parse("time", error);
+  const bool parsed_twice = PlayerParams().parse("a=1,a=2", error);
+  assert(!parsed_no_value && !parsed_twice);
+  std::cout << "params: ok\n";
+
+  auto &registry = PlayerRegistry::get();
+  for (const char *engine : {"random", "search", "mcts", "solver"})
+    assert(registry.has(engine));
+  const auto unknown = registry.create("nothing", "p", error);
+  const auto bad_value = registry.create("search:time=x", "p", error);
+  const auto bad_key = registry.create("search:tmie=10", "p", error);
+  assert(!unknown && !bad_value && !bad_key);
+  std::cout << "last error: " << error << '\n';
+  auto search = registry.create("search:time=15,depth=3,eval=windows", "s",
+                                error);
+  auto &opts = dynamic_cast<ttt::my_player::SearchPlayer &>(*search)
+                   .get_engine()
+                   .get_opts();
+  assert(opts.time_ms == 15 && opts.max_depth == 3 &&
+         opts.evaluator == ttt::my_player::Evaluator::WINDOWS);
+  registry.print_help(std::cout);
+
+  auto x = registry.create(spec_x, spec_x, error);
+  auto o = registry.create(spec_o, spec_o, error);
+  if (!x || !o) {
+    std::cerr << "error: " << error << '\n';
+    return 1;
+  }
+  auto result = ttt::test::run_game_tests(*x, *o, n_games);
+  ttt::test::print_test_results(result, spec_x, spec_o);
+  assert(result.errors == 0);
+  return 0;
+}
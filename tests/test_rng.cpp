@@ -0,0 +1,94 @@
+#include "player/my_player.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using ttt::game::MoveResult;
+using ttt::game::Point;
+using ttt::game::Sign;
+using ttt::game::State;
+using ttt::my_player::MyPlayer;
+using ttt::my_player::Rng;
+
+// Plays one game and returns a hash of its moves.
+static uint64_t play_game(MyPlayer &x, MyPlayer &o) {
+  const State::Opts opts = {15, 15, 5, 225};
+  State state(opts);
+  x.on_game_start(opts, Sign::X);
+  o.on_game_start(opts, Sign::O);
+  uint64_t hash = 0;
+  MoveResult result = MoveResult::OK;
+  while (result == MoveResult::OK) {
+    const Sign sign = state.get_current_player();
+    const Point p = (sign == Sign::X ? x : o).make_move(state);
+    hash = ttt::my_player::derive_seed(hash, p.x + p.y * opts.cols);
+    result = state.process_move(sign, p.x, p.y);
+  }
+  x.on_game_end(state, result);
+  o.on_game_end(state, result);
+  return hash;
+}
+
+static std::vector<uint64_t> play_games(int n_games) {
+  MyPlayer x("x"), o("o");
+  std::vector<uint64_t> games;
+  for (int i = 0; i < n_games; ++i)
+    games.push_back(play_game(x, o));
+  return games;
+}
+
+int main(int argc, char *argv[]) {
+  std::cout << "Testing Rng and game seeds\n";
+  const uint64_t seed = argc >= 2 ? atoi(argv[1]) : 7;
+
+  // streams are reproducible and independent
+  Rng a(seed), b(seed), c(ttt::my_player::derive_seed(seed, 1));
+  int n_same = 0;
+  for (int i = 0; i < 1000; ++i) {
+    const uint64_t value = a.next();
+    assert(value == b.next());
+    n_same += value == c.next();
+    assert(a.below(15) < 15);
+    const double d = a.next_double();
+    assert(d >= 0 && d < 1);
+    b.below(15);
+    b.next_double();
+  }
+  assert(n_same == 0);
+  std::cout << "streams: ok\n";
+
+  // the same master seed replays the same games
+  const int n_threads = 2, n_games = 8;
+  ttt::my_player::set_master_seed(seed);
+  const auto games = play_games(n_games);
+  assert(play_games(n_games) == games);
+  int n_distinct = 0;
+  for (int i = 1; i < n_games; ++i)
+    n_distinct += games[i] != games[i - 1];
+  assert(n_distinct > 0);
+
+  // also when they are spread over threads
+  std::vector<uint64_t> parallel(n_games);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < n_threads; ++t)
+    threads.emplace_back([&, t] {
+      MyPlayer x("x"), o("o");
+      for (int i = t; i < n_games; i += n_threads) {
+        x.set_next_game_no(i);
+        o.set_next_game_no(i);
+        parallel[i] = play_game(x, o);
+      }
+    });
+  for (auto &thread : threads)
+    thread.join();
+  assert(parallel == games);
+
+  // and another one plays other games
+  ttt::my_player::set_master_seed(seed + 1);
+  assert(play_games(n_games) != games);
+  std::cout << "game seeds: ok\n";
+  return 0;
+}
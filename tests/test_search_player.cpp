@@ -0,0 +1,114 @@
+#include "player/my_player.hpp"
+#include "player/search.hpp"
+#include "test_stats.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using ttt::my_player::SearchPlayer;
+using ttt::my_player::TranspositionTable;
+
+static void print_search_stats(SearchPlayer &p) {
+  auto &totals = p.get_totals();
+  std::cout << p.get_name() << " search:\n - average depth: "
+            << totals.get_average_depth()
+            << "\n - max depth: " << totals.max_depth
+            << "\n - nodes per second: " << long(totals.get_nps())
+            << "\n - TT hit rate: " << totals.get_tt_hit_rate() << "\n\n";
+}
+
+static void test_tt_snapshot() {
+  TranspositionTable tt;
+  tt.resize(1);
+  tt.new_generation();
+  tt.store(12345, 7, -300, ttt::my_player::Bound::LOWER, 42);
+  const bool saved = tt.save("test_search_player.tt");
+  assert(saved);
+
+  TranspositionTable loaded;
+  loaded.resize(1);
+  ttt::my_player::TTEntry entry;
+  const bool was_loaded = loaded.load("test_search_player.tt");
+  assert(was_loaded);
+  assert(loaded.get_generation() == tt.get_generation());
+  assert(loaded.probe(12345, entry));
+  assert(entry.depth == 7 && entry.score == -300 && entry.move == 42);
+  assert(!loaded.probe(54321, entry));
+
+  // snapshots only fit tables of the same size
+  TranspositionTable other;
+  other.resize(2);
+  const bool other_loaded = other.load("test_search_player.tt");
+  assert(!other_loaded);
+  std::remove("test_search_player.tt");
+  std::cout << "TT snapshot: ok\n";
+}
+
+// Contexts sharing a snapshot path save at the same time at the end of
+// their games; every save succeeds and the file stays whole.
+static void test_tt_concurrent_saves() {
+  TranspositionTable tt;
+  tt.resize(1);
+  tt.store(12345, 7, -300, ttt::my_player::Bound::LOWER, 42);
+  std::atomic<int> n_failed{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+    threads.emplace_back([&tt, &n_failed] {
+      for (int i = 0; i < 20; ++i)
+        if (!tt.save("test_search_player_shared.tt"))
+          ++n_failed;
+    });
+  for (auto &thread : threads)
+    thread.join();
+  assert(n_failed == 0);
+
+  TranspositionTable loaded;
+  loaded.resize(1);
+  const bool was_loaded = loaded.load("test_search_player_shared.tt");
+  assert(was_loaded);
+  std::remove("test_search_player_shared.tt");
+  std::cout << "concurrent TT snapshots: ok\n";
+}
+
+int main(int argc, char *argv[]) {
+  std::cout << "Testing SearchPlayer vs MyPlayer\n";
+  if (argc >= 2) {
+    ttt::my_player::set_master_seed(atoi(argv[1]));
+  }
+  const int n_games = argc >= 3 ? atoi(argv[2]) : 5;
+  test_tt_snapshot();
+  test_tt_concurrent_saves();
+
+  ttt::my_player::SearchOpts opts;
+  opts.time_ms = 20;
+  SearchPlayer search("SearchPlayer", opts);
+  ttt::my_player::MyPlayer random("MyPlayer");
+
+  auto as_x = ttt::test::run_game_tests(search, random, n_games);
+  ttt::test::print_test_results(as_x, "SearchPlayer", "MyPlayer");
+  auto as_o = ttt::test::run_game_tests(random, search, n_games);
+  ttt::test::print_test_results(as_o, "MyPlayer", "SearchPlayer");
+  print_search_stats(search);
+
+  assert(as_x.x_wins == n_games);
+  assert(as_o.o_wins == n_games);
+  // the table is kept from move to move and game to game
+  assert(search.get_totals().tt_hits > 0);
+
+  // stats of the searching side only, per game and per move number
+  assert(int(as_x.x_game_stats.size()) == n_games);
+  assert(as_x.o_game_stats.empty() ||
+         !ttt::test::has_move_stats(as_x.o_game_stats));
+  long long nodes = 0;
+  for (size_t i = 0; i < as_x.move_stats.size(); ++i) {
+    assert(i % 2 == 0 || as_x.move_stats[i].moves == 0);
+    nodes += as_x.move_stats[i].nodes;
+  }
+  assert(as_x.move_stats[0].moves == n_games && nodes > 0);
+  assert(as_o.move_stats[1].moves == n_games);
+  return 0;
+}
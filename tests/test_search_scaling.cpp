@@ -0,0 +1,78 @@
+#include "player/my_player.hpp"
+#include "player/search.hpp"
+#include "test_stats.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using ttt::game::Point;
+using ttt::game::Sign;
+using ttt::game::State;
+using ttt::my_player::SearchOpts;
+using ttt::my_player::SearchPlayer;
+
+// Middle game positions: the marks are played alternately, X first.
+static std::vector<State> make_positions() {
+  const std::vector<std::vector<Point>> openings = {
+      {{7, 7}, {8, 8}, {7, 8}, {7, 9}, {6, 8}, {8, 6}},
+      {{7, 7}, {6, 6}, {8, 6}, {6, 8}, {6, 7}, {8, 8}, {9, 5}, {10, 4}},
+      {{7, 7}, {7, 8}, {8, 7}, {6, 7}, {8, 9}, {9, 8}, {5, 8}, {8, 8},
+       {7, 9}, {6, 10}},
+  };
+  std::vector<State> positions;
+  for (auto &moves : openings) {
+    State state({15, 15, 5, 225});
+    for (size_t i = 0; i < moves.size(); ++i)
+      state.process_move(i % 2 == 0 ? Sign::X : Sign::O, moves[i].x,
+                         moves[i].y);
+    positions.push_back(state);
+  }
+  return positions;
+}
+
+int main(int argc, char *argv[]) {
+  std::cout << "Testing lazy SMP scaling of SearchPlayer\n";
+  const int time_ms = argc >= 2 ? atoi(argv[1]) : 100;
+  const int max_threads =
+      argc >= 3 ? atoi(argv[2])
+                : std::max(2u, std::thread::hardware_concurrency());
+
+  const auto positions = make_positions();
+  double base_nps = 0;
+  std::cout << "threads  nodes/s     speedup  depth\n";
+  for (int n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+    SearchOpts opts;
+    opts.time_ms = time_ms;
+    opts.n_threads = n_threads;
+    opts.use_threat_solver = false;
+    SearchPlayer search("SearchPlayer", opts);
+    for (auto &state : positions) {
+      search.on_game_start(state.get_opts(), state.get_current_player());
+      const Point move = search.make_move(state);
+      assert(state.get_value(move.x, move.y) == Sign::NONE);
+    }
+    auto &totals = search.get_totals();
+    if (n_threads == 1)
+      base_nps = totals.get_nps();
+    std::cout << std::setw(7) << n_threads << "  " << std::setw(10)
+              << long(totals.get_nps()) << "  " << std::setw(7)
+              << std::setprecision(3)
+              << (base_nps > 0 ? totals.get_nps() / base_nps : 0) << "  "
+              << totals.get_average_depth() << '\n';
+  }
+  std::cout << '\n';
+
+  // the parallel search still has to play sound games
+  SearchOpts opts;
+  opts.time_ms = 20;
+  opts.n_threads = 2;
+  SearchPlayer search("SearchPlayer", opts);
+  ttt::my_player::MyPlayer random("MyPlayer");
+  auto result = ttt::test::run_game_tests(search, random, 2);
+  ttt::test::print_test_results(result, "SearchPlayer", "MyPlayer");
+  assert(result.x_wins == 2);
+  return 0;
+}
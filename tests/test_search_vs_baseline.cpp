@@ -0,0 +1,42 @@
+#include "player/registry.hpp"
+#include "player/search.hpp"
+#include "test_stats.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+// test_search_vs_baseline [seed] [n_games] [player] [opponent], players as
+// registry specs
+int main(int argc, char *argv[]) {
+  std::cout << "Testing SearchPlayer vs baseline harder player\n";
+  if (argc >= 2) {
+    ttt::my_player::set_master_seed(atoi(argv[1]));
+    // the baseline players use the C library generator
+    std::srand(atoi(argv[1]));
+  }
+  const int n_games = argc >= 3 ? atoi(argv[2]) : 20;
+  const char *spec = argc >= 4 ? argv[3] : "search:time=50";
+  const char *opponent_spec = argc >= 5 ? argv[4] : "harder";
+
+  auto &registry = ttt::my_player::PlayerRegistry::get();
+  std::string error;
+  auto p1 = registry.create(spec, "SearchPlayer", error);
+  auto p2 = registry.create(opponent_spec, "BaselineHarder", error);
+  if (!p1 || !p2) {
+    std::cerr << "error: " << error << '\n';
+    return 1;
+  }
+
+  auto as_x = ttt::test::run_game_tests(*p1, *p2, n_games);
+  ttt::test::print_test_results(as_x, spec, opponent_spec);
+  auto as_o = ttt::test::run_game_tests(*p2, *p1, n_games);
+  ttt::test::print_test_results(as_o, opponent_spec, spec);
+
+  if (auto *search = dynamic_cast<ttt::my_player::SearchPlayer *>(p1.get())) {
+    auto &totals = search->get_totals();
+    std::cout << spec << " average depth: " << totals.get_average_depth()
+              << ", nodes per second: " << long(totals.get_nps())
+              << ", TT hit rate: " << totals.get_tt_hit_rate() << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,86 @@
+#include "player/selfplay.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+
+using ttt::game::MoveResult;
+using ttt::game::Sign;
+using ttt::game::State;
+using ttt::my_player::SelfPlayRecord;
+
+int main(int argc, char *argv[]) {
+  std::cout << "Testing self-play data generation\n";
+  const int n_games = argc >= 2 ? atoi(argv[1]) : 5;
+  const std::string prefix = "test_selfplay";
+
+  ttt::my_player::SelfPlayOpts opts;
+  opts.player_x = "search:time=5,threads=1";
+  opts.player_o = "random";
+  opts.games = n_games;
+  opts.n_threads = 2;
+  opts.shard_games = 3;
+  opts.log_interval = 0;
+  ttt::my_player::SelfPlayStats stats;
+  std::string error;
+  const bool ok = run_self_play(opts, prefix, stats, error, &std::cout);
+  if (!ok) {
+    std::cerr << "error: " << error << '\n';
+    return 1;
+  }
+  assert(stats.games == n_games && stats.errors == 0);
+  assert(stats.shards == (n_games + 2) / 3);
+
+  opts.player_o = "nothing";
+  error.clear();
+  ttt::my_player::SelfPlayStats bad_stats;
+  const bool bad_ok = run_self_play(opts, prefix + "_bad", bad_stats, error);
+  if (bad_ok || error.empty()) {
+    std::cerr << "error: a bad spec was accepted\n";
+    return 1;
+  }
+  std::cout << "bad spec: " << error << '\n';
+
+  // the shards replay as legal games with the recorded results
+  int n_read = 0;
+  long long n_positions = 0;
+  for (int shard = 0;; ++shard) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s-%05d.bin", prefix.c_str(), shard);
+    State::Opts board;
+    std::vector<SelfPlayRecord> games;
+    if (!ttt::my_player::read_dataset_shard(name, board, games))
+      break;
+    std::remove(name);
+    for (const SelfPlayRecord &game : games) {
+      State state(board);
+      MoveResult result = MoveResult::OK;
+      int n_scored = 0;
+      for (size_t i = 0; i < game.cells.size(); ++i) {
+        assert(result == MoveResult::OK);
+        const int cell = game.cells[i];
+        result = state.process_move(state.get_current_player(),
+                                    cell % board.cols, cell / board.cols);
+        const bool random = int(i) < game.random_plies;
+        const bool searched = !random && i % 2 == 0;
+        assert((game.scores[i] != ttt::my_player::dataset_format::NO_SCORE) ==
+               searched);
+        n_scored += searched;
+      }
+      assert(result == MoveResult::WIN || result == MoveResult::DRAW);
+      assert(state.get_winner() == game.winner);
+      assert(n_scored > 0);
+      n_positions += game.cells.size();
+      ++n_read;
+    }
+  }
+  if (n_read != n_games) {
+    std::cerr << "error: read back " << n_read << " of " << n_games
+              << " games\n";
+    return 1;
+  }
+  assert(n_positions == stats.positions);
+  std::cout << "read back " << n_read << " games, " << n_positions
+            << " positions\n";
+  return 0;
+}
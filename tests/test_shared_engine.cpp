@@ -0,0 +1,47 @@
+#include "player/my_player.hpp"
+#include "test_stats.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Runs many matches in parallel, all of them backed by one engine instance:
+// every thread owns only two lightweight per-game contexts.
+int main(int argc, char *argv[]) {
+  if (argc >= 2) {
+    ttt::my_player::set_master_seed(atoi(argv[1]));
+  }
+  const int n_threads = argc >= 3 ? atoi(argv[2]) : 8;
+  const int n_games = argc >= 4 ? atoi(argv[3]) : 50;
+
+  auto engine = std::make_shared<ttt::my_player::MyEngine>();
+  std::vector<ttt::test::TestResult> results(n_threads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < n_threads; ++i) {
+    threads.emplace_back([&, i] {
+      ttt::my_player::MyPlayer p1(engine, "p1"), p2(engine, "p2");
+      // every thread plays its own range of games
+      p1.set_next_game_no(i * n_games);
+      p2.set_next_game_no(i * n_games);
+      results[i] = ttt::test::run_game_tests(p1, p2, n_games);
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+
+  ttt::test::TestResult total;
+  for (auto &r : results) {
+    total.x_wins += r.x_wins;
+    total.o_wins += r.o_wins;
+    total.draws += r.draws;
+    total.errors += r.errors;
+  }
+  std::cout << "Testing " << n_threads << " parallel matches on one engine\n";
+  ttt::test::print_test_results(total, "MyPlayer", "MyPlayer");
+
+  assert(total.errors == 0);
+  assert(total.x_wins + total.o_wins + total.draws == n_threads * n_games);
+  return total.errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+#include "player/search.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using ttt::game::State;
+using ttt::my_player::Bound;
+using ttt::my_player::SearchContext;
+using ttt::my_player::SearchEngine;
+using ttt::my_player::SearchOpts;
+using ttt::my_player::TranspositionTable;
+using ttt::my_player::TTEntry;
+
+static std::string get_name(const char *suffix) {
+  return "/ttt_test_tt_" + std::to_string(getpid()) + "_" + suffix;
+}
+
+static void test_attach(const std::string &name) {
+  std::string error;
+  TranspositionTable a, b;
+  const bool attached_a = a.attach_shared(name, 1, false, error);
+  assert(attached_a);
+  // the existing segment keeps its size
+  const bool attached_b = b.attach_shared(name, 4, false, error);
+  assert(attached_b);
+  assert(a.is_shared() && b.is_shared());
+  assert(a.get_size() == b.get_size() && a.get_size() > 0);
+  assert(a.get_attached() == 2);
+
+  a.new_generation();
+  a.store(12345, 7, -300, Bound::LOWER, 42);
+  TTEntry entry;
+  const bool found = b.probe(12345, entry);
+  assert(found);
+  assert(entry.depth == 7 && entry.score == -300 && entry.move == 42);
+  // both tables advance one generation
+  b.new_generation();
+  a.new_generation();
+  assert(a.get_generation() == (b.get_generation() + 1) % 64);
+
+  b.detach();
+  const bool found_detached = b.probe(12345, entry);
+  assert(!b.is_shared() && b.get_size() == 0 && !found_detached);
+  assert(a.get_attached() == 1);
+  // a private table leaves the segment
+  a.resize(1);
+  const bool found_private = a.probe(12345, entry);
+  assert(!a.is_shared() && !found_private);
+
+  // entries stay until the segment is removed
+  TranspositionTable c;
+  const bool attached_c = c.attach_shared(name, 1, false, error);
+  assert(attached_c);
+  const bool kept = c.probe(12345, entry);
+  assert(c.get_attached() == 1 && kept);
+  const bool removed = TranspositionTable::remove_shared(name);
+  assert(removed);
+  const bool removed_again = TranspositionTable::remove_shared(name);
+  assert(!removed_again);
+  TranspositionTable d;
+  const bool attached_d = d.attach_shared(name, 1, true, error);
+  assert(attached_d);
+  const bool found_new = d.probe(12345, entry);
+  assert(!found_new);
+  const bool removed_new = TranspositionTable::remove_shared(name);
+  assert(removed_new);
+  std::cout << "attach and detach: ok\n";
+}
+
+static void test_processes(const std::string &name) {
+  std::string error;
+  TranspositionTable parent;
+  const bool attached = parent.attach_shared(name, 1, false, error);
+  assert(attached);
+  const pid_t pid = fork();
+  assert(pid >= 0);
+  if (pid == 0) {
+    TranspositionTable child;
+    std::string child_error;
+    if (!child.attach_shared(name, 1, false, child_error))
+      _exit(1);
+    child.store(777, 3, 50, Bound::EXACT, 9);
+    child.detach();
+    _exit(0);
+  }
+  int status = 0;
+  const pid_t waited = waitpid(pid, &status, 0);
+  assert(waited == pid);
+  assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  TTEntry entry;
+  const bool found = parent.probe(777, entry);
+  assert(found);
+  assert(entry.bound == Bound::EXACT && entry.move == 9);
+  assert(parent.get_attached() == 1);
+  TranspositionTable::remove_shared(name);
+  std::cout << "two processes: ok\n";
+}
+
+// A segment of a later layout version is left alone.
+static void test_version(const std::string &name) {
+  const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  assert(fd >= 0);
+  unsigned char header[64] = {};
+  std::memcpy(header, "TTTTSHM", 8);
+  const uint32_t version = 99, ready = 1;
+  std::memcpy(header + 8, &version, 4);
+  std::memcpy(header + 12, &ready, 4);
+  const ssize_t written = write(fd, header, sizeof(header));
+  assert(written == ssize_t(sizeof(header)));
+  close(fd);
+
+  TranspositionTable tt;
+  tt.resize(1);
+  std::string error;
+  const bool attached = tt.attach_shared(name, 1, false, error);
+  assert(!attached);
+  assert(error.find("layout version 99") != std::string::npos);
+  assert(!tt.is_shared() && tt.get_size() == 0);
+  TranspositionTable::remove_shared(name);
+  std::cout << "layout version: ok\n";
+}
+
+// A search of one context finds the results of another one.
+static void test_search(const std::string &name) {
+  SearchOpts opts;
+  opts.time_ms = 100000;
+  opts.max_depth = 5;
+  opts.tt_size_mb = 4;
+  opts.tt_shm_name = name;
+  opts.use_threat_solver = false;
+  SearchEngine engine(opts);
+  State state({15, 15, 5, 0});
+  state.process_move(state.get_current_player(), 7, 7);
+  state.process_move(state.get_current_player(), 8, 8);
+  state.process_move(state.get_current_player(), 7, 8);
+
+  SearchContext first;
+  engine.make_move(first, state);
+  assert(first.tt.is_shared());
+  SearchContext second;
+  engine.make_move(second, state);
+  assert(second.tt.is_shared());
+  assert(second.last_info.nodes < first.last_info.nodes);
+  TranspositionTable::remove_shared(name);
+  std::cout << "shared search: ok\n";
+}
+
+int main() {
+  test_attach(get_name("attach"));
+  test_processes(get_name("fork"));
+  test_version(get_name("version"));
+  test_search(get_name("search"));
+  return 0;
+}
@@ -0,0 +1,74 @@
+#include "player/rng.hpp"
+#include "player/spsa.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+
+using ttt::my_player::MatchOpts;
+using ttt::my_player::MatchResult;
+using ttt::my_player::SpsaOpts;
+using ttt::my_player::SpsaParam;
+using ttt::my_player::SpsaTuner;
+
+int main(int argc, char *argv[]) {
+  std::cout << "Testing parallel matches and the SPSA tuner\n";
+  const int n_games = argc >= 2 ? atoi(argv[1]) : 4;
+  ttt::my_player::set_master_seed(1);
+
+  MatchOpts match;
+  match.board = {7, 7, 4, 0};
+  match.games = n_games;
+  match.n_threads = 2;
+  MatchResult result;
+  std::string error;
+  const bool played =
+      run_match("search:time=5,threads=1", "random", match, result, error);
+  assert(played);
+  std::cout << "search vs random: +" << result.wins << " -" << result.losses
+            << " =" << result.draws << '\n';
+  assert(result.get_games() == n_games && result.errors == 0);
+  assert(result.get_score() > 0.5);
+  MatchResult bad_result;
+  const bool bad_played =
+      run_match("random", "nothing", match, bad_result, error);
+  assert(!bad_played);
+  std::cout << "bad spec: " << error << '\n';
+  std::cout << "run_match: ok\n";
+
+  SpsaOpts opts;
+  opts.engine = "mcts:time=2,threads=1";
+  opts.params = {{"exploration", 1.0, 0.2, 3.0, 0.3, 0.5},
+                 {"expand", 2, 1, 8, 1, 2, true}};
+  opts.iterations = 3;
+  opts.match = match;
+  opts.big_a = 1;
+  opts.checkpoint_path = "test_spsa.txt";
+  SpsaTuner tuner(opts);
+  assert(tuner.get_spec() == "mcts:time=2,threads=1,exploration=1,expand=2");
+  const bool tuned = tuner.run(error, &std::cout);
+  assert(tuned);
+  assert(tuner.get_iteration() == opts.iterations);
+  for (const SpsaParam &param : tuner.get_params())
+    assert(param.min <= param.value && param.value <= param.max);
+
+  // a resumed run starts where the checkpoint stopped
+  SpsaTuner resumed(opts);
+  const bool loaded = resumed.load_checkpoint(opts.checkpoint_path);
+  assert(loaded);
+  assert(resumed.get_iteration() == opts.iterations);
+  for (size_t i = 0; i < opts.params.size(); ++i)
+    assert(resumed.get_params()[i].value == tuner.get_params()[i].value);
+  const bool resumed_ok = resumed.run(error);
+  assert(resumed_ok && resumed.get_iteration() == opts.iterations);
+  std::remove(opts.checkpoint_path.c_str());
+  const bool reloaded = resumed.load_checkpoint(opts.checkpoint_path);
+  assert(!reloaded);
+
+  opts.engine = "nothing";
+  const bool stepped = SpsaTuner(opts).step(error);
+  assert(!stepped);
+  std::cout << "bad engine: " << error << '\n';
+  std::cout << "spsa: ok\n";
+  return 0;
+}
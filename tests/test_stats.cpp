@@ -6,7 +6,7 @@
 int main(int argc, char *argv[]) {
     std::cout << "Testing MyPlayer vs MyPlayer\n";
     if (argc >= 2) {
-        std::srand(atoi(argv[1]));
+        ttt::my_player::set_master_seed(atoi(argv[1]));
     }
 
     
@@ -16,6 +16,10 @@ int main(int argc, char *argv[]) {
     
     
     ttt::test::print_test_results(result, "MyPlayer", "MyPlayer");
+
+    std::cout << "\nSame match without virtual dispatch (StaticGame)\n";
+    auto static_result = ttt::test::run_static_game_tests(p1, p2, 100);
+    ttt::test::print_test_results(static_result, "MyPlayer", "MyPlayer");
     
     return 0;
 }
\ No newline at end of file
@@ -1,10 +1,14 @@
 #pragma once
 
 #include "core/game.hpp"
+#include "core/static_game.hpp"
+#include "player/engine.hpp"
+#include <algorithm>
 #include <iostream>
 #include <cassert>
 #include <ctime>
 #include <string>
+#include <vector>
 
 namespace ttt::test {
 
@@ -40,18 +44,110 @@ private:
   clock_t start;
 };
 
-// Player wrapper that measures execution time
+// Sums of the search stats of a player's moves (see
+// `my_player::IStatsPlayer`) and their averages.
+struct MoveStatsSum {
+  int moves = 0;
+  long long nodes = 0;
+  long long solver_nodes = 0;
+  long long depth_sum = 0;
+  int max_depth = 0;
+  long long tt_probes = 0;
+  long long tt_hits = 0;
+  double tt_fill_sum = 0;
+  // over the moves which searched to some depth
+  double branching_sum = 0;
+  int branching_moves = 0;
+  double lookup_ms = 0;
+  double solver_ms = 0;
+  double search_ms = 0;
+
+  void add(const my_player::MoveStats &stats) {
+    ++moves;
+    nodes += stats.nodes;
+    solver_nodes += stats.solver_nodes;
+    depth_sum += stats.depth;
+    max_depth = std::max(max_depth, stats.depth);
+    tt_probes += stats.tt_probes;
+    tt_hits += stats.tt_hits;
+    tt_fill_sum += stats.tt_fill;
+    if (stats.get_branching_factor() > 0) {
+      branching_sum += stats.get_branching_factor();
+      ++branching_moves;
+    }
+    lookup_ms += stats.lookup_ms;
+    solver_ms += stats.solver_ms;
+    search_ms += stats.search_ms;
+  }
+
+  void add(const MoveStatsSum &other) {
+    moves += other.moves;
+    nodes += other.nodes;
+    solver_nodes += other.solver_nodes;
+    depth_sum += other.depth_sum;
+    max_depth = std::max(max_depth, other.max_depth);
+    tt_probes += other.tt_probes;
+    tt_hits += other.tt_hits;
+    tt_fill_sum += other.tt_fill_sum;
+    branching_sum += other.branching_sum;
+    branching_moves += other.branching_moves;
+    lookup_ms += other.lookup_ms;
+    solver_ms += other.solver_ms;
+    search_ms += other.search_ms;
+  }
+
+  double average(double sum) const { return moves > 0 ? sum / moves : 0; }
+  double get_tt_hit_rate() const {
+    return tt_probes > 0 ? double(tt_hits) / tt_probes : 0;
+  }
+  double get_branching_factor() const {
+    return branching_moves > 0 ? branching_sum / branching_moves : 0;
+  }
+};
+
+// Player wrapper that measures execution time, and collects the search
+// stats of players which report them per game and per move number
 class TimeMeasuringPlayer : public game::IPlayer {
 public:
-  TimeMeasuringPlayer(game::IPlayer &p) : m_base(p) {}
+  TimeMeasuringPlayer(game::IPlayer &p)
+      : m_base(p),
+        m_stats_player(dynamic_cast<my_player::IStatsPlayer *>(&p)) {}
 
   void set_sign(game::Sign sign) override { 
     m_base.set_sign(sign); 
   }
 
+  // Game start and end hooks are timed apart from moves: warm-up done there
+  // does not count against the move time limit.
+  void on_game_start(const game::State::Opts &opts, game::Sign sign) override {
+    if (m_stats_player)
+      m_game_stats.emplace_back();
+    BlockMeasurer ms{m_start_time};
+    m_base.on_game_start(opts, sign);
+  }
+
+  void on_game_end(const game::State &state, game::MoveResult result) override {
+    BlockMeasurer ms{m_end_time};
+    m_base.on_game_end(state, result);
+  }
+
   game::Point make_move(const game::State &state) override {
-    BlockMeasurer ms{m_move_time};
-    return m_base.make_move(state);
+    game::Point move;
+    {
+      BlockMeasurer ms{m_move_time};
+      move = m_base.make_move(state);
+    }
+    my_player::MoveStats stats;
+    if (m_stats_player && m_stats_player->get_move_stats(stats)) {
+      const int move_no = state.get_move_no();
+      if (int(m_move_stats.size()) <= move_no)
+        m_move_stats.resize(move_no + 1);
+      m_move_stats[move_no].add(stats);
+      if (m_game_stats.empty())
+        m_game_stats.emplace_back();
+      m_game_stats.back().add(stats);
+    }
+    return move;
   }
 
   void handle_event(const game::State &state, const game::Event &event) override {
@@ -71,10 +167,31 @@ public:
     return m_event_time.get(); 
   }
 
+  double get_average_start_time() const {
+    return m_start_time.get();
+  }
+
+  double get_average_end_time() const {
+    return m_end_time.get();
+  }
+
+  // empty unless the player reports stats
+  const std::vector<MoveStatsSum> &get_game_stats() const {
+    return m_game_stats;
+  }
+  const std::vector<MoveStatsSum> &get_move_stats() const {
+    return m_move_stats;
+  }
+
 private:
   game::IPlayer &m_base;
+  my_player::IStatsPlayer *m_stats_player;
+  std::vector<MoveStatsSum> m_game_stats;
+  std::vector<MoveStatsSum> m_move_stats;
   AverageCounter m_move_time;
   AverageCounter m_event_time;
+  AverageCounter m_start_time;
+  AverageCounter m_end_time;
 };
 
 // Main test function that runs games and collects statistics
@@ -85,11 +202,39 @@ struct TestResult {
     int errors = 0;
     double x_move_time = 0;
     double x_event_time = 0;
+    double x_start_time = 0;
+    double x_end_time = 0;
     double o_move_time = 0;
     double o_event_time = 0;
+    double o_start_time = 0;
+    double o_end_time = 0;
     double game_time = 0;
+    // search stats of players which report them, per game and per move
+    // number; X makes the even moves and O the odd ones
+    std::vector<MoveStatsSum> x_game_stats;
+    std::vector<MoveStatsSum> o_game_stats;
+    std::vector<MoveStatsSum> move_stats;
 };
 
+static void count_game_result(TestResult &result, game::MoveResult res,
+                              const game::State &state) {
+    switch (res) {
+    case game::MoveResult::DRAW:
+        ++result.draws;
+        break;
+    case game::MoveResult::ERROR:
+        ++result.errors;
+        break;
+    default:
+        if (state.get_winner() == game::Sign::X)
+            ++result.x_wins;
+        else if (state.get_winner() == game::Sign::O)
+            ++result.o_wins;
+        else
+            ++result.errors;
+    }
+}
+
 static TestResult run_game_tests(
     game::IPlayer& p1, 
     game::IPlayer& p2, 
@@ -125,34 +270,137 @@ static TestResult run_game_tests(
         
         assert(!game::is_dq(res));
         
-        switch (res) {
-        case game::MoveResult::DRAW:
-            ++result.draws;
-            break;
-        case game::MoveResult::ERROR:
-            ++result.errors;
-            break;
-        default:
-            if (game.get_state().get_winner() == game::Sign::X)
-                ++result.x_wins;
-            else if (game.get_state().get_winner() == game::Sign::O)
-                ++result.o_wins;
-            else
-                ++result.errors;
-        }
+        count_game_result(result, res, game.get_state());
         game.reset();
     }
     
     //timing results
     result.x_move_time = tm_p1.get_average_move_time();
     result.x_event_time = tm_p1.get_average_event_time();
+    result.x_start_time = tm_p1.get_average_start_time();
+    result.x_end_time = tm_p1.get_average_end_time();
     result.o_move_time = tm_p2.get_average_move_time();
     result.o_event_time = tm_p2.get_average_event_time();
+    result.o_start_time = tm_p2.get_average_start_time();
+    result.o_end_time = tm_p2.get_average_end_time();
     result.game_time = game_time_counter.get();
+
+    //search stats
+    result.x_game_stats = tm_p1.get_game_stats();
+    result.o_game_stats = tm_p2.get_game_stats();
+    const auto &x_moves = tm_p1.get_move_stats();
+    const auto &o_moves = tm_p2.get_move_stats();
+    result.move_stats.resize(std::max(x_moves.size(), o_moves.size()));
+    for (size_t i = 0; i < x_moves.size(); i += 2)
+        result.move_stats[i] = x_moves[i];
+    for (size_t i = 1; i < o_moves.size(); i += 2)
+        result.move_stats[i] = o_moves[i];
     
     return result;
 }
 
+// Same match as run_game_tests, played by StaticGame with the concrete player
+// types, so no call in the game loop is virtual. Players are not wrapped by
+// TimeMeasuringPlayer here, only the whole game step is timed.
+template <class PlayerX, class PlayerO>
+static TestResult run_static_game_tests(
+    PlayerX& p1,
+    PlayerO& p2,
+    int num_iterations = 100,
+    int board_size = 15,
+    int win_length = 5) {
+
+    game::State::Opts opts;
+    opts.rows = opts.cols = board_size;
+    opts.win_len = win_length;
+    opts.max_moves = 0;
+
+    game::StaticGame game(opts, p1, p2);
+
+    TestResult result;
+    AverageCounter game_time_counter;
+
+    for (int i = 0; i < num_iterations; ++i) {
+        game::MoveResult res;
+        do {
+            BlockMeasurer ms{game_time_counter};
+            res = game.process();
+        } while (res == game::MoveResult::OK);
+
+        assert(!game::is_dq(res));
+
+        count_game_result(result, res, game.get_state());
+        game.reset();
+    }
+
+    result.game_time = game_time_counter.get();
+    return result;
+}
+
+static void print_move_stats(const MoveStatsSum &stats) {
+    std::cout << "moves " << stats.moves << ", nodes "
+              << long(stats.average(stats.nodes)) << " (solver "
+              << long(stats.average(stats.solver_nodes)) << "), depth "
+              << stats.average(stats.depth_sum) << " (max "
+              << stats.max_depth << "), branching "
+              << stats.get_branching_factor() << ", tt hits "
+              << int(100 * stats.get_tt_hit_rate()) << "%, fill "
+              << 100 * stats.average(stats.tt_fill_sum)
+              << "%, lookup/solver/search (ms) "
+              << stats.average(stats.lookup_ms) << "/"
+              << stats.average(stats.solver_ms) << "/"
+              << stats.average(stats.search_ms) << "\n";
+}
+
+// Rows past this many are summed into one.
+static const int MAX_STATS_ROWS = 20;
+
+static void print_stats_rows(const std::vector<MoveStatsSum> &rows,
+                             const std::string &label) {
+    MoveStatsSum rest;
+    int printed = 0, rest_rows = 0;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (rows[i].moves == 0)
+            continue;
+        if (printed < MAX_STATS_ROWS) {
+            std::cout << " - " << label << " " << i << ": ";
+            print_move_stats(rows[i]);
+            ++printed;
+            continue;
+        }
+        ++rest_rows;
+        rest.add(rows[i]);
+    }
+    if (rest_rows > 0) {
+        std::cout << " - " << rest_rows << " more " << label << "s: ";
+        print_move_stats(rest);
+    }
+}
+
+static bool has_move_stats(const std::vector<MoveStatsSum> &rows) {
+    for (const auto &row : rows)
+        if (row.moves > 0)
+            return true;
+    return false;
+}
+
+static void print_search_stats(const TestResult& result,
+                               const std::string& player_x_name,
+                               const std::string& player_o_name) {
+    if (has_move_stats(result.x_game_stats)) {
+        std::cout << player_x_name << " search per game:\n";
+        print_stats_rows(result.x_game_stats, "game");
+    }
+    if (has_move_stats(result.o_game_stats)) {
+        std::cout << player_o_name << " search per game:\n";
+        print_stats_rows(result.o_game_stats, "game");
+    }
+    if (has_move_stats(result.move_stats)) {
+        std::cout << "search per move number:\n";
+        print_stats_rows(result.move_stats, "move");
+    }
+}
+
 //helper to print test results
 static void print_test_results(const TestResult& result, 
                               const std::string& player_x_name = "X",
@@ -166,15 +414,21 @@ static void print_test_results(const TestResult& result,
     std::cout << player_x_name << " play time:\n - move time (ms): " 
               << result.x_move_time
               << "\n - event time (ms): " << result.x_event_time
+              << "\n - game start time (ms): " << result.x_start_time
+              << "\n - game end time (ms): " << result.x_end_time
               << "\n\n";
 
     std::cout << player_o_name << " play time:\n - move time (ms): "
               << result.o_move_time
               << "\n - event time (ms): " << result.o_event_time
+              << "\n - game start time (ms): " << result.o_start_time
+              << "\n - game end time (ms): " << result.o_end_time
               << "\n\n";
 
     std::cout << "game process average time: " << result.game_time
               << " (ms)\n";
+
+    print_search_stats(result, player_x_name, player_o_name);
               
     assert(result.x_event_time < 100);
     assert(result.x_move_time < 100);
@@ -7,6 +7,8 @@
 int main(int argc, char *argv[]) {
     std::cout << "Testing MyPlayer vs baseline easy player\n";
     if (argc >= 2) {
+        ttt::my_player::set_master_seed(atoi(argv[1]));
+        // the baseline players use the C library generator
         std::srand(atoi(argv[1]));
     }
 
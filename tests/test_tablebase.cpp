@@ -0,0 +1,181 @@
+#include "player/search.hpp"
+#include "player/tablebase.hpp"
+#include "minimax.hpp"
+#include "test_stats.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <unordered_set>
+
+using ttt::game::MoveResult;
+using ttt::game::Sign;
+using ttt::game::State;
+using ttt::my_player::Board;
+using ttt::my_player::Point;
+using ttt::my_player::Tablebase;
+using ttt::my_player::TbEntry;
+using ttt::my_player::TbGenerateStats;
+using ttt::my_player::TbResult;
+using ttt::test::Minimax;
+
+static int to_value(TbResult result) {
+  return result == TbResult::WIN ? 1 : result == TbResult::LOSS ? -1 : 0;
+}
+
+static std::string read_file(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in), {});
+}
+
+// Every position reachable in play against the minimax, and the best move
+// of the table leading to the end in the promised number of plies.
+static void check_positions(const Tablebase &tablebase, const State &state,
+                            Minimax &minimax,
+                            std::unordered_set<uint64_t> &seen) {
+  if (!seen.insert(ttt::test::position_code(state)).second)
+    return;
+  const TbEntry entry = tablebase.probe(state);
+  assert(entry.result != TbResult::UNKNOWN);
+  assert(to_value(entry.result) == minimax.value(state));
+  assert((entry.result == TbResult::DRAW) == (entry.distance == 0));
+
+  Point move;
+  TbEntry best_entry;
+  const bool found = tablebase.get_best_move(Board(state), move, best_entry);
+  assert(found);
+  assert(best_entry.result == entry.result &&
+         best_entry.distance == entry.distance);
+  assert(minimax.move_value(state, move.x, move.y) == to_value(entry.result));
+  State next = state;
+  const MoveResult result =
+      next.process_move(state.get_current_player(), move.x, move.y);
+  if (result == MoveResult::OK) {
+    const TbEntry reply = tablebase.probe(next);
+    assert(to_value(reply.result) == -to_value(entry.result));
+    if (entry.result != TbResult::DRAW)
+      assert(reply.distance == entry.distance - 1);
+  } else {
+    // the game ends right away only one ply from the end
+    assert(entry.distance <= 1);
+  }
+
+  const auto &opts = state.get_opts();
+  for (int y = 0; y < opts.rows; ++y) {
+    for (int x = 0; x < opts.cols; ++x) {
+      if (state.get_value(x, y) != Sign::NONE)
+        continue;
+      State child = state;
+      if (child.process_move(state.get_current_player(), x, y) ==
+          MoveResult::OK)
+        check_positions(tablebase, child, minimax, seen);
+    }
+  }
+}
+
+static void test_table(const State::Opts &opts, int n_threads) {
+  const std::string path = "test_tablebase.bin";
+  TbGenerateStats stats;
+  std::string error;
+  const bool generated =
+      Tablebase::generate(opts, n_threads, path, stats, error);
+  assert(generated);
+  assert(stats.solved < stats.positions);
+  assert(stats.wins + stats.losses + stats.draws == stats.positions);
+
+  Tablebase tablebase;
+  const bool opened = tablebase.open(path);
+  assert(opened && tablebase.covers(opts));
+  Minimax minimax;
+  std::unordered_set<uint64_t> seen;
+  const State start(opts);
+  check_positions(tablebase, start, minimax, seen);
+  assert(to_value(stats.start.result) == minimax.value(start));
+
+  // threads share the layers but the table comes out the same
+  const std::string single_path = "test_tablebase_single.bin";
+  TbGenerateStats single_stats;
+  const bool single_generated =
+      Tablebase::generate(opts, 1, single_path, single_stats, error);
+  assert(single_generated);
+  assert(single_stats.solved == stats.solved);
+  assert(read_file(path) == read_file(single_path));
+  std::remove(single_path.c_str());
+
+  std::cout << opts.rows << "x" << opts.cols << ", " << opts.win_len
+            << " in a row, " << opts.max_moves << " moves: "
+            << to_string(stats.start.result) << " in "
+            << stats.start.distance << ", " << stats.positions
+            << " positions, " << stats.solved << " solved, " << seen.size()
+            << " checked: ok" << std::endl;
+}
+
+int main() {
+  std::cout << "Testing the tablebase\n";
+  test_table({3, 3, 3, 0}, 3);
+  test_table({3, 4, 3, 0}, 2);
+  test_table({4, 3, 3, 0}, 4);
+  // fewer moves than cells: games end with empty cells left
+  test_table({3, 4, 3, 7}, 2);
+  test_table({3, 4, 3, 8}, 2);
+  test_table({3, 3, 2, 0}, 2);
+
+  assert(!Tablebase::supports({19, 19, 5, 0}));
+  assert(!Tablebase::supports({5, 6, 4, 0}));
+  TbGenerateStats stats;
+  std::string error;
+  const bool too_large =
+      Tablebase::generate({15, 15, 5, 0}, 1, "unused.bin", stats, error);
+  assert(!too_large && !error.empty());
+
+  // other options and broken files
+  const std::string path = "test_tablebase.bin";
+  const bool generated = Tablebase::generate({3, 3, 3, 0}, 2, path, stats,
+                                             error);
+  assert(generated);
+  Tablebase tablebase;
+  const bool opened = tablebase.open(path);
+  assert(opened);
+  assert(!tablebase.covers({3, 4, 3, 0}));
+  assert(tablebase.probe(State({3, 4, 3, 0})).result == TbResult::UNKNOWN);
+  assert(tablebase.probe(State({3, 3, 3, 0})).result == TbResult::DRAW);
+  {
+    const std::string data = read_file(path);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), data.size() - 8);
+  }
+  Tablebase truncated;
+  const bool opened_truncated = truncated.open(path);
+  assert(!opened_truncated);
+  const bool opened_missing = truncated.open("missing_tablebase.bin");
+  assert(!opened_missing);
+  std::cout << "wrong options and broken files: ok\n";
+
+  // the player takes exact moves from the table and never loses a draw
+  const bool regenerated = Tablebase::generate({3, 3, 3, 0}, 2, path, stats,
+                                               error);
+  assert(regenerated);
+  ttt::my_player::SearchOpts opts;
+  opts.time_ms = 20;
+  opts.tablebase_path = path;
+  ttt::my_player::SearchPlayer exact("TablebasePlayer", opts);
+  ttt::my_player::SearchOpts plain_opts;
+  plain_opts.time_ms = 20;
+  ttt::my_player::SearchPlayer plain("SearchPlayer", plain_opts);
+  auto as_x = ttt::test::run_game_tests(exact, plain, 4, 3, 3);
+  ttt::test::print_test_results(as_x, "TablebasePlayer", "SearchPlayer");
+  auto as_o = ttt::test::run_game_tests(plain, exact, 4, 3, 3);
+  ttt::test::print_test_results(as_o, "SearchPlayer", "TablebasePlayer");
+  assert(as_x.o_wins == 0 && as_o.x_wins == 0);
+
+  ttt::my_player::SearchEngine engine(opts);
+  ttt::my_player::SearchContext ctx;
+  State state({3, 3, 3, 0});
+  state.process_move(Sign::X, 0, 0);
+  engine.make_move(ctx, state);
+  assert(ctx.last_info.tablebase && ctx.last_info.score == 0);
+  std::remove(path.c_str());
+  return 0;
+}
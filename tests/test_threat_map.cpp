@@ -0,0 +1,102 @@
+#include "player/rng.hpp"
+#include "player/threat_map.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using ttt::game::MoveResult;
+using ttt::game::Sign;
+using ttt::game::State;
+using ttt::my_player::Bitboard;
+using ttt::my_player::SimdLevel;
+using ttt::my_player::ThreatMap;
+
+using Clock = std::chrono::steady_clock;
+
+// Random positions of `n_marks` marks in clusters, so that there are
+// threats of every kind.
+static State random_position(const State::Opts &opts, int n_marks,
+                             ttt::my_player::Rng &rng) {
+  State state(opts);
+  const int n_cells = opts.rows * opts.cols;
+  int x = opts.cols / 2, y = opts.rows / 2;
+  for (int i = 0; i < n_marks && i < n_cells - 1; ++i) {
+    do {
+      if (rng.below(4) == 0) {
+        x = int(rng.below(opts.cols));
+        y = int(rng.below(opts.rows));
+      } else {
+        x = std::clamp(x + int(rng.below(3)) - 1, 0, opts.cols - 1);
+        y = std::clamp(y + int(rng.below(3)) - 1, 0, opts.rows - 1);
+      }
+    } while (state.get_value(x, y) != Sign::NONE);
+    if (state.process_move(state.get_current_player(), x, y) !=
+        MoveResult::OK)
+      break;
+  }
+  return state;
+}
+
+static void test_board(const State::Opts &opts, int n_positions,
+                       ttt::my_player::Rng &rng) {
+  assert(ThreatMap::supports(opts));
+  const SimdLevel best = ttt::my_player::detect_simd_level();
+  long long n_masks = 0;
+  for (int n = 0; n < n_positions; ++n) {
+    const int n_marks = int(rng.below(opts.rows * opts.cols / 2 + 1));
+    const State state = random_position(opts, n_marks, rng);
+    const Bitboard board(state);
+    for (SimdLevel level : {SimdLevel::SCALAR, best}) {
+      ThreatMap map;
+      map.compute(board, level);
+      for (int y = 0; y < opts.rows; ++y)
+        for (int x = 0; x < opts.cols; ++x)
+          for (Sign sign : {Sign::X, Sign::O}) {
+            const uint16_t mask = map.get_mask(board.index(x, y), sign);
+            assert(mask ==
+                   ttt::my_player::reference_threat_mask(state, x, y, sign));
+            n_masks += mask != 0;
+          }
+    }
+  }
+  std::cout << opts.rows << "x" << opts.cols << ", " << opts.win_len
+            << " in a row: " << n_masks << " threat masks: ok\n";
+}
+
+static double bench(const Bitboard &board, SimdLevel level, int n_runs) {
+  ThreatMap map;
+  const auto start = Clock::now();
+  for (int i = 0; i < n_runs; ++i)
+    map.compute(board, level);
+  return std::chrono::duration<double, std::micro>(Clock::now() - start)
+             .count() /
+         n_runs;
+}
+
+int main(int argc, char *argv[]) {
+  std::cout << "Testing the threat map kernels\n";
+  const int n_positions = argc >= 2 ? atoi(argv[1]) : 20;
+  const SimdLevel best = ttt::my_player::detect_simd_level();
+  std::cout << "kernel: " << to_string(best) << '\n';
+  ttt::my_player::Rng rng(1);
+
+  assert(!ThreatMap::supports({15, 62, 5, 0}));
+  assert(!ThreatMap::supports({15, 15, 1, 0}));
+  test_board({15, 15, 5, 0}, n_positions, rng);
+  test_board({3, 3, 3, 0}, n_positions, rng);
+  test_board({7, 9, 4, 0}, n_positions, rng);
+  test_board({19, 19, 5, 0}, n_positions, rng);
+  test_board({5, 60, 5, 0}, n_positions, rng);
+  test_board({20, 10, 6, 0}, n_positions, rng);
+
+  const State state = random_position({15, 15, 5, 0}, 60, rng);
+  const Bitboard board(state);
+  const int n_runs = 2000;
+  std::cout << "15x15 board: scalar " << bench(board, SimdLevel::SCALAR, n_runs)
+            << " us, " << to_string(best) << " " << bench(board, best, n_runs)
+            << " us per map\n";
+  return 0;
+}
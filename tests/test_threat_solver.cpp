@@ -0,0 +1,105 @@
+#include "player/search.hpp"
+#include "player/threat_solver.hpp"
+
+#include <cassert>
+#include <initializer_list>
+#include <iostream>
+
+using ttt::game::Point;
+using ttt::game::Sign;
+using ttt::game::State;
+using ttt::my_player::ThreatResult;
+using ttt::my_player::ThreatSolution;
+using ttt::my_player::ThreatSolver;
+
+// Plays the marks alternately, X first; the longer list goes on unanswered.
+static State make_state(std::initializer_list<Point> xs,
+                        std::initializer_list<Point> os) {
+  State state({15, 15, 5, 225});
+  auto x = xs.begin(), o = os.begin();
+  while (x != xs.end() || o != os.end()) {
+    if (x != xs.end()) {
+      state.process_move(Sign::X, x->x, x->y);
+      ++x;
+    }
+    if (o != os.end()) {
+      state.process_move(Sign::O, o->x, o->y);
+      ++o;
+    }
+  }
+  return state;
+}
+
+static const char *to_string(ThreatResult result) {
+  switch (result) {
+  case ThreatResult::WIN:
+    return "win";
+  case ThreatResult::NO_WIN:
+    return "no win";
+  default:
+    return "unknown";
+  }
+}
+
+static void print_solution(const char *name, const ThreatSolution &solution) {
+  std::cout << name << ": " << to_string(solution.result) << " ("
+            << solution.move.x << ", " << solution.move.y << "), "
+            << solution.nodes << " nodes\n";
+}
+
+int main() {
+  std::cout << "Testing ThreatSolver\n";
+  // bounded by nodes only, so that results do not depend on machine load
+  ttt::my_player::ThreatSolverOpts solver_opts;
+  solver_opts.time_ms = 10000;
+  solver_opts.max_nodes = 50000;
+  ThreatSolver solver(solver_opts);
+
+  // an open three becomes an open four
+  State open_three = make_state({{5, 7}, {6, 7}, {7, 7}},
+                                {{0, 0}, {14, 0}, {0, 14}});
+  auto solution = solver.solve_vcf(open_three, Sign::X);
+  print_solution("open three, VCF", solution);
+  assert(solution.result == ThreatResult::WIN);
+  assert(solution.move.y == 7 && solution.move.x >= 3 && solution.move.x <= 9);
+
+  // nothing to build on
+  State scattered = make_state({{2, 3}, {12, 2}, {7, 12}},
+                               {{0, 0}, {14, 0}, {0, 14}});
+  solution = solver.solve_vcf(scattered, Sign::X);
+  print_solution("scattered, VCF", solution);
+  assert(solution.result == ThreatResult::NO_WIN);
+  solution = solver.solve_vct(scattered, Sign::X);
+  print_solution("scattered, VCT", solution);
+  assert(solution.result == ThreatResult::NO_WIN);
+
+  // two pairs make a double three, but no four yet
+  State pairs = make_state({{6, 7}, {7, 7}, {8, 5}, {8, 6}},
+                           {{0, 0}, {14, 0}, {0, 14}, {14, 14}});
+  solution = solver.solve_vcf(pairs, Sign::X);
+  print_solution("two pairs, VCF", solution);
+  assert(solution.result == ThreatResult::NO_WIN);
+  solution = solver.solve_vct(pairs, Sign::X);
+  print_solution("two pairs, VCT", solution);
+  assert(solution.result == ThreatResult::WIN);
+
+  // a double four of X is no win while O can make a four of its own: after
+  // the line of X, the line of O draws
+  State counter = make_state({{3, 7}, {4, 7}, {5, 7}, {6, 4}, {6, 5}, {6, 6}},
+                             {{2, 7}, {6, 3}, {10, 10}, {11, 10}, {12, 10},
+                              {0, 0}});
+  solution = solver.solve_vcf(counter, Sign::X);
+  print_solution("counter four, VCF", solution);
+  assert(solution.result == ThreatResult::NO_WIN);
+
+  // O has to stop the open three right at one of its ends
+  State defence = make_state({{5, 7}, {6, 7}, {7, 7}}, {{0, 0}, {14, 0}});
+  ttt::my_player::SearchOpts opts;
+  opts.time_ms = 20;
+  ttt::my_player::SearchPlayer search("SearchPlayer", opts);
+  search.set_sign(Sign::O);
+  const Point move = search.make_move(defence);
+  std::cout << "defence: (" << move.x << ", " << move.y << ")\n";
+  assert(move.y == 7 && (move.x == 4 || move.x == 8));
+  return 0;
+}